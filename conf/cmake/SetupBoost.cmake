@@ -22,6 +22,14 @@ IF (Boost_FOUND)
                   ${Boost_INCLUDE_DIRS}
                   ${Boost_INCLUDE_DIRS}/lib
                   )
+     FIND_LIBRARY(BOOST_THREAD_LIB NAMES
+                  boost_thread
+                  libboost_thread-vc80-mt-gd-1_33_1
+                  libboost_thread-vc80-mt-gd-1_34_1
+                  PATHS
+                  ${Boost_INCLUDE_DIRS}
+                  ${Boost_INCLUDE_DIRS}/lib
+                  )
 
    # Release mode libraries
    ELSE(CMAKE_BUILD_TYPE MATCHES debug)
@@ -41,11 +49,19 @@ IF (Boost_FOUND)
                   ${Boost_INCLUDE_DIRS}
                   ${Boost_INCLUDE_DIRS}/lib
                   )
+     FIND_LIBRARY(BOOST_THREAD_LIB NAMES
+                  boost_thread
+                  libboost_thread-vc80-mt-1_33_1
+                  libboost_thread-vc80-mt-1_34_1
+                  PATHS
+                  ${Boost_INCLUDE_DIRS}
+                  ${Boost_INCLUDE_DIRS}/lib
+                  )
    ENDIF(CMAKE_BUILD_TYPE MATCHES debug)
 
-   IF(NOT BOOST_FILESYSTEM_LIB OR NOT BOOST_SERIALIZATION_LIB)
+   IF(NOT BOOST_FILESYSTEM_LIB OR NOT BOOST_SERIALIZATION_LIB OR NOT BOOST_THREAD_LIB)
       SET(Boost_FOUND 0)
-   ENDIF(NOT BOOST_FILESYSTEM_LIB OR NOT BOOST_SERIALIZATION_LIB)
+   ENDIF(NOT BOOST_FILESYSTEM_LIB OR NOT BOOST_SERIALIZATION_LIB OR NOT BOOST_THREAD_LIB)
 
 ENDIF (Boost_FOUND)
 
@@ -17,3 +17,8 @@ ENDIF(NOT DEFINED OE_DEBUG_GL)
 IF(NOT DEFINED OE_SAFE)
   SET(OE_SAFE true)
 ENDIF(NOT DEFINED OE_SAFE)
+
+# OE_LOG_LEVEL defaults to "0" (all log messages are compiled in)
+IF(NOT DEFINED OE_LOG_LEVEL)
+  SET(OE_LOG_LEVEL 0)
+ENDIF(NOT DEFINED OE_LOG_LEVEL)
@@ -2,4 +2,5 @@ IF(CMAKE_COMPILER_IS_GNUCXX)
   SET (CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -O3 -Wall -Wextra -Wno-unused-parameter")
   SET (CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DOE_SAFE=${OE_SAFE}")
   SET (CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DOE_DEBUG_GL=${OE_DEBUG_GL}")
+  SET (CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} -DOE_LOG_LEVEL=${OE_LOG_LEVEL}")
 ENDIF(CMAKE_COMPILER_IS_GNUCXX)
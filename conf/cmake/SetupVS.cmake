@@ -28,4 +28,6 @@ IF(CMAKE_BUILD_TOOL MATCHES "(msdev|devenv|nmake)")
   SET (CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} /DOE_DEBUG_GL=0")
   ENDIF(OE_DEBUG_GL)
 
+  SET (CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} /DOE_LOG_LEVEL=${OE_LOG_LEVEL}")
+
 ENDIF(CMAKE_BUILD_TOOL MATCHES "(msdev|devenv|nmake)")    
@@ -10,20 +10,32 @@
 #include <Core/Engine.h>
 #include <Logging/Logger.h>
 #include <Utils/Timer.h>
+#include <Utils/VirtualClock.h>
 
 namespace OpenEngine {
 namespace Core {
 
 using OpenEngine::Utils::Time;
 using OpenEngine::Utils::Timer;
+using OpenEngine::Utils::IClock;
+using OpenEngine::Utils::VirtualClock;
 
 /**
  * Engine constructor.
  */
-Engine::Engine() : running(false) {
+Engine::Engine()
+    : running(false), frameLimit(0), frameTime(0), frames(0) {
 
 }
 
+// restores the timer clock however the loop is left
+class ClockGuard {
+    IClock* clock;
+public:
+    ClockGuard() : clock(Timer::GetClock()) {}
+    ~ClockGuard() { Timer::SetClock(clock); }
+};
+
 /**
  * Main engine loop.
  */
@@ -37,11 +49,21 @@ void Engine::StartMainLoop() {
     // we initialize the approximate frame time to 50 milliseconds
     for (unsigned int i=0; i<count; i++) loops[i] = 50;
 
+    // with a fixed frame time all timers run on a virtual clock
+    // starting at the given start time
+    ClockGuard guard;
+    VirtualClock virtualClock(startTime, Time(frameTime));
+    if (frameTime > 0) {
+        Timer::SetClock(&virtualClock);
+        for (unsigned int i=0; i<count; i++) loops[i] = frameTime;
+    }
+
     // set the initial time
     time = Timer::GetTime();
 
     // run the engine loop
     while (running) {
+        if (frameLimit > 0 && frames >= frameLimit) break;
 
         // calculate the approximate frame time
         // Note: we assume that the sum of the loops do not overflow
@@ -53,6 +75,8 @@ void Engine::StartMainLoop() {
 
         // process listeners
         process.Notify(ProcessEventArg(time, approx));
+        frames++;
+        if (frameTime > 0) virtualClock.Advance();
 
         // save frame time to perform the next approximation
         _time = Timer::GetTime();
@@ -69,10 +93,11 @@ void Engine::StartMainLoop() {
  */
 void Engine::Start() {
     if (running) {
-        logger.warning << "Ignoring start request - engine already running." << logger.end;
+        OE_LOG_WARNING << "Ignoring start request - engine already running." << logger.end;
         return;
     }
     running = true;
+    frames = 0;
     initialize.Notify(InitializeEventArg());
     StartMainLoop();
     deinitialize.Notify(DeinitializeEventArg());
@@ -106,5 +131,38 @@ IEvent<DeinitializeEventArg>& Engine::DeinitializeEvent() {
     return deinitialize;
 }
 
+/**
+ * Stop the engine after a number of frames.
+ * Must be set before the engine is started.
+ *
+ * @param frames Number of frames to run, 0 to run until stopped.
+ */
+void Engine::SetFrameLimit(unsigned int frames) {
+    frameLimit = frames;
+}
+
+/**
+ * Run the engine on a fixed frame time.
+ * Every frame advances the engine clock (see \a Timer::SetClock) by
+ * exactly \a usec microseconds, independent of how long the frame
+ * took. Must be set before the engine is started.
+ *
+ * @param usec Frame time in microseconds, 0 to run in real time.
+ * @param start Engine clock time of the first frame.
+ */
+void Engine::SetFixedFrameTime(unsigned int usec, Time start) {
+    frameTime = usec;
+    startTime = start;
+}
+
+/**
+ * Get the number of frames run since the engine was started.
+ *
+ * @return Frame count.
+ */
+unsigned int Engine::GetFrameCount() const {
+    return frames;
+}
+
 } // NS Core
 } // NS OpenEngine
@@ -13,13 +13,37 @@
 #include <Core/IEngine.h>
 #include <Core/IEvent.h>
 #include <Core/Event.h>
+#include <Utils/Timer.h>
 
 namespace OpenEngine {
 namespace Core {
 
+/**
+ * Engine implementation.
+ * Runs the engine loop in real time by default. For simulation and
+ * benchmark runs the engine can be set to a fixed frame time, where
+ * the engine clock is a \a VirtualClock advanced by the frame time
+ * each frame, and to stop after a number of frames:
+ * @code
+ * Engine engine;
+ * engine.SetFixedFrameTime(16666); // 60 Hz of simulated time from zero
+ * engine.SetFrameLimit(10000);     // stop after 10000 frames
+ * engine.Start();                  // returns as soon as they are done
+ * @endcode
+ * Without a display attached this runs headless as fast as the
+ * machine allows, and every timer sees the same times on each run,
+ * as the virtual clock starts at a given time rather than the
+ * current one.
+ *
+ * @class Engine Engine.h Core/Engine.h
+ */
 class Engine : public IEngine {
 private:
     bool running;
+    unsigned int frameLimit;    //!< frames to run, 0 for no limit
+    unsigned int frameTime;     //!< fixed frame time, 0 for real time
+    Utils::Time startTime;      //!< virtual clock start with a fixed frame time
+    unsigned int frames;        //!< frames run since start
     Event<InitializeEventArg>   initialize;
     Event<ProcessEventArg>      process;
     Event<DeinitializeEventArg> deinitialize;
@@ -31,6 +55,11 @@ public:
     virtual IEvent<InitializeEventArg>&   InitializeEvent();
     virtual IEvent<ProcessEventArg>&      ProcessEvent();
     virtual IEvent<DeinitializeEventArg>& DeinitializeEvent();
+
+    void SetFrameLimit(unsigned int frames);
+    void SetFixedFrameTime(unsigned int usec,
+                           Utils::Time start = Utils::Time());
+    unsigned int GetFrameCount() const;
 };
 
 } // NS Core
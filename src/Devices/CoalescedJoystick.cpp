@@ -0,0 +1,129 @@
+// Coalescing joystick filter.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Devices/CoalescedJoystick.h>
+
+namespace OpenEngine {
+namespace Devices {
+
+/**
+ * Create a coalescing filter on a joystick.
+ *
+ * @param joystick Joystick to filter.
+ * @param deadzone Axis values with a smaller magnitude are sent as zero.
+ */
+CoalescedJoystick::CoalescedJoystick(IJoystick* joystick, int deadzone)
+    : joystick(joystick), deadzone(deadzone) {
+    for (int i=0; i<AXES; i++) {
+        state.axisState[i] = 0;
+        sent[i] = 0;
+        dirty[i] = false;
+    }
+    joystick->JoystickAxisEvent().Attach(*this);
+    joystick->JoystickButtonEvent().Attach(*this);
+}
+
+/**
+ * Detach from the joystick.
+ */
+CoalescedJoystick::~CoalescedJoystick() {
+    joystick->JoystickAxisEvent().Detach(*this);
+    joystick->JoystickButtonEvent().Detach(*this);
+}
+
+/**
+ * Joystick button event list.
+ */
+IEvent<JoystickButtonEventArg>& CoalescedJoystick::JoystickButtonEvent() {
+    return buttonEvent;
+}
+
+/**
+ * Coalesced axis event list.
+ * At most one event is sent per axis per frame (and per button event).
+ */
+IEvent<JoystickAxisEventArg>& CoalescedJoystick::JoystickAxisEvent() {
+    return axisEvent;
+}
+
+/**
+ * Unfiltered axis event list of the wrapped joystick.
+ */
+IEvent<JoystickAxisEventArg>& CoalescedJoystick::RawJoystickAxisEvent() {
+    return joystick->JoystickAxisEvent();
+}
+
+/**
+ * Set the deadzone.
+ *
+ * @param deadzone Axis values with a smaller magnitude are sent as zero.
+ */
+void CoalescedJoystick::SetDeadzone(int deadzone) {
+    this->deadzone = deadzone;
+}
+
+/**
+ * Get the deadzone.
+ *
+ * @return Deadzone.
+ */
+int CoalescedJoystick::GetDeadzone() {
+    return deadzone;
+}
+
+/**
+ * Send the axes changed since the last flush.
+ */
+void CoalescedJoystick::Flush() {
+    for (int i=0; i<AXES; i++) {
+        if (!dirty[i]) continue;
+        dirty[i] = false;
+        if (state.axisState[i] == sent[i]) continue;
+        sent[i] = state.axisState[i];
+        JoystickAxisEventArg arg;
+        arg.state = state;
+        arg.axis  = i;
+        arg.value = state.axisState[i];
+        axisEvent.Notify(arg);
+    }
+}
+
+void CoalescedJoystick::Handle(InitializeEventArg arg) {}
+
+void CoalescedJoystick::Handle(ProcessEventArg arg) {
+    Flush();
+}
+
+void CoalescedJoystick::Handle(DeinitializeEventArg arg) {}
+
+void CoalescedJoystick::Handle(JoystickAxisEventArg arg) {
+    state.buttons = arg.state.buttons;
+    if (arg.axis >= 0 && arg.axis < AXES) {
+        state.axisState[arg.axis] = Filter(arg.value);
+        dirty[arg.axis] = true;
+    }
+}
+
+void CoalescedJoystick::Handle(JoystickButtonEventArg arg) {
+    Flush();
+    for (int i=0; i<AXES; i++)
+        arg.state.axisState[i] = state.axisState[i];
+    buttonEvent.Notify(arg);
+}
+
+/**
+ * Apply the deadzone to an axis value.
+ */
+int CoalescedJoystick::Filter(int value) {
+    if (value < deadzone && value > -deadzone) return 0;
+    return value;
+}
+
+} // NS Devices
+} // NS OpenEngine
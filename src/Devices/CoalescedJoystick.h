@@ -0,0 +1,85 @@
+// Coalescing joystick filter.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_COALESCED_JOYSTICK_H_
+#define _OE_COALESCED_JOYSTICK_H_
+
+#include <Devices/IJoystick.h>
+#include <Core/Event.h>
+
+namespace OpenEngine {
+namespace Devices {
+
+using OpenEngine::Core::IListener;
+using OpenEngine::Core::IEvent;
+using OpenEngine::Core::Event;
+using OpenEngine::Core::InitializeEventArg;
+using OpenEngine::Core::ProcessEventArg;
+using OpenEngine::Core::DeinitializeEventArg;
+
+/**
+ * Coalescing joystick filter.
+ * Wraps a joystick and sends at most one axis event per axis per
+ * frame, holding the latest value of the axis. Values within the
+ * deadzone are sent as zero, and an axis whose value did not change
+ * since its last event is not sent again, so a resting stick sends
+ * nothing.
+ *
+ * @code
+ * CoalescedJoystick* cjoy = new CoalescedJoystick(joystick, 2000);
+ * engine.ProcessEvent().Attach(*joystick);
+ * engine.ProcessEvent().Attach(*cjoy); // after the joystick
+ * cjoy->JoystickAxisEvent().Attach(vehicle);
+ * @endcode
+ *
+ * Pending axes are sent on each process event and before any button
+ * event. Button events are passed on unchanged. The unfiltered axis
+ * events are available from RawJoystickAxisEvent.
+ *
+ * @class CoalescedJoystick CoalescedJoystick.h Devices/CoalescedJoystick.h
+ */
+class CoalescedJoystick : public IJoystick
+                        , public IListener<JoystickAxisEventArg>
+                        , public IListener<JoystickButtonEventArg> {
+public:
+    static const int AXES = sizeof(((JoystickState*)0)->axisState) / sizeof(int);
+
+    CoalescedJoystick(IJoystick* joystick, int deadzone = 0);
+    virtual ~CoalescedJoystick();
+
+    IEvent<JoystickButtonEventArg>& JoystickButtonEvent();
+    IEvent<JoystickAxisEventArg>& JoystickAxisEvent();
+    IEvent<JoystickAxisEventArg>& RawJoystickAxisEvent();
+
+    void SetDeadzone(int deadzone);
+    int GetDeadzone();
+    void Flush();
+
+    void Handle(InitializeEventArg arg);
+    void Handle(ProcessEventArg arg);
+    void Handle(DeinitializeEventArg arg);
+    void Handle(JoystickAxisEventArg arg);
+    void Handle(JoystickButtonEventArg arg);
+
+private:
+    IJoystick* joystick;
+    Event<JoystickAxisEventArg> axisEvent;
+    Event<JoystickButtonEventArg> buttonEvent;
+    int deadzone;
+    JoystickState state;        //!< latest state with the deadzone applied
+    int sent[AXES];             //!< last value sent per axis
+    bool dirty[AXES];           //!< axis received since the last flush
+
+    int Filter(int value);
+};
+
+} // NS Devices
+} // NS OpenEngine
+
+#endif // _OE_COALESCED_JOYSTICK_H_
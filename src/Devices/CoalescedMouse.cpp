@@ -0,0 +1,106 @@
+// Coalescing mouse filter.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Devices/CoalescedMouse.h>
+
+namespace OpenEngine {
+namespace Devices {
+
+/**
+ * Create a coalescing filter on a mouse.
+ *
+ * @param mouse Mouse to filter.
+ */
+CoalescedMouse::CoalescedMouse(IMouse* mouse)
+    : mouse(mouse), moved(false) {
+    mouse->MouseMovedEvent().Attach(*this);
+    mouse->MouseButtonEvent().Attach(*this);
+}
+
+/**
+ * Detach from the mouse.
+ */
+CoalescedMouse::~CoalescedMouse() {
+    mouse->MouseMovedEvent().Detach(*this);
+    mouse->MouseButtonEvent().Detach(*this);
+}
+
+/**
+ * Mouse button event list.
+ */
+IEvent<MouseButtonEventArg>& CoalescedMouse::MouseButtonEvent() {
+    return buttonEvent;
+}
+
+/**
+ * Coalesced mouse movement event list.
+ * At most one event is sent per frame (and per button event).
+ */
+IEvent<MouseMovedEventArg>& CoalescedMouse::MouseMovedEvent() {
+    return movedEvent;
+}
+
+/**
+ * Unfiltered mouse movement event list of the wrapped mouse.
+ */
+IEvent<MouseMovedEventArg>& CoalescedMouse::RawMouseMovedEvent() {
+    return mouse->MouseMovedEvent();
+}
+
+void CoalescedMouse::HideCursor() {
+    mouse->HideCursor();
+}
+
+void CoalescedMouse::ShowCursor() {
+    mouse->ShowCursor();
+}
+
+void CoalescedMouse::SetCursor(int x, int y) {
+    mouse->SetCursor(x, y);
+}
+
+MouseState CoalescedMouse::GetState() {
+    return mouse->GetState();
+}
+
+/**
+ * Send the pending movement, if any.
+ */
+void CoalescedMouse::Flush() {
+    if (!moved) return;
+    MouseMovedEventArg arg = pending;
+    moved = false;
+    pending.dx = pending.dy = 0;
+    movedEvent.Notify(arg);
+}
+
+void CoalescedMouse::Handle(InitializeEventArg arg) {}
+
+void CoalescedMouse::Handle(ProcessEventArg arg) {
+    Flush();
+}
+
+void CoalescedMouse::Handle(DeinitializeEventArg arg) {}
+
+void CoalescedMouse::Handle(MouseMovedEventArg arg) {
+    pending.x = arg.x;
+    pending.y = arg.y;
+    pending.buttons = arg.buttons;
+    pending.dx += arg.dx;
+    pending.dy += arg.dy;
+    moved = true;
+}
+
+void CoalescedMouse::Handle(MouseButtonEventArg arg) {
+    Flush();
+    buttonEvent.Notify(arg);
+}
+
+} // NS Devices
+} // NS OpenEngine
@@ -0,0 +1,84 @@
+// Coalescing mouse filter.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_COALESCED_MOUSE_H_
+#define _OE_COALESCED_MOUSE_H_
+
+#include <Devices/IMouse.h>
+#include <Core/Event.h>
+
+namespace OpenEngine {
+namespace Devices {
+
+using OpenEngine::Core::IListener;
+using OpenEngine::Core::Event;
+using OpenEngine::Core::InitializeEventArg;
+using OpenEngine::Core::ProcessEventArg;
+using OpenEngine::Core::DeinitializeEventArg;
+
+/**
+ * Coalescing mouse filter.
+ * Wraps a mouse and sends at most one mouse moved event per frame:
+ * the relative movements are summed and the absolute position and
+ * buttons are the latest received. High polling rate mice can send
+ * many moved events per frame, and each would otherwise be sent to
+ * every listener.
+ *
+ * @code
+ * CoalescedMouse* cmouse = new CoalescedMouse(mouse);
+ * // the filter must process after the mouse
+ * engine.ProcessEvent().Attach(*mouse);
+ * engine.ProcessEvent().Attach(*cmouse);
+ * cmouse->MouseMovedEvent().Attach(camera);        // once per frame
+ * cmouse->RawMouseMovedEvent().Attach(recorder);   // every event
+ * @endcode
+ *
+ * The pending movement is sent on each process event and before any
+ * button event, so listeners see moves and clicks in order. Button
+ * events are passed on unchanged. All other calls are forwarded to
+ * the wrapped mouse.
+ *
+ * @class CoalescedMouse CoalescedMouse.h Devices/CoalescedMouse.h
+ */
+class CoalescedMouse : public IMouse
+                     , public IListener<MouseMovedEventArg>
+                     , public IListener<MouseButtonEventArg> {
+public:
+    CoalescedMouse(IMouse* mouse);
+    virtual ~CoalescedMouse();
+
+    IEvent<MouseButtonEventArg>& MouseButtonEvent();
+    IEvent<MouseMovedEventArg>& MouseMovedEvent();
+    IEvent<MouseMovedEventArg>& RawMouseMovedEvent();
+
+    void HideCursor();
+    void ShowCursor();
+    void SetCursor(int x, int y);
+    MouseState GetState();
+
+    void Flush();
+
+    void Handle(InitializeEventArg arg);
+    void Handle(ProcessEventArg arg);
+    void Handle(DeinitializeEventArg arg);
+    void Handle(MouseMovedEventArg arg);
+    void Handle(MouseButtonEventArg arg);
+
+private:
+    IMouse* mouse;
+    Event<MouseMovedEventArg> movedEvent;
+    Event<MouseButtonEventArg> buttonEvent;
+    MouseMovedEventArg pending;         //!< coalesced movement
+    bool moved;                         //!< pending holds a movement
+};
+
+} // NS Devices
+} // NS OpenEngine
+
+#endif // _OE_COALESCED_MOUSE_H_
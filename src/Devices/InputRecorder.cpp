@@ -0,0 +1,175 @@
+// Input recorder.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Devices/InputRecorder.h>
+
+namespace OpenEngine {
+namespace Devices {
+
+using OpenEngine::Utils::Timer;
+using boost::int32_t;
+using boost::uint8_t;
+using boost::uint16_t;
+using boost::uint32_t;
+using boost::uint64_t;
+
+const char InputRecorder::MAGIC[4] = {'O', 'E', 'I', 'R'};
+const uint32_t InputRecorder::VERSION;
+
+/**
+ * Create a recorder and attach it to the devices.
+ *
+ * @param stream Binary stream to record to (ownership is transferred).
+ * @param keyboard Keyboard or NULL.
+ * @param mouse Mouse or NULL.
+ * @param joystick Joystick or NULL.
+ */
+InputRecorder::InputRecorder(ostream* stream, IKeyboard* keyboard,
+                             IMouse* mouse, IJoystick* joystick)
+    : stream(stream), keyboard(keyboard), mouse(mouse), joystick(joystick)
+    , started(false), ended(false), frame(0), events(0) {
+    stream->write(MAGIC, sizeof(MAGIC));
+    Put<uint32_t>(VERSION);
+    if (keyboard) keyboard->KeyEvent().Attach(*this);
+    if (mouse) {
+        mouse->MouseMovedEvent().Attach(*this);
+        mouse->MouseButtonEvent().Attach(*this);
+    }
+    if (joystick) {
+        joystick->JoystickAxisEvent().Attach(*this);
+        joystick->JoystickButtonEvent().Attach(*this);
+    }
+}
+
+/**
+ * Detach from the devices and delete the stream.
+ */
+InputRecorder::~InputRecorder() {
+    if (keyboard) keyboard->KeyEvent().Detach(*this);
+    if (mouse) {
+        mouse->MouseMovedEvent().Detach(*this);
+        mouse->MouseButtonEvent().Detach(*this);
+    }
+    if (joystick) {
+        joystick->JoystickAxisEvent().Detach(*this);
+        joystick->JoystickButtonEvent().Detach(*this);
+    }
+    if (!ended) Handle(DeinitializeEventArg());
+    delete stream;
+}
+
+/**
+ * Get the number of the frame being recorded.
+ *
+ * @return Frame number, starting from zero.
+ */
+unsigned int InputRecorder::GetFrame() const {
+    return frame;
+}
+
+/**
+ * Get the number of events recorded.
+ *
+ * @return Event count.
+ */
+unsigned int InputRecorder::GetEventCount() const {
+    return events;
+}
+
+void InputRecorder::Handle(InitializeEventArg arg) {}
+
+/**
+ * End the current frame.
+ */
+void InputRecorder::Handle(ProcessEventArg arg) {
+    if (!started) {
+        start = Timer::GetTime();
+        started = true;
+    }
+    frame++;
+}
+
+/**
+ * End the recording.
+ * The frame count is written so a replay knows when it is done.
+ */
+void InputRecorder::Handle(DeinitializeEventArg arg) {
+    if (ended) return;
+    Begin(EVENT_END);
+    ended = true;
+    stream->flush();
+}
+
+void InputRecorder::Handle(KeyboardEventArg arg) {
+    if (!Begin(EVENT_KEY)) return;
+    Put<uint8_t>(arg.type);
+    Put<uint16_t>(arg.sym);
+    Put<uint16_t>(arg.mod);
+}
+
+void InputRecorder::Handle(MouseMovedEventArg arg) {
+    if (!Begin(EVENT_MOUSE_MOVED)) return;
+    Put<uint32_t>(arg.x);
+    Put<uint32_t>(arg.y);
+    Put<int32_t>(arg.dx);
+    Put<int32_t>(arg.dy);
+    Put<uint32_t>(arg.buttons);
+}
+
+void InputRecorder::Handle(MouseButtonEventArg arg) {
+    if (!Begin(EVENT_MOUSE_BUTTON)) return;
+    Put<uint8_t>(arg.type);
+    Put<uint32_t>(arg.button);
+    Put<int32_t>(arg.state.x);
+    Put<int32_t>(arg.state.y);
+    Put<uint32_t>(arg.state.buttons);
+}
+
+void InputRecorder::Handle(JoystickAxisEventArg arg) {
+    if (!Begin(EVENT_JOY_AXIS)) return;
+    Put<int32_t>(arg.axis);
+    Put<int32_t>(arg.value);
+    Put<uint32_t>(arg.state.buttons);
+}
+
+void InputRecorder::Handle(JoystickButtonEventArg arg) {
+    if (!Begin(EVENT_JOY_BUTTON)) return;
+    Put<uint8_t>(arg.type);
+    Put<uint32_t>(arg.button);
+    Put<uint32_t>(arg.state.buttons);
+}
+
+/**
+ * Write the common event header: kind, frame and time.
+ *
+ * @return False if the recording has ended.
+ */
+bool InputRecorder::Begin(EventKind kind) {
+    if (ended) return false;
+    if (!started) {
+        start = Timer::GetTime();
+        started = true;
+    }
+    Put<uint8_t>(kind);
+    Put<uint32_t>(frame);
+    Put<uint64_t>((Timer::GetTime() - start).AsInt64());
+    if (kind != EVENT_END) events++;
+    return true;
+}
+
+/**
+ * Write a value in native byte order.
+ */
+template <class T>
+void InputRecorder::Put(T value) {
+    stream->write((const char*)&value, sizeof(T));
+}
+
+} // NS Devices
+} // NS OpenEngine
@@ -0,0 +1,112 @@
+// Input recorder.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_INPUT_RECORDER_H_
+#define _OE_INPUT_RECORDER_H_
+
+#include <Devices/IKeyboard.h>
+#include <Devices/IMouse.h>
+#include <Devices/IJoystick.h>
+#include <Utils/Timer.h>
+
+#include <ostream>
+#include <boost/cstdint.hpp>
+
+namespace OpenEngine {
+namespace Devices {
+
+using std::ostream;
+using OpenEngine::Core::IListener;
+using OpenEngine::Core::InitializeEventArg;
+using OpenEngine::Core::ProcessEventArg;
+using OpenEngine::Core::DeinitializeEventArg;
+using OpenEngine::Utils::Time;
+
+/**
+ * Input recorder.
+ * Records the keyboard, mouse and joystick events into a compact
+ * binary stream that InputReplay plays back. Each event is stored
+ * with the number of the frame it was received in and the time since
+ * the recording started, so a replay sends the same events in the
+ * same frames.
+ *
+ * @code
+ * InputRecorder* rec = new InputRecorder(new ofstream("session.oeir", ios::binary),
+ *                                        keyboard, mouse, joystick);
+ * engine.ProcessEvent().Attach(*keyboard);
+ * engine.ProcessEvent().Attach(*mouse);
+ * engine.ProcessEvent().Attach(*rec);   // ends the frame, after the devices
+ * engine.DeinitializeEvent().Attach(*rec);
+ * @endcode
+ *
+ * The recorder takes ownership of the stream, which is flushed on
+ * deinitialization and deleted with the recorder. Recordings are
+ * written in the byte order of the recording machine.
+ *
+ * @class InputRecorder InputRecorder.h Devices/InputRecorder.h
+ */
+class InputRecorder : public virtual Core::IModule
+                    , public IListener<KeyboardEventArg>
+                    , public IListener<MouseMovedEventArg>
+                    , public IListener<MouseButtonEventArg>
+                    , public IListener<JoystickAxisEventArg>
+                    , public IListener<JoystickButtonEventArg> {
+public:
+
+    /**
+     * Recorded event kinds.
+     */
+    enum EventKind {
+        EVENT_KEY          = 1,
+        EVENT_MOUSE_MOVED  = 2,
+        EVENT_MOUSE_BUTTON = 3,
+        EVENT_JOY_AXIS     = 4,
+        EVENT_JOY_BUTTON   = 5,
+        EVENT_END          = 6  //!< end of the recording
+    };
+
+    static const char MAGIC[4];         //!< file signature
+    static const boost::uint32_t VERSION = 1;
+
+    InputRecorder(ostream* stream, IKeyboard* keyboard, IMouse* mouse,
+                  IJoystick* joystick = NULL);
+    virtual ~InputRecorder();
+
+    unsigned int GetFrame() const;
+    unsigned int GetEventCount() const;
+
+    void Handle(InitializeEventArg arg);
+    void Handle(ProcessEventArg arg);
+    void Handle(DeinitializeEventArg arg);
+
+    void Handle(KeyboardEventArg arg);
+    void Handle(MouseMovedEventArg arg);
+    void Handle(MouseButtonEventArg arg);
+    void Handle(JoystickAxisEventArg arg);
+    void Handle(JoystickButtonEventArg arg);
+
+private:
+    ostream* stream;
+    IKeyboard* keyboard;
+    IMouse* mouse;
+    IJoystick* joystick;
+    Time start;                 //!< time of the first event or frame
+    bool started;
+    bool ended;
+    unsigned int frame;
+    unsigned int events;
+
+    bool Begin(EventKind kind);
+    template <class T> void Put(T value);
+};
+
+} // NS Devices
+} // NS OpenEngine
+
+#endif // _OE_INPUT_RECORDER_H_
@@ -0,0 +1,241 @@
+// Input replay device.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Devices/InputReplay.h>
+#include <Devices/InputRecorder.h>
+
+#include <cstring>
+
+namespace OpenEngine {
+namespace Devices {
+
+using boost::int32_t;
+using boost::uint8_t;
+using boost::uint16_t;
+using boost::uint32_t;
+using boost::uint64_t;
+
+/**
+ * Create a replay of a recording.
+ * The header is read and checked immediately.
+ *
+ * @param stream Binary stream holding the recording (ownership is
+ * transferred).
+ */
+InputReplay::InputReplay(istream* stream)
+    : stream(stream), valid(false), done(true), frame(0), frames(0)
+    , nextKind(0), nextFrame(0) {
+    for (unsigned int i=0; i<sizeof(joystickState.axisState)/sizeof(int); i++)
+        joystickState.axisState[i] = 0;
+    char magic[4];
+    stream->read(magic, sizeof(magic));
+    uint32_t version = Get<uint32_t>();
+    if (!stream->good() ||
+        memcmp(magic, InputRecorder::MAGIC, sizeof(magic)) != 0 ||
+        version != InputRecorder::VERSION)
+        return;
+    valid = true;
+    done = !ReadHeader();
+}
+
+/**
+ * Delete the stream.
+ */
+InputReplay::~InputReplay() {
+    delete stream;
+}
+
+/**
+ * Check that the stream holds a recording.
+ *
+ * @return True if the header is valid.
+ */
+bool InputReplay::IsValid() const {
+    return valid;
+}
+
+/**
+ * Check if all recorded frames have been replayed.
+ *
+ * @return True when the replay is done.
+ */
+bool InputReplay::IsDone() const {
+    return done;
+}
+
+/**
+ * Get the number of the next frame to replay.
+ *
+ * @return Frame number.
+ */
+unsigned int InputReplay::GetFrame() const {
+    return frame;
+}
+
+/**
+ * Get the number of recorded frames.
+ * Only known once the end of the recording is reached.
+ *
+ * @return Frame count or zero if not yet known.
+ */
+unsigned int InputReplay::GetFrameCount() const {
+    return frames;
+}
+
+IEvent<KeyboardEventArg>& InputReplay::KeyEvent() {
+    return keyEvent;
+}
+
+IEvent<MouseButtonEventArg>& InputReplay::MouseButtonEvent() {
+    return mouseButtonEvent;
+}
+
+IEvent<MouseMovedEventArg>& InputReplay::MouseMovedEvent() {
+    return mouseMovedEvent;
+}
+
+void InputReplay::HideCursor() {}
+
+void InputReplay::ShowCursor() {}
+
+void InputReplay::SetCursor(int x, int y) {
+    mouseState.x = x;
+    mouseState.y = y;
+}
+
+MouseState InputReplay::GetState() {
+    return mouseState;
+}
+
+IEvent<JoystickButtonEventArg>& InputReplay::JoystickButtonEvent() {
+    return joystickButtonEvent;
+}
+
+IEvent<JoystickAxisEventArg>& InputReplay::JoystickAxisEvent() {
+    return joystickAxisEvent;
+}
+
+void InputReplay::Handle(InitializeEventArg arg) {}
+
+/**
+ * Send the events recorded in the current frame.
+ */
+void InputReplay::Handle(ProcessEventArg arg) {
+    if (done) return;
+    while (nextKind != InputRecorder::EVENT_END && nextFrame <= frame) {
+        if (!SendNext() || !ReadHeader()) {
+            done = true;
+            return;
+        }
+    }
+    frame++;
+    if (nextKind == InputRecorder::EVENT_END && frame >= nextFrame)
+        done = true;
+}
+
+void InputReplay::Handle(DeinitializeEventArg arg) {}
+
+/**
+ * Read the header of the next event.
+ *
+ * @return False if the stream ended.
+ */
+bool InputReplay::ReadHeader() {
+    nextKind  = Get<uint8_t>();
+    nextFrame = Get<uint32_t>();
+    // replay is by frame, the recorded time is only for inspection
+    Get<uint64_t>();
+    if (!stream->good()) return false;
+    if (nextKind == InputRecorder::EVENT_END) frames = nextFrame;
+    return true;
+}
+
+/**
+ * Read the body of the next event and send it.
+ *
+ * @return False if the stream ended or the event is unknown.
+ */
+bool InputReplay::SendNext() {
+    switch (nextKind) {
+    case InputRecorder::EVENT_KEY: {
+        KeyboardEventArg e;
+        e.type = (ButtonEvent)Get<uint8_t>();
+        e.sym  = (Key)Get<uint16_t>();
+        e.mod  = (KeyMod)Get<uint16_t>();
+        if (!stream->good()) return false;
+        keyEvent.Notify(e);
+        break;
+    }
+    case InputRecorder::EVENT_MOUSE_MOVED: {
+        MouseMovedEventArg e;
+        e.x  = Get<uint32_t>();
+        e.y  = Get<uint32_t>();
+        e.dx = Get<int32_t>();
+        e.dy = Get<int32_t>();
+        e.buttons = (MouseButton)Get<uint32_t>();
+        if (!stream->good()) return false;
+        mouseState.x = e.x;
+        mouseState.y = e.y;
+        mouseState.buttons = e.buttons;
+        mouseMovedEvent.Notify(e);
+        break;
+    }
+    case InputRecorder::EVENT_MOUSE_BUTTON: {
+        MouseButtonEventArg e;
+        e.type    = (ButtonEvent)Get<uint8_t>();
+        e.button  = (MouseButton)Get<uint32_t>();
+        e.state.x = Get<int32_t>();
+        e.state.y = Get<int32_t>();
+        e.state.buttons = (MouseButton)Get<uint32_t>();
+        if (!stream->good()) return false;
+        mouseState = e.state;
+        mouseButtonEvent.Notify(e);
+        break;
+    }
+    case InputRecorder::EVENT_JOY_AXIS: {
+        JoystickAxisEventArg e;
+        e.axis  = Get<int32_t>();
+        e.value = Get<int32_t>();
+        joystickState.buttons = (JoystickButton)Get<uint32_t>();
+        if (!stream->good()) return false;
+        if (e.axis >= 0 &&
+            e.axis < (int)(sizeof(joystickState.axisState)/sizeof(int)))
+            joystickState.axisState[e.axis] = e.value;
+        e.state = joystickState;
+        joystickAxisEvent.Notify(e);
+        break;
+    }
+    case InputRecorder::EVENT_JOY_BUTTON: {
+        JoystickButtonEventArg e;
+        e.type   = (JoystickButtonEventArg::JButtonEventType)Get<uint8_t>();
+        e.button = (JoystickButton)Get<uint32_t>();
+        joystickState.buttons = (JoystickButton)Get<uint32_t>();
+        if (!stream->good()) return false;
+        e.state = joystickState;
+        joystickButtonEvent.Notify(e);
+        break;
+    }
+    default:
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Read a value in native byte order.
+ */
+template <class T>
+T InputReplay::Get() {
+    T value = 0;
+    stream->read((char*)&value, sizeof(T));
+    return value;
+}
+
+} // NS Devices
+} // NS OpenEngine
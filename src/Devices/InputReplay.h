@@ -0,0 +1,110 @@
+// Input replay device.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_INPUT_REPLAY_H_
+#define _OE_INPUT_REPLAY_H_
+
+#include <Devices/IKeyboard.h>
+#include <Devices/IMouse.h>
+#include <Devices/IJoystick.h>
+#include <Core/Event.h>
+
+#include <istream>
+#include <boost/cstdint.hpp>
+
+namespace OpenEngine {
+namespace Devices {
+
+using std::istream;
+using OpenEngine::Core::Event;
+using OpenEngine::Core::InitializeEventArg;
+using OpenEngine::Core::ProcessEventArg;
+using OpenEngine::Core::DeinitializeEventArg;
+
+/**
+ * Input replay device.
+ * Plays back a recording made by InputRecorder. The replay is a
+ * keyboard, a mouse and a joystick in one, and is used in place of
+ * the real devices. On each process event it sends the events
+ * recorded in the corresponding frame, so together with a fixed frame
+ * clock a run is repeated frame by frame.
+ *
+ * @code
+ * InputReplay* replay = new InputReplay(new ifstream("session.oeir", ios::binary));
+ * engine.ProcessEvent().Attach(*replay);  // where the devices were attached
+ * camera.Attach(*replay);                 // used as IKeyboard, IMouse, ...
+ * ...
+ * if (replay->IsDone()) engine.Stop();
+ * @endcode
+ *
+ * The replay takes ownership of the stream. Cursor calls only change
+ * the replayed mouse state.
+ *
+ * @class InputReplay InputReplay.h Devices/InputReplay.h
+ */
+class InputReplay : public IKeyboard
+                  , public IMouse
+                  , public IJoystick {
+public:
+    InputReplay(istream* stream);
+    virtual ~InputReplay();
+
+    bool IsValid() const;
+    bool IsDone() const;
+    unsigned int GetFrame() const;
+    unsigned int GetFrameCount() const;
+
+    // IKeyboard
+    IEvent<KeyboardEventArg>& KeyEvent();
+
+    // IMouse
+    IEvent<MouseButtonEventArg>& MouseButtonEvent();
+    IEvent<MouseMovedEventArg>& MouseMovedEvent();
+    void HideCursor();
+    void ShowCursor();
+    void SetCursor(int x, int y);
+    MouseState GetState();
+
+    // IJoystick
+    IEvent<JoystickButtonEventArg>& JoystickButtonEvent();
+    IEvent<JoystickAxisEventArg>& JoystickAxisEvent();
+
+    void Handle(InitializeEventArg arg);
+    void Handle(ProcessEventArg arg);
+    void Handle(DeinitializeEventArg arg);
+
+private:
+    istream* stream;
+    bool valid;
+    bool done;
+    unsigned int frame;         //!< next frame to replay
+    unsigned int frames;        //!< frames in the recording, once known
+
+    // header of the next event in the stream
+    boost::uint8_t nextKind;
+    boost::uint32_t nextFrame;
+
+    Event<KeyboardEventArg> keyEvent;
+    Event<MouseButtonEventArg> mouseButtonEvent;
+    Event<MouseMovedEventArg> mouseMovedEvent;
+    Event<JoystickButtonEventArg> joystickButtonEvent;
+    Event<JoystickAxisEventArg> joystickAxisEvent;
+
+    MouseState mouseState;
+    JoystickState joystickState;
+
+    bool ReadHeader();
+    bool SendNext();
+    template <class T> T Get();
+};
+
+} // NS Devices
+} // NS OpenEngine
+
+#endif // _OE_INPUT_REPLAY_H_
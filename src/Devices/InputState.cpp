@@ -0,0 +1,171 @@
+// Input state snapshot.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Devices/InputState.h>
+
+namespace OpenEngine {
+namespace Devices {
+
+/**
+ * Empty snapshot with all keys and buttons up and centered axes.
+ */
+InputSnapshot::InputSnapshot()
+    : mod(KEY_MOD_NONE), dx(0), dy(0), frame(0) {
+    for (unsigned int i=0; i<sizeof(joystick.axisState)/sizeof(int); i++)
+        joystick.axisState[i] = 0;
+}
+
+/**
+ * Create an input state module and attach it to the devices.
+ *
+ * @param keyboard Keyboard or NULL.
+ * @param mouse Mouse or NULL.
+ * @param joystick Joystick or NULL.
+ */
+InputState::InputState(IKeyboard* keyboard, IMouse* mouse, IJoystick* joystick)
+    : keyboard(keyboard), mouse(mouse), joystick(joystick), current(0) {
+    sequence[0] = sequence[1] = 0;
+    if (keyboard) keyboard->KeyEvent().Attach(*this);
+    if (mouse) {
+        mouse->MouseMovedEvent().Attach(*this);
+        mouse->MouseButtonEvent().Attach(*this);
+    }
+    if (joystick) {
+        joystick->JoystickAxisEvent().Attach(*this);
+        joystick->JoystickButtonEvent().Attach(*this);
+    }
+}
+
+/**
+ * Detach from the devices.
+ */
+InputState::~InputState() {
+    if (keyboard) keyboard->KeyEvent().Detach(*this);
+    if (mouse) {
+        mouse->MouseMovedEvent().Detach(*this);
+        mouse->MouseButtonEvent().Detach(*this);
+    }
+    if (joystick) {
+        joystick->JoystickAxisEvent().Detach(*this);
+        joystick->JoystickButtonEvent().Detach(*this);
+    }
+}
+
+/**
+ * Get the latest published snapshot.
+ * Lock free and safe to call from any thread.
+ *
+ * @return Copy of the snapshot.
+ */
+InputSnapshot InputState::GetSnapshot() const {
+    InputSnapshot s;
+    GetSnapshot(s);
+    return s;
+}
+
+/**
+ * Copy the latest published snapshot.
+ * Lock free and safe to call from any thread.
+ *
+ * @param snapshot Snapshot to copy into.
+ */
+void InputState::GetSnapshot(InputSnapshot& snapshot) const {
+    for (;;) {
+        unsigned int i = current.load(boost::memory_order_acquire);
+        unsigned int seq = sequence[i].load(boost::memory_order_acquire);
+        if (seq & 1) continue; // being written, the swap is imminent
+        snapshot = buffers[i];
+        boost::atomic_thread_fence(boost::memory_order_acquire);
+        if (sequence[i].load(boost::memory_order_relaxed) == seq) return;
+    }
+}
+
+/**
+ * Get the number of the latest published frame.
+ * Lock free and safe to call from any thread.
+ *
+ * @return Frame number.
+ */
+unsigned int InputState::GetFrame() const {
+    // same sequence check as GetSnapshot, reading only the number
+    for (;;) {
+        unsigned int i = current.load(boost::memory_order_acquire);
+        unsigned int seq = sequence[i].load(boost::memory_order_acquire);
+        if (seq & 1) continue;
+        unsigned int frame = buffers[i].frame;
+        boost::atomic_thread_fence(boost::memory_order_acquire);
+        if (sequence[i].load(boost::memory_order_relaxed) == seq) return frame;
+    }
+}
+
+/**
+ * Publish the current state and start a new frame.
+ * Called on every process event, but may also be called directly.
+ * Must only be called from the thread handling the device events.
+ */
+void InputState::Publish() {
+    unsigned int next = 1 - current.load(boost::memory_order_relaxed);
+    sequence[next].fetch_add(1, boost::memory_order_relaxed);
+    boost::atomic_thread_fence(boost::memory_order_release);
+    buffers[next] = working;
+    sequence[next].fetch_add(1, boost::memory_order_release);
+    current.store(next, boost::memory_order_release);
+
+    // start the next frame with no movement or key transitions
+    working.frame++;
+    working.dx = working.dy = 0;
+    working.pressed.reset();
+    working.released.reset();
+}
+
+void InputState::Handle(InitializeEventArg arg) {}
+
+void InputState::Handle(ProcessEventArg arg) {
+    Publish();
+}
+
+void InputState::Handle(DeinitializeEventArg arg) {}
+
+void InputState::Handle(KeyboardEventArg arg) {
+    working.mod = arg.mod;
+    if (arg.sym >= KEY_LAST) return;
+    if (arg.type == EVENT_PRESS) {
+        working.keys.set(arg.sym);
+        working.pressed.set(arg.sym);
+    } else if (arg.type == EVENT_RELEASE) {
+        working.keys.reset(arg.sym);
+        working.released.set(arg.sym);
+    }
+}
+
+void InputState::Handle(MouseMovedEventArg arg) {
+    working.mouse.x = arg.x;
+    working.mouse.y = arg.y;
+    working.mouse.buttons = arg.buttons;
+    working.dx += arg.dx;
+    working.dy += arg.dy;
+}
+
+void InputState::Handle(MouseButtonEventArg arg) {
+    working.mouse = arg.state;
+}
+
+void InputState::Handle(JoystickAxisEventArg arg) {
+    working.joystick = arg.state;
+    if (arg.axis >= 0 &&
+        arg.axis < (int)(sizeof(working.joystick.axisState)/sizeof(int)))
+        working.joystick.axisState[arg.axis] = arg.value;
+}
+
+void InputState::Handle(JoystickButtonEventArg arg) {
+    working.joystick = arg.state;
+}
+
+} // NS Devices
+} // NS OpenEngine
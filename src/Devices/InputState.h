@@ -0,0 +1,153 @@
+// Input state snapshot.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_INPUT_STATE_H_
+#define _OE_INPUT_STATE_H_
+
+#include <Devices/IKeyboard.h>
+#include <Devices/IMouse.h>
+#include <Devices/IJoystick.h>
+
+#include <bitset>
+#include <boost/atomic.hpp>
+
+namespace OpenEngine {
+namespace Devices {
+
+using OpenEngine::Core::IListener;
+using OpenEngine::Core::InitializeEventArg;
+using OpenEngine::Core::ProcessEventArg;
+using OpenEngine::Core::DeinitializeEventArg;
+
+/**
+ * Input snapshot.
+ * The state of all input devices at the end of a frame.
+ *
+ * @struct InputSnapshot InputState.h Devices/InputState.h
+ */
+struct InputSnapshot {
+    std::bitset<KEY_LAST> keys;     //!< keys held down
+    std::bitset<KEY_LAST> pressed;  //!< keys pressed during the frame
+    std::bitset<KEY_LAST> released; //!< keys released during the frame
+    KeyMod mod;                     //!< active key modifiers
+    MouseState mouse;               //!< mouse position and buttons
+    int dx;                         //!< mouse movement on x-axis during the frame
+    int dy;                         //!< mouse movement on y-axis during the frame
+    JoystickState joystick;         //!< joystick axes and buttons
+    unsigned int frame;             //!< number of the frame
+    InputSnapshot();
+
+    /**
+     * Check if a key is held down.
+     *
+     * @param key Key symbol.
+     * @return True if the key is down.
+     */
+    bool IsKeyDown(Key key) const {
+        return key < KEY_LAST && keys[key];
+    }
+
+    /**
+     * Check if a key went down during the frame.
+     * A key pressed and released within the frame counts as pressed.
+     *
+     * @param key Key symbol.
+     * @return True if the key was pressed.
+     */
+    bool WasKeyPressed(Key key) const {
+        return key < KEY_LAST && pressed[key];
+    }
+
+    /**
+     * Check if a key went up during the frame.
+     *
+     * @param key Key symbol.
+     * @return True if the key was released.
+     */
+    bool WasKeyReleased(Key key) const {
+        return key < KEY_LAST && released[key];
+    }
+
+    /**
+     * Check if mouse buttons are held down.
+     *
+     * @param b Mouse buttons, possibly or'ed together.
+     * @return True if all of the buttons are down.
+     */
+    bool IsMouseDown(MouseButton b) const {
+        return (mouse.buttons & b) == b;
+    }
+};
+
+/**
+ * Input state module.
+ * Tracks the keyboard, mouse and joystick events and publishes the
+ * resulting InputSnapshot once per frame, so any number of systems can
+ * poll the input instead of each listening on the devices and keeping
+ * their own state.
+ *
+ * @code
+ * InputState* input = new InputState(keyboard, mouse, joystick);
+ * // publish after the devices have sent their events for the frame
+ * engine.ProcessEvent().Attach(*input);
+ * ...
+ * InputSnapshot s = input->GetSnapshot();
+ * if (s.IsKeyDown(KEY_w)) MoveForward(s.dy);
+ * @endcode
+ *
+ * The snapshot is double buffered: events are applied to a working
+ * state on the engine thread, and publishing copies it to the buffer
+ * readers are not using and swaps the buffers. GetSnapshot is lock
+ * free and may be called from any thread. A reader racing with a
+ * publish retries its copy, so it never sees a half written snapshot.
+ *
+ * Devices may be NULL if they are not present.
+ *
+ * @class InputState InputState.h Devices/InputState.h
+ */
+class InputState : public virtual Core::IModule
+                 , public IListener<KeyboardEventArg>
+                 , public IListener<MouseMovedEventArg>
+                 , public IListener<MouseButtonEventArg>
+                 , public IListener<JoystickAxisEventArg>
+                 , public IListener<JoystickButtonEventArg> {
+public:
+    InputState(IKeyboard* keyboard, IMouse* mouse, IJoystick* joystick = NULL);
+    virtual ~InputState();
+
+    InputSnapshot GetSnapshot() const;
+    void GetSnapshot(InputSnapshot& snapshot) const;
+    unsigned int GetFrame() const;
+    void Publish();
+
+    void Handle(InitializeEventArg arg);
+    void Handle(ProcessEventArg arg);
+    void Handle(DeinitializeEventArg arg);
+
+    void Handle(KeyboardEventArg arg);
+    void Handle(MouseMovedEventArg arg);
+    void Handle(MouseButtonEventArg arg);
+    void Handle(JoystickAxisEventArg arg);
+    void Handle(JoystickButtonEventArg arg);
+
+private:
+    IKeyboard* keyboard;
+    IMouse* mouse;
+    IJoystick* joystick;
+
+    InputSnapshot working;              //!< state of the current frame
+    InputSnapshot buffers[2];           //!< published snapshots
+    boost::atomic<unsigned int> sequence[2]; //!< odd while a buffer is written
+    boost::atomic<unsigned int> current;     //!< buffer readers use
+};
+
+} // NS Devices
+} // NS OpenEngine
+
+#endif // _OE_INPUT_STATE_H_
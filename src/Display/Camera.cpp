@@ -144,7 +144,7 @@ void Camera::SetDirection(const Quaternion<float> direction) {
  */
 void Camera::SetDirection(const Vector<3,float> direction, const Vector<3,float> up) {
     if (direction.IsZero() || up.IsZero()) {
-        logger.warning << "Ignoring call to Camera::SetDirection with the zero vector." << logger.end;
+        OE_LOG_WARNING << "Ignoring call to Camera::SetDirection with the zero vector." << logger.end;
         return;
     }
     Vector<3,float> z(-direction);
@@ -11,14 +11,64 @@
 #include <Geometry/Face.h>
 #include <Geometry/Line.h>
 #include <Geometry/Plane.h>
-#include <Core/Exceptions.h>
+#include <Geometry/VertexArray.h>
+
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
 
 namespace OpenEngine {
 namespace Geometry {
 
-using OpenEngine::Core::NotImplemented;
 using OpenEngine::Math::Vector;
 
+// points below which bounding is not worth a thread
+static const unsigned int PARALLEL_THRESHOLD = 1 << 16;
+
+/**
+ * Bound a range of points into lo[0..2] and hi[0..2].
+ * Tightly packed points are taken four at a time as twelve
+ * independent lanes, which the compiler turns into packed min/max
+ * instructions.
+ */
+static void BoundRange(const float* points, unsigned int begin, unsigned int end,
+                       unsigned int stride, float* lo, float* hi) {
+    const float* p = points + begin * stride;
+    for (int k=0; k<3; k++) lo[k] = hi[k] = p[k];
+    unsigned int i = begin;
+    if (stride == 3 && end - begin >= 4) {
+        float l[12], h[12];
+        for (int k=0; k<12; k++) l[k] = h[k] = p[k % 3];
+        for (; i + 4 <= end; i += 4) {
+            const float* q = points + i * 3;
+            for (int k=0; k<12; k++) {
+                l[k] = q[k] < l[k] ? q[k] : l[k];
+                h[k] = q[k] > h[k] ? q[k] : h[k];
+            }
+        }
+        for (int k=0; k<12; k++) {
+            lo[k % 3] = l[k] < lo[k % 3] ? l[k] : lo[k % 3];
+            hi[k % 3] = h[k] > hi[k % 3] ? h[k] : hi[k % 3];
+        }
+    }
+    for (; i < end; i++) {
+        const float* q = points + i * stride;
+        for (int k=0; k<3; k++) {
+            lo[k] = q[k] < lo[k] ? q[k] : lo[k];
+            hi[k] = q[k] > hi[k] ? q[k] : hi[k];
+        }
+    }
+}
+
+/**
+ * Create a box from its lowest and highest corner.
+ *
+ * @param min Lowest corner.
+ * @param max Highest corner.
+ */
+Box::Box(const Vector<3,float> min, const Vector<3,float> max)
+    : min(min), max(max) {
+}
+
 /**
  * Create a bounding box from a set of faces.
  * If the face set is empty the box will have center in [0,0,0] and
@@ -40,48 +90,121 @@ Box::Box(FaceSet& faces) {
  * @param node root node to create a box from.
  */
 Box::Box(ISceneNode& node) {
-    
-    FaceCollector fc(node);
-    FaceSet* faces = fc.GetFaceSet();
-    
-    SetFromFaces(*faces);
-    //delete faces;
+    FaceCollector fc(node, *this);
+}
 
+/**
+ * Create a bounding box from a vertex array.
+ * Compressed positions are bounded by their quantization range
+ * without decompressing them.
+ *
+ * @param va Vertex array to create a box from.
+ */
+Box::Box(VertexArray& va) {
+    if (va.GetNumFaces() <= 0 || !(va.GetAttributes() & VertexArray::VERTICES))
+        return;
+    if (va.GetFormats() & VertexArray::POSITION_16) {
+        min = va.GetPositionOffset();
+        max = min + va.GetPositionScale() * 65535.0f;
+        return;
+    }
+    unsigned int stride = va.GetStride() / sizeof(float);
+    SetFromPoints(va.GetVertices(), va.GetNumFaces() * 3, stride ? stride : 3);
 }
-   
+
 void Box::SetFromFaces(FaceSet& faces) {
     if (faces.Size() == 0) return;
 
-    // initialize max and min with the first member of the face set
+    // initialize with the first vertex and bound in a single pass
     FaceList::iterator itr = faces.begin();
-    Vector<3,float> max((*itr)->vert[0]);
-    Vector<3,float> min(max);
-
-    // find the boundary values
+    float lo[3], hi[3];
+    for (int k=0; k<3; k++) lo[k] = hi[k] = (*itr)->vert[0][k];
     for (; itr != faces.end(); itr++) {
-        for (int i=0; i<3; i++) {
-            Vector<3,float> v = (*itr)->vert[i];
-            for (int j=0; j<3; j++)
-                if (v[j] < min[j]) min[j] = v[j];
-                else if (v[j] > max[j]) max[j] = v[j];
+        Face* f = itr->get();
+        for (int i=0; i<3; i++)
+            for (int k=0; k<3; k++) {
+                float v = f->vert[i][k];
+                lo[k] = v < lo[k] ? v : lo[k];
+                hi[k] = v > hi[k] ? v : hi[k];
+            }
+    }
+    min = Vector<3,float>(lo[0], lo[1], lo[2]);
+    max = Vector<3,float>(hi[0], hi[1], hi[2]);
+}
+
+void Box::SetFromPoints(const float* points, unsigned int count,
+                        unsigned int stride) {
+    ComputeBounds(points, count, stride, min, max);
+}
+
+/**
+ * Compute the bounds of a set of points.
+ * Large sets are split over the available processors, each bounding
+ * its part, and the parts are merged.
+ *
+ * @param points Points, three floats each.
+ * @param count Number of points.
+ * @param stride Floats from one point to the next.
+ * @param min Set to the lowest corner.
+ * @param max Set to the highest corner.
+ * @return False if there are no points, leaving the corners unchanged.
+ */
+bool Box::ComputeBounds(const float* points, unsigned int count,
+                        unsigned int stride,
+                        Vector<3,float>& min, Vector<3,float>& max) {
+    if (count == 0) return false;
+    unsigned int threads = boost::thread::hardware_concurrency();
+    if (threads < 2 || count < PARALLEL_THRESHOLD) threads = 1;
+    vector<float> bounds(threads * 6);
+    boost::thread_group group;
+    for (unsigned int t=1; t<threads; t++)
+        group.create_thread(boost::bind(&BoundRange, points,
+                                        count / threads * t,
+                                        t + 1 == threads ? count
+                                        : count / threads * (t + 1),
+                                        stride, &bounds[t*6], &bounds[t*6+3]));
+    BoundRange(points, 0, threads == 1 ? count : count / threads,
+               stride, &bounds[0], &bounds[3]);
+    group.join_all();
+    for (unsigned int t=1; t<threads; t++)
+        for (int k=0; k<3; k++) {
+            float l = bounds[t*6+k], h = bounds[t*6+3+k];
+            bounds[k]   = l < bounds[k]   ? l : bounds[k];
+            bounds[3+k] = h > bounds[3+k] ? h : bounds[3+k];
         }
+    min = Vector<3,float>(bounds[0], bounds[1], bounds[2]);
+    max = Vector<3,float>(bounds[3], bounds[4], bounds[5]);
+    return true;
+}
+
+/**
+ * Grow the box to contain another box.
+ *
+ * @param box Box to contain.
+ */
+void Box::Grow(const Box& box) {
+    for (int k=0; k<3; k++) {
+        if (box.min.Get(k) < min[k]) min[k] = box.min.Get(k);
+        if (box.max.Get(k) > max[k]) max[k] = box.max.Get(k);
     }
-    // set box center
-    center = (max - min) / 2 + min;
-    // set corner vector
-    corner = max - center;
-    // compute the corners
-    float x = corner[0];
-    float y = corner[1];
-    float z = corner[2];
-    SetCorner(1,1,1, center+Vector<3,float>( x, y, z));
-    SetCorner(1,1,0, center+Vector<3,float>( x, y,-z));
-    SetCorner(1,0,1, center+Vector<3,float>( x,-y, z));
-    SetCorner(1,0,0, center+Vector<3,float>( x,-y,-z));
-    SetCorner(0,1,1, center+Vector<3,float>(-x, y, z));
-    SetCorner(0,1,0, center+Vector<3,float>(-x, y,-z));
-    SetCorner(0,0,1, center+Vector<3,float>(-x,-y, z));
-    SetCorner(0,0,0, center+Vector<3,float>(-x,-y,-z));
+}
+
+/**
+ * Get the lowest corner of the box.
+ *
+ * @return Corner with the smallest components.
+ */
+Vector<3,float> Box::GetMin() const {
+    return min;
+}
+
+/**
+ * Get the highest corner of the box.
+ *
+ * @return Corner with the largest components.
+ */
+Vector<3,float> Box::GetMax() const {
+    return max;
 }
 
 
@@ -91,7 +214,7 @@ void Box::SetFromFaces(FaceSet& faces) {
  * @return Center of the box.
  */
 Vector<3,float> Box::GetCenter() const {
-    return center;
+    return (min + max) * 0.5f;
 }
 
 /**
@@ -102,22 +225,7 @@ Vector<3,float> Box::GetCenter() const {
  * @return Corner vector from center.
  */
 Vector<3,float> Box::GetCorner() const {
-    return corner;
-}
-
-/**
- * Set a corner by its signed index.
- *
- * A positive sign given with: true / 1.
- * A negative sign given with: false / 0.
- *
- * @param signX The sign of the x component relative to the center.
- * @param signY The sign of the y component relative to the center.
- * @param signZ The sign of the z component relative to the center.
- * @param corner The corner position (not relative to the center).
- */
-void Box::SetCorner(const bool signX, const bool signY, const bool signZ, Vector<3,float> corner) {
-    corners[ signX*1 + signY*2 + signZ*4 ] = corner;
+    return (max - min) * 0.5f;
 }
 
 /**
@@ -128,7 +236,7 @@ void Box::SetCorner(const bool signX, const bool signY, const bool signZ, Vector
  * @return The absolute corner position given by the index.
  */
 Vector<3,float> Box::GetCorner(const int index) const {
-    return corners[ index ];
+    return GetCorner(index & 1, index & 2, index & 4);
 }
 
 /**
@@ -143,7 +251,9 @@ Vector<3,float> Box::GetCorner(const int index) const {
  * @return The absolute corner position given by the sign index.
  */
 Vector<3,float> Box::GetCorner(const bool signX, const bool signY, const bool signZ) const {
-    return corners[ signX*1 + signY*2 + signZ*4 ];
+    return Vector<3,float>(signX ? max.Get(0) : min.Get(0),
+                           signY ? max.Get(1) : min.Get(1),
+                           signZ ? max.Get(2) : min.Get(2));
 }
 
 /**
@@ -153,19 +263,12 @@ Vector<3,float> Box::GetCorner(const bool signX, const bool signY, const bool si
  * @return true if point is inside, false otherwise.
  */
 bool Box::Intersects(const Vector<3,float> point) const {
-    Vector<3,float> lowCorner,highCorner;
-
-    lowCorner = GetCorner(false,false,false);
-    highCorner = GetCorner(true,true,true);
-
-    
-
-    if (point.Get(0) >= lowCorner.Get(0) &&
-        point.Get(1) >= lowCorner.Get(1) &&
-        point.Get(2) >= lowCorner.Get(2) &&
-        point.Get(0) <= highCorner.Get(0) &&
-        point.Get(1) <= highCorner.Get(1) &&
-        point.Get(2) <= highCorner.Get(2))
+    if (point.Get(0) >= min.Get(0) &&
+        point.Get(1) >= min.Get(1) &&
+        point.Get(2) >= min.Get(2) &&
+        point.Get(0) <= max.Get(0) &&
+        point.Get(1) <= max.Get(1) &&
+        point.Get(2) <= max.Get(2))
         return true;
     else 
         return false;
@@ -180,32 +283,30 @@ bool Box::Intersects(const Vector<3,float> point) const {
  * @return true if part of, or the whole line is inside, false otherwise.
  */
 bool Box::Intersects(const Line line) const {
-    // The lines direction.
-    Vector<3,float> dir = line.point1 - line.point2;
+    // Half the line segment.
+    Vector<3,float> h = (line.point2 - line.point1) * 0.5f;
     // Midpoint of the line.
-    Vector<3,float> mid = line.point1 + (dir / 2);
-    // Half the length of the line segment.
-    float hl = dir.GetLength() / 2;
+    Vector<3,float> mid = line.point1 + h;
 
     /* ALGORITHM: Use the separating axis
     theorem to see if the line segment
     and the box overlap. A line
     segment is a degenerate OBB. */
 
-    //const VECTOR T = b.P - mid;
-    Vector<3,float> t = center - mid;
+    Vector<3,float> t = GetCenter() - mid;
+    Vector<3,float> corner = GetCorner();
     float r;
 
     //do any of the principal axes
     //form a separating axis?
 
-    if( fabs(t[0]) > (corner.Get(0) + hl * fabs(dir[0]) ))
+    if( fabs(t[0]) > corner.Get(0) + fabs(h[0]) )
     return false;
 
-    if( fabs(t[1]) > corner.Get(1) + hl*fabs(dir[1]) )
+    if( fabs(t[1]) > corner.Get(1) + fabs(h[1]) )
     return false;
 
-    if( fabs(t[2]) > corner.Get(2) + hl*fabs(dir[2]) )
+    if( fabs(t[2]) > corner.Get(2) + fabs(h[2]) )
     return false;
 
     /* NOTE: Since the separating axis is
@@ -215,23 +316,23 @@ bool Box::Intersects(const Line line) const {
 
     //l.cross(x-axis)?
 
-    r = corner.Get(1)*fabs(dir[2]) + corner.Get(2)*fabs(dir[1]);
+    r = corner.Get(1)*fabs(h[2]) + corner.Get(2)*fabs(h[1]);
 
-    if( fabs(t[1]*dir[2] - t[2]*dir[1]) > r )
+    if( fabs(t[1]*h[2] - t[2]*h[1]) > r )
     return false;
 
     //l.cross(y-axis)?
 
-    r = corner.Get(0)*fabs(dir[2]) + corner.Get(2)*fabs(dir[0]);
+    r = corner.Get(0)*fabs(h[2]) + corner.Get(2)*fabs(h[0]);
 
-    if( fabs(t[2]*dir[0] - t[0]*dir[2]) > r )
+    if( fabs(t[2]*h[0] - t[0]*h[2]) > r )
     return false;
 
     //l.cross(z-axis)?
 
-    r = corner.Get(0)*fabs(dir[1]) + corner.Get(1)*fabs(dir[0]);
+    r = corner.Get(0)*fabs(h[1]) + corner.Get(1)*fabs(h[0]);
 
-    if( fabs(t[0]*dir[1] - t[1]*dir[0]) > r )
+    if( fabs(t[0]*h[1] - t[1]*h[0]) > r )
     return false;
 
     return true;
@@ -240,13 +341,28 @@ bool Box::Intersects(const Line line) const {
 /**
  * Check if a plane intersects with the box.
  *
- * NOTE: NOT IMPLEMENTED YET!
- *
  * @param plane to test.
  * @return true if part of the plane is inside, false otherwise.
  */
 bool Box::Intersects(const Plane plane) const {
-    throw NotImplemented(); 
+    Vector<3,float> corner = GetCorner();
+    float r = 0;
+    for (int i=0; i<3; i++)
+        r += corner.Get(i) * fabs(plane.normal.Get(i));
+    return fabs(plane.normal * GetCenter() + plane.distance) <= r;
+}
+
+/**
+ * Check if two boxes overlap.
+ *
+ * @param box Box to test.
+ * @return true if the boxes overlap, false otherwise.
+ */
+bool Box::Intersects(const Box& box) const {
+    for (int i=0; i<3; i++)
+        if (box.min.Get(i) > max.Get(i) || box.max.Get(i) < min.Get(i))
+            return false;
+    return true;
 }
 
 } //NS Geometry
@@ -12,11 +12,14 @@
 
 #include <Geometry/FaceSet.h>
 #include <Geometry/BoundingGeometry.h>
+#include <Geometry/GeometrySet.h>
 #include <Scene/ISceneNodeVisitor.h>
 #include <Scene/ISceneNode.h>
 #include <Scene/GeometryNode.h>
 #include <string>
 #include <vector>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/version.hpp>
 
 namespace OpenEngine {
 namespace Geometry {
@@ -25,9 +28,15 @@ using OpenEngine::Math::Vector;
 using namespace OpenEngine::Scene;
 using std::vector;
 
+class VertexArray;
 
 /**
  * Bounding geometry box.
+ * An axis aligned box stored as its minimum and maximum corner; the
+ * center and the other corners are computed on demand.
+ *
+ * The bounds of large point sets are found in a single pass, split
+ * over the available processors (see \a ComputeBounds).
  *
  * @class Box Box.h Geometry/Box.h
  */
@@ -36,50 +45,86 @@ class Box : public BoundingGeometry {
 friend class Geometry;
     
 private:
-// private visitor class to collect faces in scene graphs
+// private visitor class to bound the faces in scene graphs
  class FaceCollector : public ISceneNodeVisitor {
  private:
-    FaceSet* faces;
+    Box& box;
+    bool empty;
  public:
-    FaceCollector(ISceneNode& node) {
-        faces = new FaceSet();
+    FaceCollector(ISceneNode& node, Box& box) : box(box), empty(true) {
         node.Accept(*this);
     }
     
     virtual ~FaceCollector() {};
     
     void VisitGeometryNode(GeometryNode* node) {
-        faces->Add(node->GetFaceSet());
+        FaceSet* faces = node->GetFaceSet();
+        if (faces != NULL && faces->Size() > 0) {
+            Box b(*faces);
+            if (empty) box = b;
+            else box.Grow(b);
+            empty = false;
+        }
+        node->VisitSubNodes(*this);
     }
-     
-     FaceSet* GetFaceSet() {
-         return faces;
-     }
  };
     
-    Vector<3,float> center;     //!< Box center
-    Vector<3,float> corner;     //!< Box corner (relative)
-    Vector<3,float> corners[8]; //!< Box corners (absolute)
+    Vector<3,float> min;        //!< Lowest corner
+    Vector<3,float> max;        //!< Highest corner
 
-    void SetCorner(const bool x, const bool y, const bool z, Vector<3,float> c);
     void SetFromFaces(FaceSet& faces);
+    void SetFromPoints(const float* points, unsigned int count,
+                       unsigned int stride);
     
     friend class boost::serialization::access;
     template<class Archive>
-    void serialize(Archive & ar, const unsigned int version)
-    {
-        ar & center;
-        ar & corner;
-        ar & corners;
+    void save(Archive & ar, const unsigned int version) const {
+        ar & min;
+        ar & max;
     }
-
+    template<class Archive>
+    void load(Archive & ar, const unsigned int version) {
+        if (version == 0) {
+            // center, relative corner and the eight corners
+            Vector<3,float> center, corner, corners[8];
+            ar & center;
+            ar & corner;
+            ar & corners;
+            min = center - corner;
+            max = center + corner;
+        } else {
+            ar & min;
+            ar & max;
+        }
+    }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
 
 public:
     Box() {}; // empty constructor for serialization
 
+    Box(const Vector<3,float> min, const Vector<3,float> max);
     explicit Box(FaceSet& faces);
     explicit Box (ISceneNode& node);
-    
+    explicit Box(VertexArray& va);
+
+    /**
+     * Create a bounding box from a geometry set in space.
+     *
+     * @param set Geometry set to create a box from.
+     */
+    template <int Shape>
+    explicit Box(GeometrySet<3,Shape>& set) {
+        SetFromPoints(set.GetVertArray(), set.GetVertLength() / 3, 3);
+    }
+
+    static bool ComputeBounds(const float* points, unsigned int count,
+                              unsigned int stride,
+                              Vector<3,float>& min, Vector<3,float>& max);
+
+    void Grow(const Box& box);
+
+    Vector<3,float> GetMin() const;
+    Vector<3,float> GetMax() const;
     Vector<3,float> GetCenter() const;
     Vector<3,float> GetCorner() const;
     Vector<3,float> GetCorner(const int index) const;
@@ -88,10 +133,13 @@ public:
     bool Intersects(const Vector<3,float> point) const;
     bool Intersects(const Line line) const;
     bool Intersects(const Plane plane) const;
+    bool Intersects(const Box& box) const;
 
 };
 
 } //NS Common
 } //NS OpenEngine
 
+BOOST_CLASS_VERSION(OpenEngine::Geometry::Box, 1)
+
 #endif
@@ -0,0 +1,332 @@
+// Box set.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Geometry/BoxSet.h>
+#include <Geometry/Sphere.h>
+#include <Geometry/Line.h>
+#include <Geometry/Plane.h>
+#include <Geometry/OrientedBox.h>
+
+#include <cmath>
+
+namespace OpenEngine {
+namespace Geometry {
+
+// see OrientedBox
+static const float PARALLEL_EPSILON = 1e-6f;
+
+// The tests below are functors over the component arrays, evaluated
+// for 32 boxes at a time into a mask word. They combine their terms
+// with & rather than && to keep the loops free of branches.
+
+namespace {
+
+struct BoxArrays {
+    const float *minX, *minY, *minZ, *maxX, *maxY, *maxZ;
+};
+
+struct PointTest {
+    BoxArrays b;
+    float p[3];
+    bool operator()(unsigned int i) const {
+        return (p[0] >= b.minX[i]) & (p[1] >= b.minY[i]) & (p[2] >= b.minZ[i]) &
+            (p[0] <= b.maxX[i]) & (p[1] <= b.maxY[i]) & (p[2] <= b.maxZ[i]);
+    }
+};
+
+struct PlaneTest {
+    BoxArrays b;
+    float n[3], absN[3], d;
+    bool operator()(unsigned int i) const {
+        float c = (b.minX[i] + b.maxX[i]) * n[0] + (b.minY[i] + b.maxY[i]) * n[1]
+            + (b.minZ[i] + b.maxZ[i]) * n[2];
+        float r = (b.maxX[i] - b.minX[i]) * absN[0] + (b.maxY[i] - b.minY[i]) * absN[1]
+            + (b.maxZ[i] - b.minZ[i]) * absN[2];
+        // both doubled
+        return fabs(c + 2 * d) <= r;
+    }
+};
+
+struct LineTest {
+    BoxArrays b;
+    float mid[3], h[3], absH[3];
+    bool operator()(unsigned int i) const {
+        float e[3] = {(b.maxX[i] - b.minX[i]) * 0.5f, (b.maxY[i] - b.minY[i]) * 0.5f,
+                      (b.maxZ[i] - b.minZ[i]) * 0.5f};
+        float t[3] = {(b.maxX[i] + b.minX[i]) * 0.5f - mid[0],
+                      (b.maxY[i] + b.minY[i]) * 0.5f - mid[1],
+                      (b.maxZ[i] + b.minZ[i]) * 0.5f - mid[2]};
+        return (fabs(t[0]) <= e[0] + absH[0]) &
+            (fabs(t[1]) <= e[1] + absH[1]) &
+            (fabs(t[2]) <= e[2] + absH[2]) &
+            (fabs(t[1]*h[2] - t[2]*h[1]) <= e[1]*absH[2] + e[2]*absH[1]) &
+            (fabs(t[2]*h[0] - t[0]*h[2]) <= e[0]*absH[2] + e[2]*absH[0]) &
+            (fabs(t[0]*h[1] - t[1]*h[0]) <= e[0]*absH[1] + e[1]*absH[0]);
+    }
+};
+
+struct BoxTest {
+    BoxArrays b;
+    float lo[3], hi[3];
+    bool operator()(unsigned int i) const {
+        return (b.minX[i] <= hi[0]) & (b.minY[i] <= hi[1]) & (b.minZ[i] <= hi[2]) &
+            (b.maxX[i] >= lo[0]) & (b.maxY[i] >= lo[1]) & (b.maxZ[i] >= lo[2]);
+    }
+};
+
+struct SphereTest {
+    BoxArrays b;
+    float c[3], r2;
+    static float Excess(float c, float lo, float hi) {
+        float e = lo - c > 0 ? lo - c : 0;
+        return c - hi > e ? c - hi : e;
+    }
+    bool operator()(unsigned int i) const {
+        float x = Excess(c[0], b.minX[i], b.maxX[i]);
+        float y = Excess(c[1], b.minY[i], b.maxY[i]);
+        float z = Excess(c[2], b.minZ[i], b.maxZ[i]);
+        return x*x + y*y + z*z <= r2;
+    }
+};
+
+// separating axes between each box (A) and an oriented box (B); the
+// rotation from A to B is the same for all boxes
+struct OrientedBoxTest {
+    BoxArrays b;
+    float c[3];                 //!< center of B
+    float r[3][3], absR[3][3];  //!< B axes in A space
+    float rbA[3];               //!< radius of B on each axis of A
+    float ext[3];               //!< extent of B
+    float rbC[3][3];            //!< radius of B on each cross axis
+    bool operator()(unsigned int i) const {
+        float a[3] = {(b.maxX[i] - b.minX[i]) * 0.5f, (b.maxY[i] - b.minY[i]) * 0.5f,
+                      (b.maxZ[i] - b.minZ[i]) * 0.5f};
+        float t[3] = {c[0] - (b.maxX[i] + b.minX[i]) * 0.5f,
+                      c[1] - (b.maxY[i] + b.minY[i]) * 0.5f,
+                      c[2] - (b.maxZ[i] + b.minZ[i]) * 0.5f};
+        bool hit = true;
+        for (int k=0; k<3; k++)
+            hit &= fabs(t[k]) <= a[k] + rbA[k];
+        for (int j=0; j<3; j++)
+            hit &= fabs(t[0]*r[0][j] + t[1]*r[1][j] + t[2]*r[2][j]) <=
+                a[0]*absR[0][j] + a[1]*absR[1][j] + a[2]*absR[2][j] + ext[j];
+        for (int k=0; k<3; k++) {
+            int k1 = (k + 1) % 3, k2 = (k + 2) % 3;
+            for (int j=0; j<3; j++)
+                hit &= fabs(t[k2]*r[k1][j] - t[k1]*r[k2][j]) <=
+                    a[k1]*absR[k2][j] + a[k2]*absR[k1][j] + rbC[k][j];
+        }
+        return hit;
+    }
+};
+
+} // anonymous namespace
+
+template <class Test>
+static void Fill(const Test& test, unsigned int size, vector<unsigned int>& mask) {
+    mask.assign((size + 31) / 32, 0);
+    for (unsigned int w=0; w<mask.size(); w++) {
+        unsigned int first = w * 32;
+        unsigned int count = size - first < 32 ? size - first : 32;
+        unsigned int bits = 0;
+        for (unsigned int j=0; j<count; j++)
+            bits |= (unsigned int)test(first + j) << j;
+        mask[w] = bits;
+    }
+}
+
+/**
+ * Create an empty set.
+ */
+BoxSet::BoxSet() {}
+
+/**
+ * Destructor.
+ */
+BoxSet::~BoxSet() {}
+
+/**
+ * Add a box.
+ *
+ * @param box Box to add.
+ * @return Index of the box.
+ */
+unsigned int BoxSet::Add(const Box& box) {
+    Vector<3,float> lo = box.GetMin(), hi = box.GetMax();
+    minX.push_back(lo[0]); minY.push_back(lo[1]); minZ.push_back(lo[2]);
+    maxX.push_back(hi[0]); maxY.push_back(hi[1]); maxZ.push_back(hi[2]);
+    return minX.size() - 1;
+}
+
+/**
+ * Replace a box.
+ *
+ * @param index Index of the box.
+ * @param box New box.
+ */
+void BoxSet::Set(unsigned int index, const Box& box) {
+    Vector<3,float> lo = box.GetMin(), hi = box.GetMax();
+    minX[index] = lo[0]; minY[index] = lo[1]; minZ[index] = lo[2];
+    maxX[index] = hi[0]; maxY[index] = hi[1]; maxZ[index] = hi[2];
+}
+
+/**
+ * Get a box.
+ *
+ * @param index Index of the box.
+ * @return The box.
+ */
+Box BoxSet::Get(unsigned int index) const {
+    return Box(Vector<3,float>(minX[index], minY[index], minZ[index]),
+               Vector<3,float>(maxX[index], maxY[index], maxZ[index]));
+}
+
+/**
+ * Get the number of boxes.
+ *
+ * @return Number of boxes.
+ */
+unsigned int BoxSet::GetSize() const {
+    return minX.size();
+}
+
+/**
+ * Remove all boxes.
+ */
+void BoxSet::Clear() {
+    minX.clear(); minY.clear(); minZ.clear();
+    maxX.clear(); maxY.clear(); maxZ.clear();
+}
+
+static BoxArrays Arrays(const vector<float>& minX, const vector<float>& minY,
+                        const vector<float>& minZ, const vector<float>& maxX,
+                        const vector<float>& maxY, const vector<float>& maxZ) {
+    BoxArrays b;
+    b.minX = minX.empty() ? NULL : &minX[0];
+    b.minY = minY.empty() ? NULL : &minY[0];
+    b.minZ = minZ.empty() ? NULL : &minZ[0];
+    b.maxX = maxX.empty() ? NULL : &maxX[0];
+    b.maxY = maxY.empty() ? NULL : &maxY[0];
+    b.maxZ = maxZ.empty() ? NULL : &maxZ[0];
+    return b;
+}
+
+/**
+ * Find the boxes containing a point.
+ *
+ * @param point Point to test.
+ * @param mask Set to one bit per box.
+ */
+void BoxSet::Intersects(const Vector<3,float> point, vector<unsigned int>& mask) const {
+    PointTest test;
+    test.b = Arrays(minX, minY, minZ, maxX, maxY, maxZ);
+    for (int k=0; k<3; k++) test.p[k] = point.Get(k);
+    Fill(test, GetSize(), mask);
+}
+
+/**
+ * Find the boxes cut by a plane.
+ *
+ * @param plane Plane to test.
+ * @param mask Set to one bit per box.
+ */
+void BoxSet::Intersects(const Plane& plane, vector<unsigned int>& mask) const {
+    PlaneTest test;
+    test.b = Arrays(minX, minY, minZ, maxX, maxY, maxZ);
+    for (int k=0; k<3; k++) {
+        test.n[k] = plane.normal.Get(k);
+        test.absN[k] = fabs(test.n[k]);
+    }
+    test.d = plane.distance;
+    Fill(test, GetSize(), mask);
+}
+
+/**
+ * Find the boxes intersecting a line segment.
+ *
+ * @param line Line segment to test.
+ * @param mask Set to one bit per box.
+ */
+void BoxSet::Intersects(const Line& line, vector<unsigned int>& mask) const {
+    LineTest test;
+    test.b = Arrays(minX, minY, minZ, maxX, maxY, maxZ);
+    for (int k=0; k<3; k++) {
+        test.h[k] = (line.point2.Get(k) - line.point1.Get(k)) * 0.5f;
+        test.absH[k] = fabs(test.h[k]);
+        test.mid[k] = line.point1.Get(k) + test.h[k];
+    }
+    Fill(test, GetSize(), mask);
+}
+
+/**
+ * Find the boxes overlapping a box.
+ *
+ * @param box Box to test.
+ * @param mask Set to one bit per box.
+ */
+void BoxSet::Intersects(const Box& box, vector<unsigned int>& mask) const {
+    BoxTest test;
+    test.b = Arrays(minX, minY, minZ, maxX, maxY, maxZ);
+    Vector<3,float> lo = box.GetMin(), hi = box.GetMax();
+    for (int k=0; k<3; k++) {
+        test.lo[k] = lo[k];
+        test.hi[k] = hi[k];
+    }
+    Fill(test, GetSize(), mask);
+}
+
+/**
+ * Find the boxes intersecting a sphere.
+ *
+ * @param sphere Sphere to test.
+ * @param mask Set to one bit per box.
+ */
+void BoxSet::Intersects(const Sphere& sphere, vector<unsigned int>& mask) const {
+    SphereTest test;
+    test.b = Arrays(minX, minY, minZ, maxX, maxY, maxZ);
+    Vector<3,float> c = sphere.GetCenter();
+    for (int k=0; k<3; k++) test.c[k] = c[k];
+    test.r2 = sphere.GetRadius() * sphere.GetRadius();
+    Fill(test, GetSize(), mask);
+}
+
+/**
+ * Find the boxes intersecting an oriented box, with the separating
+ * axis test of \a OrientedBox.
+ *
+ * @param box Oriented box to test.
+ * @param mask Set to one bit per box.
+ */
+void BoxSet::Intersects(const OrientedBox& box, vector<unsigned int>& mask) const {
+    OrientedBoxTest test;
+    test.b = Arrays(minX, minY, minZ, maxX, maxY, maxZ);
+    Vector<3,float> c = box.GetCenter(), e = box.GetExtent();
+    for (int j=0; j<3; j++) {
+        Vector<3,float> axis = box.GetAxis(j);
+        test.c[j] = c[j];
+        test.ext[j] = e[j];
+        for (int i=0; i<3; i++) {
+            test.r[i][j] = axis[i];
+            test.absR[i][j] = fabs(axis[i]) + PARALLEL_EPSILON;
+        }
+    }
+    for (int i=0; i<3; i++) {
+        test.rbA[i] = 0;
+        for (int j=0; j<3; j++) test.rbA[i] += test.ext[j] * test.absR[i][j];
+        for (int j=0; j<3; j++) {
+            int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            test.rbC[i][j] = test.ext[j1] * test.absR[i][j2]
+                + test.ext[j2] * test.absR[i][j1];
+        }
+    }
+    Fill(test, GetSize(), mask);
+}
+
+} // NS Geometry
+} // NS OpenEngine
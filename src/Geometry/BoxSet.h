@@ -0,0 +1,67 @@
+// Box set.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_BOX_SET_H_
+#define _OE_BOX_SET_H_
+
+#include <Geometry/Box.h>
+#include <vector>
+
+namespace OpenEngine {
+namespace Geometry {
+
+class Sphere;
+class Line;
+class Plane;
+class OrientedBox;
+
+using std::vector;
+
+/**
+ * Set of axis aligned boxes tested together.
+ * The boxes are stored as one array per bound component, so a test
+ * against all boxes runs as a single loop without virtual calls that
+ * the compiler can vectorize. Results are written as bit masks, bit
+ * \a i % 32 of word \a i / 32 telling if box \a i intersects:
+ * @code
+ * vector<unsigned int> hits;
+ * triggers.Intersects(Sphere(player, 2), hits);
+ * for (unsigned int i=0; i<triggers.GetSize(); i++)
+ *     if (hits[i / 32] & (1u << (i % 32))) Fire(i);
+ * @endcode
+ *
+ * @class BoxSet BoxSet.h Geometry/BoxSet.h
+ */
+class BoxSet {
+private:
+    vector<float> minX, minY, minZ;
+    vector<float> maxX, maxY, maxZ;
+
+public:
+    BoxSet();
+    virtual ~BoxSet();
+
+    unsigned int Add(const Box& box);
+    void Set(unsigned int index, const Box& box);
+    Box Get(unsigned int index) const;
+    unsigned int GetSize() const;
+    void Clear();
+
+    void Intersects(const Vector<3,float> point, vector<unsigned int>& mask) const;
+    void Intersects(const Plane& plane, vector<unsigned int>& mask) const;
+    void Intersects(const Line& line, vector<unsigned int>& mask) const;
+    void Intersects(const Box& box, vector<unsigned int>& mask) const;
+    void Intersects(const Sphere& sphere, vector<unsigned int>& mask) const;
+    void Intersects(const OrientedBox& box, vector<unsigned int>& mask) const;
+};
+
+} // NS Geometry
+} // NS OpenEngine
+
+#endif // _OE_BOX_SET_H_
@@ -118,7 +118,7 @@ Face::~Face() {
  */
 int Face::ComparePointPlane(const Vector<3,float>& point, const float epsilon) {
 	if (hardNorm.GetLength() == 0.0f) {
-		logger.warning << "hardNorm is 0.0f: " << vert[0] << ","
+		OE_LOG_WARNING << "hardNorm is 0.0f: " << vert[0] << ","
                        << vert[1] << "," << vert[2] << logger.end;
     }
 
@@ -270,7 +270,7 @@ void Face::CalcHardNorm() {
 
     // check if the normal is valid
     if (h.IsZero()) {
-        logger.warning << "Normal is zero due to invalid face." << logger.end;
+        OE_LOG_WARNING << "Normal is zero due to invalid face." << logger.end;
         return;
     }
 
@@ -252,18 +252,18 @@ void FaceSet::Split(FacePtr& plane, FaceSet& front, FaceSet& span, FaceSet& back
                     if (b2->Verify()) {
                         b2->CalcHardNorm();
                         back.Add(b2);
-                    } else logger.warning << "Back face is invalid" << logger.end;
+                    } else OE_LOG_WARNING_LIMITED << "Back face is invalid" << logger.end;
                 } else {
                     // add the faces
                     if (f1->Verify()) { f1->CalcHardNorm(); front.Add(f1); }
-                    else logger.warning << "f1 in case -1 is invalid after split, "
-                                        << "a larger epsilon value might help." << logger.end;
+                    else OE_LOG_WARNING_LIMITED << "f1 in case -1 is invalid after split, "
+                                                << "a larger epsilon value might help." << logger.end;
                     if (b1->Verify()) { b1->CalcHardNorm(); back.Add(b1); }
-                    else logger.warning << "b1 in case -1 is invalid after split, "
-                                        << "a larger epsilon value might help." << logger.end;
+                    else OE_LOG_WARNING_LIMITED << "b1 in case -1 is invalid after split, "
+                                                << "a larger epsilon value might help." << logger.end;
                     if (b2->Verify()) { b2->CalcHardNorm(); back.Add(b2); }
-                    else logger.warning << "b2 in case -1 is invalid after split, "
-                                        << "a larger epsilon value might help." << logger.end;
+                    else OE_LOG_WARNING_LIMITED << "b2 in case -1 is invalid after split, "
+                                                << "a larger epsilon value might help." << logger.end;
                 }
                 delete fint1;
                 delete fint2;
@@ -333,18 +333,18 @@ void FaceSet::Split(FacePtr& plane, FaceSet& front, FaceSet& span, FaceSet& back
                     if (f2->Verify()) {
                         f2->CalcHardNorm();
                         front.Add(f2);
-                    } else logger.warning << "Front face is invalid" << logger.end;
+                    } else OE_LOG_WARNING_LIMITED << "Front face is invalid" << logger.end;
                 } else {
                     // add the faces
                     if (f1->Verify()) { f1->CalcHardNorm(); front.Add(f1); }
-                    else logger.warning << "f1 in case 1 is invalid after split, "
-                                        << "a larger epsilon value might help." << logger.end;
+                    else OE_LOG_WARNING_LIMITED << "f1 in case 1 is invalid after split, "
+                                                << "a larger epsilon value might help." << logger.end;
                     if (f2->Verify()) { f2->CalcHardNorm(); front.Add(f2); }
-                    else logger.warning << "f2 in case 1 is invalid after split, "
-                                        << "a larger epsilon value might help." << logger.end;
+                    else OE_LOG_WARNING_LIMITED << "f2 in case 1 is invalid after split, "
+                                                << "a larger epsilon value might help." << logger.end;
                     if (b1->Verify()) { b1->CalcHardNorm(); back.Add(b1); }
-                    else logger.warning << "b1 in case 1 is invalid after split, "
-                                        << "a larger epsilon value might help." << logger.end;
+                    else OE_LOG_WARNING_LIMITED << "b1 in case 1 is invalid after split, "
+                                                << "a larger epsilon value might help." << logger.end;
                 }
                 delete fint1;
                 delete fint2;
@@ -26,14 +26,9 @@ bool Geometry::Intersects(const Box& box, const Square& square) {
  *
  */
 bool Geometry::Intersects(const Square& square, const Box& box) {
-    return (square.Intersects(box.center + box.corner) ||
-            square.Intersects(box.center + box.corner * Vector<3,float>( 1, 1,-1)) ||
-            square.Intersects(box.center + box.corner * Vector<3,float>( 1,-1, 1)) ||
-            square.Intersects(box.center + box.corner * Vector<3,float>( 1,-1,-1)) ||
-            square.Intersects(box.center + box.corner * Vector<3,float>(-1, 1, 1)) ||
-            square.Intersects(box.center + box.corner * Vector<3,float>(-1, 1,-1)) ||
-            square.Intersects(box.center + box.corner * Vector<3,float>(-1,-1, 1)) ||
-            square.Intersects(box.center + box.corner * Vector<3,float>(-1,-1,-1)) );
+    for (int i=0; i<8; i++)
+        if (square.Intersects(box.GetCorner(i))) return true;
+    return false;
 }
 
 bool Geometry::Intersects(const Sphere& sphere, const Square& square) {
@@ -0,0 +1,448 @@
+// Half-edge mesh.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Geometry/HalfEdgeMesh.h>
+#include <Geometry/FaceSet.h>
+#include <Core/Exceptions.h>
+
+#include <cmath>
+#include <cstring>
+#include <boost/cstdint.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/functional/hash.hpp>
+
+namespace OpenEngine {
+namespace Geometry {
+
+using OpenEngine::Core::Exception;
+using boost::int32_t;
+using boost::int64_t;
+using boost::uint64_t;
+using boost::unordered_map;
+
+const unsigned int HalfEdgeMesh::NONE;
+
+namespace {
+
+// Welding key of a vertex position. Either the bit pattern of the
+// coordinates or the coordinates quantized to the welding distance.
+struct WeldKey {
+    int64_t c[3];
+    bool operator==(const WeldKey& k) const {
+        return c[0] == k.c[0] && c[1] == k.c[1] && c[2] == k.c[2];
+    }
+};
+
+std::size_t hash_value(const WeldKey& k) {
+    std::size_t seed = 0;
+    boost::hash_combine(seed, k.c[0]);
+    boost::hash_combine(seed, k.c[1]);
+    boost::hash_combine(seed, k.c[2]);
+    return seed;
+}
+
+// Quantized coordinates beyond this do not fit the grid.
+const double KEY_LIMIT = 4611686018427387904.0; // 2^62
+
+// Bit pattern of a coordinate, -0 welding with 0.
+int32_t Bits(float f) {
+    f += 0.0f;
+    int32_t bits;
+    memcpy(&bits, &f, sizeof(float));
+    return bits;
+}
+
+WeldKey MakeKey(const Vector<3,float>& v, float epsilon) {
+    WeldKey k;
+    for (int i=0; i<3; i++) {
+        float f = v.Get(i);
+        if (epsilon > 0.0f) {
+            // in double, as a tiny epsilon or a huge position
+            // overflows an integer
+            double q = floor((double)f / epsilon + 0.5);
+            if (fabs(q) <= KEY_LIMIT) {
+                k.c[i] = (int64_t)q;
+                continue;
+            }
+            // off the grid positions are only welded when equal, with
+            // keys outside the grid range
+            int64_t off = (int64_t)KEY_LIMIT + 1 + Bits(fabs(f));
+            k.c[i] = f < 0.0f ? -off : off;
+        } else
+            k.c[i] = Bits(f);
+    }
+    return k;
+}
+
+typedef unordered_map<WeldKey, unsigned int> WeldMap;
+
+// Index of the welded vertex at a position, added if not yet seen.
+unsigned int Weld(WeldMap& weld, vector<Vector<3,float> >& positions,
+                  const Vector<3,float>& v, float epsilon) {
+    std::pair<WeldMap::iterator, bool> res =
+        weld.insert(std::make_pair(MakeKey(v, epsilon),
+                                   (unsigned int)positions.size()));
+    if (res.second) positions.push_back(v);
+    return res.first->second;
+}
+
+// Key of the directed edge from a to b.
+inline uint64_t EdgeKey(unsigned int a, unsigned int b) {
+    return ((uint64_t)a << 32) | b;
+}
+
+} // anonymous namespace
+
+/**
+ * Build a mesh from a face set.
+ * Vertices at the same position are welded into one mesh vertex.
+ * With a positive \a epsilon, positions are snapped to a grid of
+ * that size before comparison, so vertices closer than \a epsilon
+ * are welded unless they fall on either side of a grid line.
+ *
+ * @param faces Faces to build from. Mesh face \a f is the \a f'th
+ * face of the set (see \a GetSourceFace).
+ * @param epsilon Welding distance [optional].
+ */
+HalfEdgeMesh::HalfEdgeMesh(FaceSet& faces, float epsilon) {
+    unsigned int size = faces.Size();
+    origin.reserve(size * 3);
+    sources.reserve(size);
+    WeldMap weld(size * 2);
+    for (FaceList::iterator itr = faces.begin(); itr != faces.end(); itr++) {
+        FacePtr face = *itr;
+        sources.push_back(face);
+        for (int i=0; i<3; i++)
+            origin.push_back(Weld(weld, positions, face->vert[i], epsilon));
+    }
+    Build();
+}
+
+/**
+ * Build a mesh from a triangle soup, such as the vertex array of a
+ * VertexArray. Vertices are welded as for a face set.
+ *
+ * @param corners Corner positions, three floats per corner and three
+ * corners per face.
+ * @param numFaces Number of faces.
+ * @param epsilon Welding distance [optional].
+ */
+HalfEdgeMesh::HalfEdgeMesh(const float* corners, unsigned int numFaces,
+                           float epsilon) {
+    origin.reserve(numFaces * 3);
+    WeldMap weld(numFaces * 2);
+    for (unsigned int i=0; i<numFaces*3; i++) {
+        Vector<3,float> v(corners[i*3], corners[i*3+1], corners[i*3+2]);
+        origin.push_back(Weld(weld, positions, v, epsilon));
+    }
+    Build();
+}
+
+/**
+ * Build a mesh from an indexed triangle list.
+ *
+ * @param vertices Vertex positions, three floats per vertex.
+ * @param numVertices Number of vertices.
+ * @param indices Vertex indices, three per triangle.
+ * @param numIndices Number of indices.
+ * @throws Exception if an index is out of range.
+ */
+HalfEdgeMesh::HalfEdgeMesh(const float* vertices, unsigned int numVertices,
+                           const unsigned int* indices, unsigned int numIndices) {
+    positions.reserve(numVertices);
+    for (unsigned int i=0; i<numVertices; i++)
+        positions.push_back(Vector<3,float>(vertices[i*3],
+                                            vertices[i*3+1],
+                                            vertices[i*3+2]));
+    numIndices -= numIndices % 3;
+    origin.reserve(numIndices);
+    for (unsigned int i=0; i<numIndices; i++) {
+        if (indices[i] >= numVertices)
+            throw Exception("Vertex index out of range in half-edge mesh");
+        origin.push_back(indices[i]);
+    }
+    Build();
+}
+
+/**
+ * Destructor.
+ */
+HalfEdgeMesh::~HalfEdgeMesh() {}
+
+/**
+ * Pair the half-edges and find the vertex edges. Runs in linear
+ * time (expected) using a hash of the directed edges.
+ */
+void HalfEdgeMesh::Build() {
+    unsigned int edges = origin.size();
+    twin.assign(edges, NONE);
+    vertexEdge.assign(positions.size(), NONE);
+
+    // index the directed edges, flagging duplicates and degenerates
+    vector<char> bad(edges, 0);
+    unordered_map<uint64_t, unsigned int> directed(edges * 2);
+    for (unsigned int e=0; e<edges; e++) {
+        unsigned int a = origin[e], b = GetTarget(e);
+        if (a == b) { bad[e] = 1; continue; }
+        std::pair<unordered_map<uint64_t, unsigned int>::iterator, bool> res =
+            directed.insert(std::make_pair(EdgeKey(a, b), e));
+        if (!res.second) bad[e] = bad[res.first->second] = 1;
+    }
+
+    // pair each half-edge with the reverse directed edge
+    for (unsigned int e=0; e<edges; e++) {
+        if (bad[e] || twin[e] != NONE) continue;
+        unordered_map<uint64_t, unsigned int>::iterator r =
+            directed.find(EdgeKey(GetTarget(e), origin[e]));
+        if (r == directed.end()) continue;
+        if (bad[r->second]) { bad[e] = 1; continue; }
+        twin[e] = r->second;
+        twin[r->second] = e;
+    }
+    for (unsigned int e=0; e<edges; e++)
+        if (bad[e]) nonManifoldEdges.push_back(e);
+
+    // prefer outgoing boundary edges so rings start at the boundary
+    vector<unsigned int> degree(positions.size(), 0);
+    for (unsigned int e=0; e<edges; e++) {
+        unsigned int v = origin[e];
+        degree[v]++;
+        if (vertexEdge[v] == NONE || twin[e] == NONE)
+            vertexEdge[v] = e;
+    }
+
+    // a vertex whose ring misses some of its edges joins several fans
+    for (unsigned int v=0; v<positions.size(); v++) {
+        if (vertexEdge[v] == NONE) continue;
+        if (GetValence(v) != degree[v])
+            nonManifoldVertices.push_back(v);
+    }
+}
+
+/**
+ * Get the number of (welded) vertices.
+ */
+unsigned int HalfEdgeMesh::GetNumVertices() const {
+    return positions.size();
+}
+
+/**
+ * Get the number of faces.
+ */
+unsigned int HalfEdgeMesh::GetNumFaces() const {
+    return origin.size() / 3;
+}
+
+/**
+ * Get the number of half-edges, three per face.
+ */
+unsigned int HalfEdgeMesh::GetNumEdges() const {
+    return origin.size();
+}
+
+/**
+ * Get the position of a vertex.
+ *
+ * @param vertex Vertex index.
+ * @return Position.
+ */
+const Vector<3,float>& HalfEdgeMesh::GetPosition(unsigned int vertex) const {
+    return positions[vertex];
+}
+
+/**
+ * Get the face a mesh face was built from.
+ *
+ * @param face Face index.
+ * @return The source face, or an empty pointer if the mesh was not
+ * built from a face set.
+ */
+FacePtr HalfEdgeMesh::GetSourceFace(unsigned int face) const {
+    if (face < sources.size()) return sources[face];
+    return FacePtr();
+}
+
+/**
+ * Get a vertex of a face.
+ *
+ * @param face Face index.
+ * @param i Corner, 0 to 2.
+ * @return Vertex index.
+ */
+unsigned int HalfEdgeMesh::GetFaceVertex(unsigned int face, unsigned int i) const {
+    return origin[face * 3 + i];
+}
+
+/**
+ * Get the face sharing an edge with a face.
+ *
+ * @param face Face index.
+ * @param i Edge, 0 to 2, where edge \a i goes from corner \a i to
+ * corner \a i+1.
+ * @return Neighbor face index, or \a NONE on a boundary.
+ */
+unsigned int HalfEdgeMesh::GetNeighbor(unsigned int face, unsigned int i) const {
+    unsigned int t = twin[face * 3 + i];
+    return t == NONE ? NONE : t / 3;
+}
+
+/**
+ * Get a half-edge going out of a vertex.
+ * On boundary vertices this is the boundary half-edge.
+ *
+ * @param vertex Vertex index.
+ * @return Half-edge index, or \a NONE for unused vertices.
+ */
+unsigned int HalfEdgeMesh::GetVertexEdge(unsigned int vertex) const {
+    return vertexEdge[vertex];
+}
+
+/**
+ * Check if a vertex is on the boundary.
+ *
+ * @param vertex Vertex index.
+ * @return True if an edge of the vertex is on the boundary.
+ */
+bool HalfEdgeMesh::IsBoundaryVertex(unsigned int vertex) const {
+    unsigned int e = vertexEdge[vertex];
+    return e != NONE && twin[e] == NONE;
+}
+
+/**
+ * Get the one-ring of a vertex.
+ *
+ * @param vertex Vertex index.
+ * @return Iterator over the half-edges going out of the vertex.
+ */
+HalfEdgeMesh::RingIterator HalfEdgeMesh::GetRing(unsigned int vertex) const {
+    return RingIterator(this, vertexEdge[vertex]);
+}
+
+/**
+ * Get the number of half-edges in the one-ring of a vertex.
+ *
+ * @param vertex Vertex index.
+ * @return Valence.
+ */
+unsigned int HalfEdgeMesh::GetValence(unsigned int vertex) const {
+    unsigned int count = 0;
+    for (RingIterator itr = GetRing(vertex); itr.HasMore(); itr.Next())
+        count++;
+    return count;
+}
+
+/**
+ * Get the boundary loops of the mesh.
+ * Each loop is the list of vertices along the boundary, in the
+ * winding order of the faces. Non-manifold edges are not part of any
+ * loop.
+ *
+ * @param loops List to add the loops to.
+ */
+void HalfEdgeMesh::GetBoundaryLoops(vector<vector<unsigned int> >& loops) const {
+    unsigned int edges = origin.size();
+    vector<char> visited(edges, 0);
+    for (unsigned int i=0; i<nonManifoldEdges.size(); i++)
+        visited[nonManifoldEdges[i]] = 1;
+    for (unsigned int start=0; start<edges; start++) {
+        if (visited[start] || twin[start] != NONE) continue;
+        loops.push_back(vector<unsigned int>());
+        vector<unsigned int>& loop = loops.back();
+        unsigned int e = start;
+        while (e != NONE && !visited[e]) {
+            visited[e] = 1;
+            loop.push_back(origin[e]);
+            // rotate around the target to the next boundary edge
+            unsigned int n = GetNext(e);
+            for (unsigned int steps=0; twin[n] != NONE; steps++) {
+                if (steps == edges) { n = NONE; break; }
+                n = GetNext(twin[n]);
+            }
+            e = n;
+        }
+    }
+}
+
+/**
+ * Check if the mesh is manifold, that is, has no non-manifold edges
+ * or vertices.
+ *
+ * @return True if manifold.
+ */
+bool HalfEdgeMesh::IsManifold() const {
+    return nonManifoldEdges.empty() && nonManifoldVertices.empty();
+}
+
+/**
+ * Get the half-edges that could not be paired: edges shared by more
+ * than two faces, by faces of opposite winding, or degenerate edges.
+ *
+ * @return List of half-edge indices.
+ */
+const vector<unsigned int>& HalfEdgeMesh::GetNonManifoldEdges() const {
+    return nonManifoldEdges;
+}
+
+/**
+ * Get the vertices where several fans of faces meet.
+ *
+ * @return List of vertex indices.
+ */
+const vector<unsigned int>& HalfEdgeMesh::GetNonManifoldVertices() const {
+    return nonManifoldVertices;
+}
+
+/**
+ * Empty iterator.
+ */
+HalfEdgeMesh::RingIterator::RingIterator()
+    : mesh(NULL), first(NONE), edge(NONE) {}
+
+HalfEdgeMesh::RingIterator::RingIterator(const HalfEdgeMesh* mesh,
+                                         unsigned int edge)
+    : mesh(mesh), first(edge), edge(edge) {}
+
+/**
+ * Check if the iterator has reached the end.
+ */
+bool HalfEdgeMesh::RingIterator::HasMore() const {
+    return edge != NONE;
+}
+
+/**
+ * Advance to the next half-edge around the vertex.
+ */
+void HalfEdgeMesh::RingIterator::Next() {
+    edge = mesh->twin[mesh->GetPrev(edge)];
+    if (edge == first) edge = NONE;
+}
+
+/**
+ * Get the current half-edge, going out of the vertex.
+ */
+unsigned int HalfEdgeMesh::RingIterator::GetEdge() const {
+    return edge;
+}
+
+/**
+ * Get the neighbor vertex at the end of the current half-edge.
+ */
+unsigned int HalfEdgeMesh::RingIterator::GetVertex() const {
+    return mesh->GetTarget(edge);
+}
+
+/**
+ * Get the face of the current half-edge.
+ */
+unsigned int HalfEdgeMesh::RingIterator::GetFace() const {
+    return edge / 3;
+}
+
+} // NS Geometry
+} // NS OpenEngine
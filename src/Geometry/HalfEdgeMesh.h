@@ -0,0 +1,167 @@
+// Half-edge mesh.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_HALF_EDGE_MESH_H_
+#define _OE_HALF_EDGE_MESH_H_
+
+#include <Math/Vector.h>
+#include <Geometry/Face.h>
+#include <vector>
+
+namespace OpenEngine {
+namespace Geometry {
+
+using std::vector;
+using OpenEngine::Math::Vector;
+
+class FaceSet;
+
+/**
+ * Half-edge mesh.
+ * Triangle connectivity for adjacency queries: shared edges,
+ * neighbor faces, vertex one-rings and boundary loops. The mesh is
+ * built in linear time from a FaceSet or a triangle soup, whose
+ * vertices are welded by position, or from an indexed triangle list.
+ *
+ * Everything is stored in flat arrays and referenced by index. Face
+ * \a f consists of the half-edges \a 3f, \a 3f+1 and \a 3f+2, so the
+ * face, next and previous half-edges are computed rather than
+ * stored. Each half-edge stores its origin vertex and its twin,
+ * which is \a NONE on a boundary.
+ *
+ * @code
+ * HalfEdgeMesh mesh(faces);
+ * for (HalfEdgeMesh::RingIterator itr = mesh.GetRing(v);
+ *      itr.HasMore(); itr.Next()) {
+ *     unsigned int neighbor = itr.GetVertex();
+ *     ...
+ * }
+ * @endcode
+ *
+ * Edges shared by more than two faces, or by two faces with opposite
+ * winding, cannot be paired. Their half-edges are left as boundary
+ * and reported by \a GetNonManifoldEdges. Vertices where several fans
+ * of faces meet are reported by \a GetNonManifoldVertices, and the
+ * ring of such a vertex only covers one of the fans.
+ *
+ * @class HalfEdgeMesh HalfEdgeMesh.h Geometry/HalfEdgeMesh.h
+ */
+class HalfEdgeMesh {
+public:
+    //! Index of a missing element, such as the twin of a boundary edge.
+    static const unsigned int NONE = 0xFFFFFFFF;
+
+    /**
+     * Vertex one-ring iterator.
+     * Visits the half-edges going out of a vertex in winding order.
+     * On a boundary vertex the iteration starts and ends at the
+     * boundary.
+     */
+    class RingIterator {
+        friend class HalfEdgeMesh;
+    private:
+        const HalfEdgeMesh* mesh;
+        unsigned int first;
+        unsigned int edge;
+        RingIterator(const HalfEdgeMesh* mesh, unsigned int edge);
+    public:
+        RingIterator();
+        bool HasMore() const;
+        void Next();
+        unsigned int GetEdge() const;
+        unsigned int GetVertex() const;
+        unsigned int GetFace() const;
+    };
+
+    explicit HalfEdgeMesh(FaceSet& faces, float epsilon = 0.0f);
+    HalfEdgeMesh(const float* corners, unsigned int numFaces,
+                 float epsilon = 0.0f);
+    HalfEdgeMesh(const float* vertices, unsigned int numVertices,
+                 const unsigned int* indices, unsigned int numIndices);
+    virtual ~HalfEdgeMesh();
+
+    unsigned int GetNumVertices() const;
+    unsigned int GetNumFaces() const;
+    unsigned int GetNumEdges() const;
+
+    const Vector<3,float>& GetPosition(unsigned int vertex) const;
+    FacePtr GetSourceFace(unsigned int face) const;
+
+    /**
+     * Get the origin vertex of a half-edge.
+     */
+    inline unsigned int GetOrigin(unsigned int edge) const {
+        return origin[edge];
+    }
+    /**
+     * Get the target vertex of a half-edge.
+     */
+    inline unsigned int GetTarget(unsigned int edge) const {
+        return origin[GetNext(edge)];
+    }
+    /**
+     * Get the opposite half-edge, or \a NONE on a boundary.
+     */
+    inline unsigned int GetTwin(unsigned int edge) const {
+        return twin[edge];
+    }
+    /**
+     * Get the next half-edge of the face.
+     */
+    inline unsigned int GetNext(unsigned int edge) const {
+        return edge % 3 == 2 ? edge - 2 : edge + 1;
+    }
+    /**
+     * Get the previous half-edge of the face.
+     */
+    inline unsigned int GetPrev(unsigned int edge) const {
+        return edge % 3 == 0 ? edge + 2 : edge - 1;
+    }
+    /**
+     * Get the face of a half-edge.
+     */
+    inline unsigned int GetFace(unsigned int edge) const {
+        return edge / 3;
+    }
+    /**
+     * Check if a half-edge is on the boundary.
+     */
+    inline bool IsBoundary(unsigned int edge) const {
+        return twin[edge] == NONE;
+    }
+
+    unsigned int GetFaceVertex(unsigned int face, unsigned int i) const;
+    unsigned int GetNeighbor(unsigned int face, unsigned int i) const;
+    unsigned int GetVertexEdge(unsigned int vertex) const;
+    bool IsBoundaryVertex(unsigned int vertex) const;
+    RingIterator GetRing(unsigned int vertex) const;
+    unsigned int GetValence(unsigned int vertex) const;
+
+    void GetBoundaryLoops(vector<vector<unsigned int> >& loops) const;
+
+    bool IsManifold() const;
+    const vector<unsigned int>& GetNonManifoldEdges() const;
+    const vector<unsigned int>& GetNonManifoldVertices() const;
+
+private:
+    vector<Vector<3,float> > positions; //!< vertex positions
+    vector<unsigned int> origin;        //!< origin vertex per half-edge
+    vector<unsigned int> twin;          //!< twin per half-edge
+    vector<unsigned int> vertexEdge;    //!< an outgoing half-edge per vertex
+    vector<FacePtr> sources;            //!< faces built from, if any
+    vector<unsigned int> nonManifoldEdges;
+    vector<unsigned int> nonManifoldVertices;
+
+    void Build();
+};
+
+} // NS Geometry
+} // NS OpenEngine
+
+#endif // _OE_HALF_EDGE_MESH_H_
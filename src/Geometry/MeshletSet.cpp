@@ -0,0 +1,270 @@
+// Meshlet container.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Geometry/MeshletSet.h>
+
+#include <cmath>
+
+namespace OpenEngine {
+namespace Geometry {
+
+// cone cutoff of meshlets that can not be backface culled
+static const float NO_CONE = 2.0f;
+
+/**
+ * Split a mesh into meshlets.
+ *
+ * @param mesh Mesh to split.
+ * @param maxFaces Maximum faces per meshlet [optional].
+ * @param maxVertices Maximum vertices per meshlet, at most 256
+ * [optional].
+ */
+MeshletSet::MeshletSet(const HalfEdgeMesh& mesh, unsigned int maxFaces,
+                       unsigned int maxVertices) {
+    if (maxFaces < 1) maxFaces = 1;
+    if (maxVertices < 3) maxVertices = 3;
+    if (maxVertices > 256) maxVertices = 256;
+    Build(mesh, maxFaces, maxVertices);
+}
+
+/**
+ * Destructor.
+ */
+MeshletSet::~MeshletSet() {}
+
+/**
+ * Get the number of meshlets.
+ */
+unsigned int MeshletSet::GetNumMeshlets() const {
+    return meshlets.size();
+}
+
+/**
+ * Get a meshlet.
+ *
+ * @param i Meshlet index.
+ * @return Meshlet.
+ */
+const Meshlet& MeshletSet::GetMeshlet(unsigned int i) const {
+    return meshlets[i];
+}
+
+/**
+ * Get the mesh faces of all meshlets, meshlet by meshlet.
+ */
+const vector<unsigned int>& MeshletSet::GetFaces() const {
+    return faces;
+}
+
+/**
+ * Get the mesh vertices of all meshlets, meshlet by meshlet.
+ */
+const vector<unsigned int>& MeshletSet::GetVertices() const {
+    return vertices;
+}
+
+/**
+ * Get the face corners as indices into the vertex list of their
+ * meshlet, three per face.
+ */
+const vector<unsigned char>& MeshletSet::GetLocalIndices() const {
+    return local;
+}
+
+/**
+ * Find the meshlets that may be visible.
+ * A meshlet is culled if its bounding sphere is behind one of the
+ * planes, or if all its faces face away from the eye.
+ *
+ * @param planes Clipping planes, with normals pointing inwards.
+ * @param numPlanes Number of planes.
+ * @param eye Eye position, in the space of the mesh.
+ * @param visible List to fill with the visible meshlet indices.
+ * @return Number of visible meshlets.
+ */
+unsigned int MeshletSet::Cull(Plane* planes[], unsigned int numPlanes,
+                              const Vector<3,float>& eye,
+                              vector<unsigned int>& visible) const {
+    const unsigned int count = meshlets.size();
+    visible.clear();
+    if (count == 0) return 0;
+    vector<unsigned char> flags(count, 1);
+    unsigned char* f = &flags[0];
+    const float* x = &cx[0];
+    const float* y = &cy[0];
+    const float* z = &cz[0];
+    const float* r = &cr[0];
+
+    // plain loops over the bound arrays, so the compiler vectorizes them
+    for (unsigned int p=0; p<numPlanes; p++) {
+        const float nx = planes[p]->normal[0];
+        const float ny = planes[p]->normal[1];
+        const float nz = planes[p]->normal[2];
+        const float d = planes[p]->distance;
+        for (unsigned int i=0; i<count; i++)
+            f[i] &= x[i]*nx + y[i]*ny + z[i]*nz + d >= -r[i];
+    }
+    const float ex = eye.Get(0), ey = eye.Get(1), ez = eye.Get(2);
+    const float* a = &ax[0];
+    const float* b = &ay[0];
+    const float* c = &az[0];
+    const float* cut = &ac[0];
+    for (unsigned int i=0; i<count; i++) {
+        float dx = x[i] - ex, dy = y[i] - ey, dz = z[i] - ez;
+        float length = sqrt(dx*dx + dy*dy + dz*dz);
+        f[i] &= dx*a[i] + dy*b[i] + dz*c[i] < cut[i] * length + r[i];
+    }
+
+    for (unsigned int i=0; i<count; i++)
+        if (f[i]) visible.push_back(i);
+    return visible.size();
+}
+
+/**
+ * Grow the meshlets over the face adjacency.
+ */
+void MeshletSet::Build(const HalfEdgeMesh& mesh, unsigned int maxFaces,
+                       unsigned int maxVertices) {
+    const unsigned int NONE = HalfEdgeMesh::NONE;
+    unsigned int numFaces = mesh.GetNumFaces();
+    faces.reserve(numFaces);
+    local.reserve(numFaces * 3);
+
+    vector<Vector<3,float> > normals(numFaces);
+    for (unsigned int f=0; f<numFaces; f++) {
+        Vector<3,float> p = mesh.GetPosition(mesh.GetFaceVertex(f, 0));
+        Vector<3,float> n = (mesh.GetPosition(mesh.GetFaceVertex(f, 1)) - p) %
+                            (mesh.GetPosition(mesh.GetFaceVertex(f, 2)) - p);
+        float length = n.GetLength();
+        if (length > 0.0f) normals[f] = n / length;
+    }
+
+    vector<char> assigned(numFaces, 0);
+    vector<unsigned int> localIndex(mesh.GetNumVertices(), NONE);
+    vector<unsigned int> candidates;
+    unsigned int next = 0;              // lowest face that may be unassigned
+
+    for (;;) {
+        // seed from the frontier of the last meshlet, or in face order
+        unsigned int seed = NONE;
+        for (unsigned int i=0; i<candidates.size(); i++)
+            if (!assigned[candidates[i]]) { seed = candidates[i]; break; }
+        if (seed == NONE) {
+            while (next < numFaces && assigned[next]) next++;
+            if (next == numFaces) break;
+            seed = next;
+        }
+        candidates.clear();
+
+        Meshlet m;
+        m.firstFace = faces.size();
+        m.numFaces = 0;
+        m.firstVertex = vertices.size();
+        m.numVertices = 0;
+        Vector<3,float> sum;
+        unsigned int face = seed;
+        while (face != NONE) {
+            // add the face
+            assigned[face] = 1;
+            faces.push_back(face);
+            m.numFaces++;
+            for (unsigned int i=0; i<3; i++) {
+                unsigned int v = mesh.GetFaceVertex(face, i);
+                if (localIndex[v] == NONE) {
+                    localIndex[v] = m.numVertices++;
+                    vertices.push_back(v);
+                }
+                local.push_back(localIndex[v]);
+                unsigned int n = mesh.GetNeighbor(face, i);
+                if (n != NONE && !assigned[n]) candidates.push_back(n);
+            }
+            sum += normals[face];
+            if (m.numFaces == maxFaces) break;
+
+            // pick the candidate adding the fewest vertices and the
+            // least normal deviation
+            float length = sum.GetLength();
+            Vector<3,float> axis = length > 0.0f ? sum / length : sum;
+            float best = 0.0f;
+            face = NONE;
+            for (unsigned int i=0; i<candidates.size(); ) {
+                unsigned int c = candidates[i];
+                if (assigned[c]) {
+                    candidates[i] = candidates.back();
+                    candidates.pop_back();
+                    continue;
+                }
+                i++;
+                unsigned int added = 0;
+                for (unsigned int k=0; k<3; k++)
+                    if (localIndex[mesh.GetFaceVertex(c, k)] == NONE) added++;
+                if (m.numVertices + added > maxVertices) continue;
+                float score = added + (1.0f - normals[c] * axis);
+                if (face == NONE || score < best) {
+                    face = c;
+                    best = score;
+                }
+            }
+        }
+
+        for (unsigned int i=m.firstVertex; i<vertices.size(); i++)
+            localIndex[vertices[i]] = NONE;
+        Bound(mesh, m, normals);
+        meshlets.push_back(m);
+    }
+}
+
+/**
+ * Compute the bounding sphere and normal cone of a meshlet.
+ */
+void MeshletSet::Bound(const HalfEdgeMesh& mesh, Meshlet& m,
+                       const vector<Vector<3,float> >& normals) {
+    Vector<3,float> lo = mesh.GetPosition(vertices[m.firstVertex]);
+    Vector<3,float> hi = lo;
+    for (unsigned int i=m.firstVertex; i<m.firstVertex+m.numVertices; i++) {
+        const Vector<3,float>& p = mesh.GetPosition(vertices[i]);
+        for (int k=0; k<3; k++) {
+            if (p.Get(k) < lo[k]) lo[k] = p.Get(k);
+            if (p.Get(k) > hi[k]) hi[k] = p.Get(k);
+        }
+    }
+    m.center = (lo + hi) * 0.5f;
+    m.radius = 0.0f;
+    for (unsigned int i=m.firstVertex; i<m.firstVertex+m.numVertices; i++) {
+        float d = (mesh.GetPosition(vertices[i]) - m.center).GetLength();
+        if (d > m.radius) m.radius = d;
+    }
+
+    Vector<3,float> sum;
+    for (unsigned int i=m.firstFace; i<m.firstFace+m.numFaces; i++)
+        sum += normals[faces[i]];
+    float length = sum.GetLength();
+    m.coneCutoff = NO_CONE;
+    if (length > 0.0f) {
+        m.coneAxis = sum / length;
+        float spread = 1.0f;
+        for (unsigned int i=m.firstFace; i<m.firstFace+m.numFaces; i++) {
+            float d = normals[faces[i]] * m.coneAxis;
+            if (d < spread) spread = d;
+        }
+        if (spread > 0.0f) m.coneCutoff = sqrt(1.0f - spread * spread);
+    }
+
+    cx.push_back(m.center[0]);
+    cy.push_back(m.center[1]);
+    cz.push_back(m.center[2]);
+    cr.push_back(m.radius);
+    ax.push_back(m.coneAxis[0]);
+    ay.push_back(m.coneAxis[1]);
+    az.push_back(m.coneAxis[2]);
+    ac.push_back(m.coneCutoff);
+}
+
+} // NS Geometry
+} // NS OpenEngine
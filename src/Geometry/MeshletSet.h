@@ -0,0 +1,106 @@
+// Meshlet container.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_MESHLET_SET_H_
+#define _OE_MESHLET_SET_H_
+
+#include <Geometry/HalfEdgeMesh.h>
+#include <Geometry/Plane.h>
+#include <Math/Vector.h>
+#include <vector>
+
+namespace OpenEngine {
+namespace Geometry {
+
+using std::vector;
+using OpenEngine::Math::Vector;
+
+/**
+ * Meshlet.
+ * A small cluster of connected faces with its own vertex list and
+ * bounds. The faces of meshlet \a m are
+ * \a GetFaces()[firstFace .. firstFace+numFaces) and its vertices
+ * \a GetVertices()[firstVertex .. firstVertex+numVertices), which the
+ * local indices \a GetLocalIndices()[firstFace*3 ..] refer to.
+ */
+struct Meshlet {
+    unsigned int firstFace;
+    unsigned int numFaces;
+    unsigned int firstVertex;
+    unsigned int numVertices;
+    Vector<3,float> center;     //!< bounding sphere center
+    float radius;               //!< bounding sphere radius
+    Vector<3,float> coneAxis;   //!< average face normal
+    float coneCutoff;           //!< sine of the normal spread, above one if none
+};
+
+/**
+ * Meshlet container.
+ * Splits a mesh into meshlets of connected faces, each with at most
+ * a given number of faces and vertices (64 to 128 are typical), so
+ * large meshes can be culled and submitted a cluster at a time.
+ *
+ * Each meshlet has a bounding sphere for frustum culling and a normal
+ * cone for backface culling: when the eye is behind every face of
+ * the meshlet the whole meshlet is skipped.
+ *
+ * @code
+ * HalfEdgeMesh mesh(faces);
+ * MeshletSet meshlets(mesh, 64, 64);
+ * vector<unsigned int> visible;
+ * meshlets.Cull(planes, 6, eye, visible);
+ * for (unsigned int i=0; i<visible.size(); i++) {
+ *     const Meshlet& m = meshlets.GetMeshlet(visible[i]);
+ *     ... // submit the faces of m
+ * }
+ * @endcode
+ *
+ * Faces are grown from a seed face over shared edges, preferring
+ * faces that add the fewest new vertices and bend the least away from
+ * the meshlet normal, which keeps the normal cones narrow.
+ *
+ * @class MeshletSet MeshletSet.h Geometry/MeshletSet.h
+ */
+class MeshletSet {
+public:
+    MeshletSet(const HalfEdgeMesh& mesh, unsigned int maxFaces = 64,
+               unsigned int maxVertices = 64);
+    virtual ~MeshletSet();
+
+    unsigned int GetNumMeshlets() const;
+    const Meshlet& GetMeshlet(unsigned int i) const;
+
+    const vector<unsigned int>& GetFaces() const;
+    const vector<unsigned int>& GetVertices() const;
+    const vector<unsigned char>& GetLocalIndices() const;
+
+    unsigned int Cull(Plane* planes[], unsigned int numPlanes,
+                      const Vector<3,float>& eye,
+                      vector<unsigned int>& visible) const;
+
+private:
+    vector<Meshlet> meshlets;
+    vector<unsigned int> faces;         //!< mesh faces by meshlet
+    vector<unsigned int> vertices;      //!< mesh vertices by meshlet
+    vector<unsigned char> local;        //!< local corner indices by meshlet
+
+    // bounds by component, for the culling loop
+    vector<float> cx, cy, cz, cr;
+    vector<float> ax, ay, az, ac;
+
+    void Build(const HalfEdgeMesh& mesh, unsigned int maxFaces,
+               unsigned int maxVertices);
+    void Bound(const HalfEdgeMesh& mesh, Meshlet& m,
+               const vector<Vector<3,float> >& normals);
+};
+
+} // NS Geometry
+} // NS OpenEngine
+
+#endif // _OE_MESHLET_SET_H_
@@ -0,0 +1,367 @@
+// Smooth normal and tangent space generator.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Geometry/NormalGenerator.h>
+#include <Geometry/FaceSet.h>
+#include <Geometry/VertexArray.h>
+
+#include <cmath>
+#include <algorithm>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+namespace OpenEngine {
+namespace Geometry {
+
+// elements per thread below which a pass is not split
+static const unsigned int PARALLEL_GRAIN = 4096;
+
+/**
+ * Create a generator.
+ *
+ * @param smoothingAngle Largest angle in radians between two faces
+ * that are smoothed together [optional].
+ * @param weighting Weighting of the faces [optional].
+ */
+NormalGenerator::NormalGenerator(float smoothingAngle, Weighting weighting)
+    : smoothingAngle(smoothingAngle), weighting(weighting)
+    , threads(boost::thread::hardware_concurrency())
+    , mesh(NULL), texc(NULL), norm(NULL), tang(NULL), bino(NULL) {}
+
+/**
+ * Destructor.
+ */
+NormalGenerator::~NormalGenerator() {}
+
+/**
+ * Set the smoothing angle.
+ * Faces meeting at a larger angle are not smoothed together. An
+ * angle of \a PI or more smooths all faces of a vertex.
+ *
+ * @param angle Angle in radians.
+ */
+void NormalGenerator::SetSmoothingAngle(float angle) {
+    smoothingAngle = angle;
+}
+
+/**
+ * Get the smoothing angle.
+ *
+ * @return Angle in radians.
+ */
+float NormalGenerator::GetSmoothingAngle() const {
+    return smoothingAngle;
+}
+
+/**
+ * Set the weighting of the faces.
+ *
+ * @param weighting Weighting.
+ */
+void NormalGenerator::SetWeighting(Weighting weighting) {
+    this->weighting = weighting;
+}
+
+/**
+ * Get the weighting of the faces.
+ *
+ * @return Weighting.
+ */
+NormalGenerator::Weighting NormalGenerator::GetWeighting() const {
+    return weighting;
+}
+
+/**
+ * Set the number of threads to use.
+ * Defaults to the number of cores.
+ *
+ * @param threads Thread count, 1 to generate on the calling thread.
+ */
+void NormalGenerator::SetThreads(unsigned int threads) {
+    this->threads = threads;
+}
+
+/**
+ * Generate the normals, tangents and binormals of a face set.
+ *
+ * @param faces Faces to update.
+ * @param epsilon Welding distance of the vertices [optional].
+ */
+void NormalGenerator::Generate(FaceSet& faces, float epsilon) {
+    HalfEdgeMesh mesh(faces, epsilon);
+    unsigned int size = mesh.GetNumFaces();
+    vector<float> t(size * 3 * 2);
+    vector<float> n(size * 3 * 3), tg(size * 3 * 3), b(size * 3 * 3);
+    unsigned int c = 0;
+    for (FaceList::iterator itr = faces.begin(); itr != faces.end(); itr++) {
+        FacePtr face = *itr;
+        for (int i=0; i<3; i++, c++) {
+            for (int k=0; k<2; k++) t[c*2+k] = face->texc[i][k];
+            for (int k=0; k<3; k++) {
+                n[c*3+k]  = face->norm[i][k];
+                tg[c*3+k] = face->tang[i][k];
+                b[c*3+k]  = face->bino[i][k];
+            }
+        }
+    }
+    if (size == 0) return;
+    Generate(mesh, &t[0], &n[0], &tg[0], &b[0]);
+    c = 0;
+    for (FaceList::iterator itr = faces.begin(); itr != faces.end(); itr++) {
+        FacePtr face = *itr;
+        for (int i=0; i<3; i++, c++) {
+            face->norm[i] = Vector<3,float>(n[c*3], n[c*3+1], n[c*3+2]);
+            face->tang[i] = Vector<3,float>(tg[c*3], tg[c*3+1], tg[c*3+2]);
+            face->bino[i] = Vector<3,float>(b[c*3], b[c*3+1], b[c*3+2]);
+        }
+    }
+}
+
+/**
+ * Generate the normals of a vertex array.
+ * Vertex arrays hold no tangents, so only the normals are written.
+ * Normals are added to arrays without them.
+ *
+ * @param va Vertex array to update.
+ * @param epsilon Welding distance of the vertices [optional].
+ */
+void NormalGenerator::Generate(VertexArray& va, float epsilon) {
+    unsigned int size = va.GetNumFaces();
+    int attributes = va.GetAttributes();
+    if (size == 0 || !(attributes & VertexArray::VERTICES)) return;
+    // copy out tight arrays, the array may be interleaved or packed
+    vector<float> v(size * 3 * 3), n(size * 3 * 3), t;
+    va.GetAttribute(VertexArray::VERTICES, &v[0]);
+    if (attributes & VertexArray::NORMALS)
+        va.GetAttribute(VertexArray::NORMALS, &n[0]);
+    if (attributes & VertexArray::TEXCOORDS) {
+        t.resize(size * 3 * 2);
+        va.GetAttribute(VertexArray::TEXCOORDS, &t[0]);
+    }
+    HalfEdgeMesh mesh(&v[0], size, epsilon);
+    Generate(mesh, t.empty() ? NULL : &t[0], &n[0]);
+    va.SetAttribute(VertexArray::NORMALS, &n[0]);
+}
+
+/**
+ * Generate the corner normals and tangent space of a mesh.
+ * All arrays hold one entry per face corner, in the face order of the
+ * mesh. Corners that get no contribution, such as the corners of
+ * degenerate faces, are left unchanged.
+ *
+ * @param mesh Welded mesh.
+ * @param texc Texture coordinates, two floats per corner, or NULL.
+ * @param norm Normals to write, three floats per corner.
+ * @param tang Tangents to write, or NULL [optional].
+ * @param bino Binormals to write, or NULL [optional].
+ */
+void NormalGenerator::Generate(const HalfEdgeMesh& mesh, const float* texc,
+                               float* norm, float* tang, float* bino) {
+    // the passes index the corner arrays directly
+    if (mesh.GetNumFaces() == 0) return;
+    this->mesh = &mesh;
+    this->texc = texc;
+    this->norm = norm;
+    this->tang = texc ? tang : NULL;
+    this->bino = texc ? bino : NULL;
+
+    unsigned int faces = mesh.GetNumFaces();
+    unsigned int vertices = mesh.GetNumVertices();
+    faceNorm.resize(faces);
+    faceTang.resize(this->tang ? faces : 0);
+    faceBino.resize(this->bino ? faces : 0);
+    weight.resize(faces * 3);
+    Run(&NormalGenerator::FacePass, faces);
+
+    // group the corners by vertex (counting sort)
+    first.assign(vertices + 1, 0);
+    corners.resize(faces * 3);
+    for (unsigned int c=0; c<faces*3; c++)
+        first[mesh.GetOrigin(c) + 1]++;
+    for (unsigned int v=0; v<vertices; v++)
+        first[v + 1] += first[v];
+    vector<unsigned int> fill(first.begin(), first.end() - 1);
+    for (unsigned int c=0; c<faces*3; c++)
+        corners[fill[mesh.GetOrigin(c)]++] = c;
+
+    wedge.assign(faces * 3, HalfEdgeMesh::NONE);
+    Run(&NormalGenerator::VertexPass, vertices);
+    this->mesh = NULL;
+}
+
+/**
+ * Run a pass over [0, count), split over the threads.
+ */
+void NormalGenerator::Run(void (NormalGenerator::*pass)(unsigned int, unsigned int),
+                          unsigned int count) {
+    unsigned int n = threads;
+    if (n > count / PARALLEL_GRAIN) n = count / PARALLEL_GRAIN;
+    if (n < 2) {
+        (this->*pass)(0, count);
+        return;
+    }
+    boost::thread_group group;
+    unsigned int chunk = (count + n - 1) / n;
+    for (unsigned int i=1; i<n; i++) {
+        unsigned int end = (i + 1) * chunk < count ? (i + 1) * chunk : count;
+        group.create_thread(boost::bind(pass, this, i * chunk, end));
+    }
+    (this->*pass)(0, chunk);
+    group.join_all();
+}
+
+/**
+ * Compute the unit normal, corner weights and tangents of faces.
+ */
+void NormalGenerator::FacePass(unsigned int begin, unsigned int end) {
+    for (unsigned int f=begin; f<end; f++) {
+        Vector<3,float> p[3];
+        for (int i=0; i<3; i++)
+            p[i] = mesh->GetPosition(mesh->GetFaceVertex(f, i));
+        Vector<3,float> n = (p[1] - p[0]) % (p[2] - p[0]);
+        float length = n.GetLength();
+        faceNorm[f] = length > 0.0f ? n / length : Vector<3,float>();
+
+        for (int i=0; i<3; i++) {
+            float w = length * 0.5f;
+            if (weighting == ANGLE_WEIGHTED) {
+                Vector<3,float> e1 = p[(i+1)%3] - p[i];
+                Vector<3,float> e2 = p[(i+2)%3] - p[i];
+                float l = e1.GetLength() * e2.GetLength();
+                float cosine = l > 0.0f ? (e1 * e2) / l : 1.0f;
+                if (cosine > 1.0f) cosine = 1.0f;
+                if (cosine < -1.0f) cosine = -1.0f;
+                w = acos(cosine);
+            }
+            weight[f*3+i] = w;
+        }
+
+        if (!tang) continue;
+        // same derivation as Face::CalcTangentSpace
+        const float* t = texc + f * 3 * 2;
+        float u12u = t[2] - t[0], u12v = t[3] - t[1];
+        float u13u = t[4] - t[0], u13v = t[5] - t[1];
+        float det = u12u * u13v - u13u * u12v;
+        Vector<3,float> s, r;
+        if (det != 0.0f) {
+            Vector<3,float> v12 = p[1] - p[0];
+            Vector<3,float> v13 = p[2] - p[0];
+            s = (u13v * v12 - u12v * v13) / det;
+            r = (u12u * v13 - u13u * v12) / det;
+            if (s.GetLength() > 0.0f) s.Normalize();
+            if (r.GetLength() > 0.0f) r.Normalize();
+        }
+        faceTang[f] = s;
+        if (bino) faceBino[f] = r;
+    }
+}
+
+// orders the corners of a vertex by wedge and texture coordinate
+struct TangentOrder {
+    const unsigned int* wedge;
+    const float* texc;
+    bool operator()(unsigned int a, unsigned int b) const {
+        if (wedge[a] != wedge[b]) return wedge[a] < wedge[b];
+        if (texc[a*2] != texc[b*2]) return texc[a*2] < texc[b*2];
+        return texc[a*2+1] < texc[b*2+1];
+    }
+};
+
+/**
+ * Gather the contributions of the faces around each vertex into the
+ * corners of the vertex.
+ *
+ * The corners are numbered by wedge in one walk around each fan, and
+ * the normals summed per wedge. For tangents the corners are sorted
+ * by wedge and texture coordinate and summed per run.
+ */
+void NormalGenerator::VertexPass(unsigned int begin, unsigned int end) {
+    const float limit = smoothingAngle >= Math::PI ? -2.0f : cos(smoothingAngle);
+    const unsigned int NONE = HalfEdgeMesh::NONE;
+    vector<Vector<3,float> > sum;
+    vector<unsigned int> order;
+    TangentOrder less = { &wedge[0], texc };
+    for (unsigned int v=begin; v<end; v++) {
+        // number the wedges, walking each fan from a hard edge or the
+        // boundary through the soft edges
+        unsigned int wedges = 0;
+        for (unsigned int i=first[v]; i<first[v+1]; i++) {
+            unsigned int c = corners[i];
+            if (wedge[c] != NONE) continue;
+            unsigned int s = c;
+            for (;;) {
+                unsigned int p = mesh->GetTwin(mesh->GetPrev(s));
+                if (p == NONE || p == c || wedge[p] != NONE) break;
+                if (faceNorm[s/3] * faceNorm[p/3] < limit) break;
+                s = p;
+            }
+            for (;;) {
+                wedge[s] = wedges;
+                unsigned int q = mesh->GetTwin(s);
+                if (q == NONE) break;
+                q = mesh->GetNext(q);
+                if (wedge[q] != NONE) break;
+                if (faceNorm[s/3] * faceNorm[q/3] < limit) break;
+                s = q;
+            }
+            wedges++;
+        }
+
+        // normals
+        sum.assign(wedges, Vector<3,float>());
+        for (unsigned int i=first[v]; i<first[v+1]; i++) {
+            unsigned int c = corners[i];
+            sum[wedge[c]] += faceNorm[c/3] * weight[c];
+        }
+        for (unsigned int k=0; k<wedges; k++) {
+            float length = sum[k].GetLength();
+            if (length > 0.0f) sum[k] /= length;
+        }
+        for (unsigned int i=first[v]; i<first[v+1]; i++) {
+            unsigned int c = corners[i];
+            Vector<3,float>& n = sum[wedge[c]];
+            if (n.GetLength() == 0.0f) continue;
+            for (int k=0; k<3; k++) norm[c*3+k] = n[k];
+        }
+        if (!tang) continue;
+
+        // tangents, per run of the same wedge and texture coordinate
+        order.assign(corners.begin() + first[v], corners.begin() + first[v+1]);
+        std::sort(order.begin(), order.end(), less);
+        for (unsigned int i=0; i<order.size(); ) {
+            unsigned int j = i;
+            Vector<3,float> t, b;
+            for (; j<order.size() && !less(order[i], order[j]); j++) {
+                unsigned int o = order[j];
+                t += faceTang[o/3] * weight[o];
+                if (bino) b += faceBino[o/3] * weight[o];
+            }
+            Vector<3,float>& n = sum[wedge[order[i]]];
+            if (n.GetLength() > 0.0f) {
+                // orthogonalize against the normal (and the tangent)
+                t = t - n * (n * t);
+                if (t.GetLength() > 0.0f) t.Normalize();
+                b = b - n * (n * b);
+                b = b - t * (t * b);
+                if (b.GetLength() > 0.0f) b.Normalize();
+                for (unsigned int k=i; k<j; k++) {
+                    unsigned int c = order[k];
+                    if (t.GetLength() > 0.0f)
+                        for (int l=0; l<3; l++) tang[c*3+l] = t[l];
+                    if (bino && b.GetLength() > 0.0f)
+                        for (int l=0; l<3; l++) bino[c*3+l] = b[l];
+                }
+            }
+            i = j;
+        }
+    }
+}
+
+} // NS Geometry
+} // NS OpenEngine
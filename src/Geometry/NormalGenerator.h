@@ -0,0 +1,108 @@
+// Smooth normal and tangent space generator.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_NORMAL_GENERATOR_H_
+#define _OE_NORMAL_GENERATOR_H_
+
+#include <Geometry/HalfEdgeMesh.h>
+#include <Math/Vector.h>
+#include <Math/Math.h>
+#include <vector>
+
+namespace OpenEngine {
+namespace Geometry {
+
+using std::vector;
+using OpenEngine::Math::Vector;
+
+class FaceSet;
+class VertexArray;
+
+/**
+ * Smooth normal and tangent space generator.
+ * Computes the normals, tangents and binormals of all face corners in
+ * one pass, averaging over the faces that share a vertex instead of
+ * using each face on its own as \a Face::CalcTangentSpace does.
+ *
+ * The faces around a welded vertex are split into wedges at the hard
+ * edges, the edges whose faces differ by more than the smoothing
+ * angle, and the corners of a wedge share one normal. Hard edges
+ * thus stay hard, at a cost linear in the valence of the vertex.
+ * Where several fans of faces meet at a non-manifold vertex each fan
+ * is smoothed on its own. Tangents are additionally only shared
+ * between corners with the same texture coordinate, so they are split
+ * along texture seams. Contributions are weighted by face area or by
+ * the corner angle.
+ *
+ * @code
+ * NormalGenerator gen(PI / 3);   // smooth up to 60 degrees
+ * gen.Generate(faces);           // writes norm, tang and bino
+ * @endcode
+ *
+ * The work is done in two gathering passes, first over faces and
+ * then over vertices, in which every corner is written by exactly one
+ * thread. Large meshes are split over the available cores.
+ *
+ * @class NormalGenerator NormalGenerator.h Geometry/NormalGenerator.h
+ */
+class NormalGenerator {
+public:
+
+    /**
+     * Weighting of the face contributions.
+     */
+    enum Weighting {
+        AREA_WEIGHTED,          //!< by face area
+        ANGLE_WEIGHTED          //!< by corner angle
+    };
+
+    NormalGenerator(float smoothingAngle = Math::PI,
+                    Weighting weighting = ANGLE_WEIGHTED);
+    virtual ~NormalGenerator();
+
+    void SetSmoothingAngle(float angle);
+    float GetSmoothingAngle() const;
+    void SetWeighting(Weighting weighting);
+    Weighting GetWeighting() const;
+    void SetThreads(unsigned int threads);
+
+    void Generate(FaceSet& faces, float epsilon = 0.0f);
+    void Generate(VertexArray& va, float epsilon = 0.0f);
+    void Generate(const HalfEdgeMesh& mesh, const float* texc,
+                  float* norm, float* tang = NULL, float* bino = NULL);
+
+private:
+    float smoothingAngle;
+    Weighting weighting;
+    unsigned int threads;
+
+    // state of the current generation, shared by the passes
+    const HalfEdgeMesh* mesh;
+    const float* texc;
+    float* norm;
+    float* tang;
+    float* bino;
+    vector<Vector<3,float> > faceNorm;  //!< unit normal per face
+    vector<Vector<3,float> > faceTang;  //!< tangent per face
+    vector<Vector<3,float> > faceBino;  //!< binormal per face
+    vector<float> weight;               //!< weight per corner
+    vector<unsigned int> first;         //!< first corner per vertex
+    vector<unsigned int> corners;       //!< corners grouped by vertex
+    vector<unsigned int> wedge;         //!< wedge of each corner at its vertex
+
+    void Run(void (NormalGenerator::*pass)(unsigned int, unsigned int),
+             unsigned int count);
+    void FacePass(unsigned int begin, unsigned int end);
+    void VertexPass(unsigned int begin, unsigned int end);
+};
+
+} // NS Geometry
+} // NS OpenEngine
+
+#endif // _OE_NORMAL_GENERATOR_H_
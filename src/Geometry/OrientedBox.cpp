@@ -0,0 +1,224 @@
+// Oriented box.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Geometry/OrientedBox.h>
+#include <Geometry/Box.h>
+#include <Geometry/Line.h>
+#include <Geometry/Plane.h>
+#include <Scene/TransformationNode.h>
+
+#include <cmath>
+
+namespace OpenEngine {
+namespace Geometry {
+
+// added to the absolute rotation terms so that parallel edges, whose
+// cross product is near zero, do not give false separations
+static const float PARALLEL_EPSILON = 1e-6f;
+
+/**
+ * Create an empty box at the origin.
+ */
+OrientedBox::OrientedBox() {
+    for (int i=0; i<3; i++) axes[i][i] = 1;
+}
+
+/**
+ * Create an oriented box.
+ *
+ * @param center Center of the box.
+ * @param rotation Rotation of the box axes.
+ * @param extent Half size along each axis.
+ */
+OrientedBox::OrientedBox(const Vector<3,float> center,
+                         const Quaternion<float> rotation,
+                         const Vector<3,float> extent)
+    : center(center), extent(extent) {
+    for (int i=0; i<3; i++) {
+        Vector<3,float> axis;
+        axis[i] = 1;
+        axes[i] = rotation.RotateVector(axis);
+    }
+}
+
+/**
+ * Create an oriented box from an axis aligned box.
+ *
+ * @param box Box to copy.
+ */
+OrientedBox::OrientedBox(const Box& box)
+    : center(box.GetCenter()), extent(box.GetCorner()) {
+    for (int i=0; i<3; i++) axes[i][i] = 1;
+}
+
+/**
+ * Create an oriented box from a box in a local space.
+ *
+ * @param box Box in the local space.
+ * @param position Position of the local space.
+ * @param rotation Rotation of the local space.
+ */
+OrientedBox::OrientedBox(const Box& box, const Vector<3,float> position,
+                         const Quaternion<float> rotation)
+    : extent(box.GetCorner()) {
+    center = position + rotation.RotateVector(box.GetCenter());
+    for (int i=0; i<3; i++) {
+        Vector<3,float> axis;
+        axis[i] = 1;
+        axes[i] = rotation.RotateVector(axis);
+    }
+}
+
+/**
+ * Create an oriented box from a box in the space of a transformation
+ * node. The accumulated position and rotation of the node are used;
+ * scaling is not.
+ *
+ * @param box Box in the space of the node.
+ * @param node Transformation node.
+ */
+OrientedBox::OrientedBox(const Box& box, Scene::TransformationNode& node)
+    : extent(box.GetCorner()) {
+    Vector<3,float> position;
+    Quaternion<float> rotation;
+    node.GetAccumulatedTransformations(&position, &rotation);
+    center = position + rotation.RotateVector(box.GetCenter());
+    for (int i=0; i<3; i++) {
+        Vector<3,float> axis;
+        axis[i] = 1;
+        axes[i] = rotation.RotateVector(axis);
+    }
+}
+
+/**
+ * Get the center of the box.
+ *
+ * @return Center of the box.
+ */
+Vector<3,float> OrientedBox::GetCenter() const {
+    return center;
+}
+
+/**
+ * Get an axis of the box.
+ *
+ * @param index Axis index, 0 to 2.
+ * @return Unit axis.
+ */
+Vector<3,float> OrientedBox::GetAxis(const int index) const {
+    return axes[index];
+}
+
+/**
+ * Get the half size of the box along its axes.
+ *
+ * @return Half sizes.
+ */
+Vector<3,float> OrientedBox::GetExtent() const {
+    return extent;
+}
+
+/**
+ * Check if a point is inside the box.
+ *
+ * @param point Point to test.
+ * @return True if the point is inside, false otherwise.
+ */
+bool OrientedBox::Intersects(const Vector<3,float> point) const {
+    Vector<3,float> d = point - center;
+    for (int i=0; i<3; i++)
+        if (fabs(d * axes[i]) > extent.Get(i)) return false;
+    return true;
+}
+
+/**
+ * Check if a line segment intersects the box.
+ * The segment is moved to the space of the box and tested against
+ * the box there.
+ *
+ * @param line Line segment to test.
+ * @return True if part of the segment is inside, false otherwise.
+ */
+bool OrientedBox::Intersects(const Line line) const {
+    Vector<3,float> p1 = line.point1 - center;
+    Vector<3,float> p2 = line.point2 - center;
+    Line local(Vector<3,float>(p1 * axes[0], p1 * axes[1], p1 * axes[2]),
+               Vector<3,float>(p2 * axes[0], p2 * axes[1], p2 * axes[2]));
+    return Box(-extent, extent).Intersects(local);
+}
+
+/**
+ * Check if a plane intersects the box.
+ *
+ * @param plane Plane to test.
+ * @return True if the plane cuts the box, false otherwise.
+ */
+bool OrientedBox::Intersects(const Plane plane) const {
+    float r = 0;
+    for (int i=0; i<3; i++)
+        r += extent.Get(i) * fabs(plane.normal * axes[i]);
+    return fabs(plane.normal * center + plane.distance) <= r;
+}
+
+/**
+ * Check if two oriented boxes intersect.
+ * The boxes are disjoint if their projections are disjoint on one of
+ * the three axes of each box or the nine cross products of an axis
+ * of each.
+ *
+ * @param box Box to test.
+ * @return True if the boxes intersect, false otherwise.
+ */
+bool OrientedBox::Intersects(const OrientedBox& box) const {
+    const float a[3] = {extent.Get(0), extent.Get(1), extent.Get(2)};
+    const float b[3] = {box.extent.Get(0), box.extent.Get(1), box.extent.Get(2)};
+    float r[3][3], absR[3][3], t[3];
+    Vector<3,float> d = box.center - center;
+    for (int i=0; i<3; i++) {
+        t[i] = d * axes[i];
+        for (int j=0; j<3; j++) {
+            r[i][j] = axes[i] * box.axes[j];
+            absR[i][j] = fabs(r[i][j]) + PARALLEL_EPSILON;
+        }
+    }
+    // the axes of this box
+    for (int i=0; i<3; i++)
+        if (fabs(t[i]) > a[i] + b[0]*absR[i][0] + b[1]*absR[i][1] + b[2]*absR[i][2])
+            return false;
+    // the axes of the other box
+    for (int j=0; j<3; j++)
+        if (fabs(t[0]*r[0][j] + t[1]*r[1][j] + t[2]*r[2][j]) >
+            a[0]*absR[0][j] + a[1]*absR[1][j] + a[2]*absR[2][j] + b[j])
+            return false;
+    // the cross products
+    for (int i=0; i<3; i++) {
+        int i1 = (i + 1) % 3, i2 = (i + 2) % 3;
+        for (int j=0; j<3; j++) {
+            int j1 = (j + 1) % 3, j2 = (j + 2) % 3;
+            float ra = a[i1] * absR[i2][j] + a[i2] * absR[i1][j];
+            float rb = b[j1] * absR[i][j2] + b[j2] * absR[i][j1];
+            if (fabs(t[i2] * r[i1][j] - t[i1] * r[i2][j]) > ra + rb)
+                return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Check if an axis aligned box intersects the box.
+ *
+ * @param box Box to test.
+ * @return True if the boxes intersect, false otherwise.
+ */
+bool OrientedBox::Intersects(const Box& box) const {
+    return Intersects(OrientedBox(box));
+}
+
+} // NS Geometry
+} // NS OpenEngine
@@ -0,0 +1,70 @@
+// Oriented box.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_ORIENTED_BOX_H_
+#define _OE_ORIENTED_BOX_H_
+
+#include <Geometry/BoundingGeometry.h>
+#include <Math/Quaternion.h>
+
+namespace OpenEngine {
+
+// forward declarations
+namespace Scene { class TransformationNode; }
+
+namespace Geometry {
+
+class Box;
+
+using OpenEngine::Math::Vector;
+using OpenEngine::Math::Quaternion;
+
+/**
+ * Oriented bounding box.
+ * A box given by its center, three orthonormal axes and the half
+ * size along each axis. Oriented boxes are usually made from a box
+ * in the local space of a transformation node:
+ * @code
+ * OrientedBox obb(Box(*faces), *transformationNode);
+ * @endcode
+ * Intersections between oriented boxes use the separating axis test
+ * over the 15 candidate axes [Gottschalk 96].
+ *
+ * @class OrientedBox OrientedBox.h Geometry/OrientedBox.h
+ */
+class OrientedBox : public BoundingGeometry {
+private:
+    Vector<3,float> center;     //!< Box center
+    Vector<3,float> axes[3];    //!< Unit axes of the box
+    Vector<3,float> extent;     //!< Half size along each axis
+
+public:
+    OrientedBox();
+    OrientedBox(const Vector<3,float> center, const Quaternion<float> rotation,
+                const Vector<3,float> extent);
+    explicit OrientedBox(const Box& box);
+    OrientedBox(const Box& box, const Vector<3,float> position,
+                const Quaternion<float> rotation);
+    OrientedBox(const Box& box, Scene::TransformationNode& node);
+
+    Vector<3,float> GetCenter() const;
+    Vector<3,float> GetAxis(const int index) const;
+    Vector<3,float> GetExtent() const;
+
+    bool Intersects(const Vector<3,float> point) const;
+    bool Intersects(const Line line) const;
+    bool Intersects(const Plane plane) const;
+    bool Intersects(const OrientedBox& box) const;
+    bool Intersects(const Box& box) const;
+};
+
+} // NS Geometry
+} // NS OpenEngine
+
+#endif // _OE_ORIENTED_BOX_H_
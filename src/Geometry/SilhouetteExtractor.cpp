@@ -0,0 +1,194 @@
+// Silhouette extractor.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Geometry/SilhouetteExtractor.h>
+
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+namespace OpenEngine {
+namespace Geometry {
+
+// faces times lights below which extraction is not worth a thread
+static const unsigned int PARALLEL_THRESHOLD = 1 << 16;
+
+/**
+ * Create an extractor for a mesh.
+ * The face planes are computed immediately. The mesh must outlive
+ * the extractor.
+ *
+ * @param mesh Mesh to extract silhouettes from.
+ */
+SilhouetteExtractor::SilhouetteExtractor(const HalfEdgeMesh& mesh)
+    : mesh(mesh), revision(0) {
+    Update();
+}
+
+/**
+ * Destructor.
+ */
+SilhouetteExtractor::~SilhouetteExtractor() {}
+
+/**
+ * Recompute the face planes and invalidate all cached silhouettes.
+ * Must be called when the faces the mesh was built from have moved.
+ * The normals are the hard normals of the source faces when the
+ * mesh was built from a face set, and are computed from the vertex
+ * positions otherwise.
+ */
+void SilhouetteExtractor::Update() {
+    unsigned int faces = mesh.GetNumFaces();
+    nx.resize(faces); ny.resize(faces); nz.resize(faces); nd.resize(faces);
+    for (unsigned int f=0; f<faces; f++) {
+        Vector<3,float> n, p;
+        FacePtr face = mesh.GetSourceFace(f);
+        if (face) {
+            n = face->hardNorm;
+            p = face->vert[0];
+        } else {
+            p = mesh.GetPosition(mesh.GetFaceVertex(f, 0));
+            Vector<3,float> u = mesh.GetPosition(mesh.GetFaceVertex(f, 1)) - p;
+            Vector<3,float> v = mesh.GetPosition(mesh.GetFaceVertex(f, 2)) - p;
+            n = u % v;
+        }
+        nx[f] = n[0];
+        ny[f] = n[1];
+        nz[f] = n[2];
+        nd[f] = n * p;
+    }
+    revision++;
+}
+
+/**
+ * Get the silhouette from a single light.
+ *
+ * @param light Homogeneous light position in object space.
+ * @param slot Cache slot of the light.
+ * @return Silhouette half-edges.
+ */
+const vector<unsigned int>& SilhouetteExtractor::Extract(const Vector<4,float>& light,
+                                                         unsigned int slot) {
+    if (slot >= slots.size()) Resize(slot + 1);
+    Slot& s = slots[slot];
+    if (s.revision != revision || !(s.light == light))
+        Compute(s, light);
+    return s.edges;
+}
+
+/**
+ * Get the silhouettes from a set of lights.
+ * Light \a i uses cache slot \a i. Lights that have moved are
+ * extracted in parallel when there is enough work to share.
+ *
+ * @param lights Homogeneous light positions in object space.
+ */
+void SilhouetteExtractor::Extract(const vector<Vector<4,float> >& lights) {
+    if (slots.size() < lights.size()) Resize(lights.size());
+    unsigned int stale = 0;
+    for (unsigned int i=0; i<lights.size(); i++)
+        if (slots[i].revision != revision || !(slots[i].light == lights[i]))
+            stale++;
+    if (stale == 0) return;
+
+    unsigned int threads = boost::thread::hardware_concurrency();
+    if (threads > stale) threads = stale;
+    if (threads < 2 || stale * mesh.GetNumFaces() < PARALLEL_THRESHOLD) {
+        ComputeRange(&lights, 0, 1);
+        return;
+    }
+    boost::thread_group group;
+    for (unsigned int t=1; t<threads; t++)
+        group.create_thread(boost::bind(&SilhouetteExtractor::ComputeRange,
+                                        this, &lights, t, threads));
+    ComputeRange(&lights, 0, threads);
+    group.join_all();
+}
+
+/**
+ * Get the last silhouette extracted in a slot.
+ *
+ * @param slot Cache slot.
+ * @return Silhouette half-edges.
+ */
+const vector<unsigned int>& SilhouetteExtractor::GetSilhouette(unsigned int slot) const {
+    return slots[slot].edges;
+}
+
+/**
+ * Get the face classification of the last extraction in a slot.
+ * Useful for the light and dark caps of a shadow volume.
+ *
+ * @param slot Cache slot.
+ * @return One entry per face, non-zero for faces facing the light.
+ */
+const vector<unsigned char>& SilhouetteExtractor::GetFacing(unsigned int slot) const {
+    return slots[slot].facing;
+}
+
+/**
+ * Get the number of cache slots in use.
+ *
+ * @return Slot count.
+ */
+unsigned int SilhouetteExtractor::GetNumSlots() const {
+    return slots.size();
+}
+
+void SilhouetteExtractor::Resize(unsigned int count) {
+    Slot empty;
+    empty.revision = 0;
+    slots.resize(count, empty);
+}
+
+/**
+ * Extract the stale lights first, first+stride, ...
+ */
+void SilhouetteExtractor::ComputeRange(const vector<Vector<4,float> >* lights,
+                                       unsigned int first, unsigned int stride) {
+    for (unsigned int i=first; i<lights->size(); i+=stride) {
+        Slot& s = slots[i];
+        if (s.revision != revision || !(s.light == (*lights)[i]))
+            Compute(s, (*lights)[i]);
+    }
+}
+
+/**
+ * Classify the faces and collect the silhouette edges of one light.
+ */
+void SilhouetteExtractor::Compute(Slot& slot, const Vector<4,float>& light) {
+    const unsigned int faces = nx.size();
+    const float lx = light.Get(0), ly = light.Get(1);
+    const float lz = light.Get(2), lw = light.Get(3);
+    slot.light = light;
+    slot.revision = revision;
+    slot.facing.resize(faces);
+    slot.edges.clear();
+    if (faces == 0) return;
+
+    // plain loop over the plane arrays, so the compiler vectorizes it
+    const float* x = &nx[0];
+    const float* y = &ny[0];
+    const float* z = &nz[0];
+    const float* d = &nd[0];
+    unsigned char* facing = &slot.facing[0];
+    for (unsigned int f=0; f<faces; f++)
+        facing[f] = x[f]*lx + y[f]*ly + z[f]*lz - d[f]*lw > 0.0f;
+
+    for (unsigned int f=0; f<faces; f++) {
+        if (!facing[f]) continue;
+        for (unsigned int e=f*3; e<f*3+3; e++) {
+            unsigned int t = mesh.GetTwin(e);
+            if (t == HalfEdgeMesh::NONE || !facing[t/3])
+                slot.edges.push_back(e);
+        }
+    }
+}
+
+} // NS Geometry
+} // NS OpenEngine
@@ -0,0 +1,95 @@
+// Silhouette extractor.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_SILHOUETTE_EXTRACTOR_H_
+#define _OE_SILHOUETTE_EXTRACTOR_H_
+
+#include <Geometry/HalfEdgeMesh.h>
+#include <Math/Vector.h>
+#include <vector>
+
+namespace OpenEngine {
+namespace Geometry {
+
+using std::vector;
+using OpenEngine::Math::Vector;
+
+/**
+ * Silhouette extractor.
+ * Finds the silhouette edges of a mesh as seen from a light, for
+ * building shadow volumes. Faces are classified as lit or unlit
+ * against precomputed face planes, and a silhouette edge is an edge
+ * between a lit face and an unlit face (or the boundary). With the
+ * edge adjacency of a HalfEdgeMesh this is linear in the number of
+ * faces.
+ *
+ * Lights are given as homogeneous positions in the object space of
+ * the mesh: a point light is \a (x,y,z,1) and a directional light is
+ * the direction towards the light as \a (x,y,z,0).
+ *
+ * @code
+ * SilhouetteExtractor silhouettes(mesh);
+ * vector<Vector<4,float> > lights;  // one per light node
+ * ...
+ * silhouettes.Extract(lights);      // the lights in parallel
+ * for (unsigned int i=0; i<lights.size(); i++) {
+ *     const vector<unsigned int>& edges = silhouettes.GetSilhouette(i);
+ *     ... // extrude each half-edge away from lights[i]
+ * }
+ * @endcode
+ *
+ * The result for each light slot is cached, and only recomputed
+ * when the light has moved or \a Update has been called because the
+ * mesh has. The silhouette half-edges belong to the lit faces, so
+ * they are consistently wound for extrusion.
+ *
+ * @class SilhouetteExtractor SilhouetteExtractor.h Geometry/SilhouetteExtractor.h
+ */
+class SilhouetteExtractor {
+public:
+    explicit SilhouetteExtractor(const HalfEdgeMesh& mesh);
+    virtual ~SilhouetteExtractor();
+
+    void Update();
+
+    const vector<unsigned int>& Extract(const Vector<4,float>& light,
+                                        unsigned int slot = 0);
+    void Extract(const vector<Vector<4,float> >& lights);
+
+    const vector<unsigned int>& GetSilhouette(unsigned int slot) const;
+    const vector<unsigned char>& GetFacing(unsigned int slot) const;
+    unsigned int GetNumSlots() const;
+
+private:
+    /**
+     * Classification and silhouette of one light.
+     */
+    struct Slot {
+        Vector<4,float> light;
+        unsigned int revision;      //!< mesh revision extracted from
+        vector<unsigned char> facing;
+        vector<unsigned int> edges;
+    };
+
+    const HalfEdgeMesh& mesh;
+    unsigned int revision;
+    // face planes, one array per component
+    vector<float> nx, ny, nz, nd;
+    vector<Slot> slots;
+
+    void Resize(unsigned int count);
+    void Compute(Slot& slot, const Vector<4,float>& light);
+    void ComputeRange(const vector<Vector<4,float> >* lights,
+                      unsigned int first, unsigned int stride);
+};
+
+} // NS Geometry
+} // NS OpenEngine
+
+#endif // _OE_SILHOUETTE_EXTRACTOR_H_
@@ -11,12 +11,116 @@
 #include <Geometry/Face.h>
 #include <Geometry/Line.h>
 #include <Geometry/Plane.h>
+#include <Geometry/Box.h>
+#include <Geometry/VertexArray.h>
 #include <Logging/Logger.h>
 
+#include <cmath>
+#include <vector>
+
 namespace OpenEngine {
 namespace Geometry {
 
 using OpenEngine::Math::Vector;
+using std::vector;
+
+// a ball in double precision, used while searching for the sphere
+struct Ball {
+    double c[3];
+    double r2;                  //!< squared radius, negative if empty
+};
+
+static bool Contains(const Ball& b, const double* p) {
+    double dx = p[0] - b.c[0], dy = p[1] - b.c[1], dz = p[2] - b.c[2];
+    return dx*dx + dy*dy + dz*dz <= b.r2 * (1.0 + 1e-9);
+}
+
+static double Dot(const double* a, const double* b) {
+    return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+}
+
+static void Cross(const double* a, const double* b, double* out) {
+    out[0] = a[1]*b[2] - a[2]*b[1];
+    out[1] = a[2]*b[0] - a[0]*b[2];
+    out[2] = a[0]*b[1] - a[1]*b[0];
+}
+
+static Ball BallFromSupport(const double* s[], unsigned int n);
+
+// the smallest ball through all but one of the support points that
+// contains the left out one, for degenerate support sets
+static Ball BallFromSubsets(const double* s[], unsigned int n) {
+    Ball best;
+    best.c[0] = best.c[1] = best.c[2] = 0.0;
+    best.r2 = -1.0;
+    for (unsigned int skip=0; skip<n; skip++) {
+        const double* sub[3];
+        unsigned int m = 0;
+        for (unsigned int i=0; i<n; i++)
+            if (i != skip) sub[m++] = s[i];
+        Ball b = BallFromSupport(sub, m);
+        if (Contains(b, s[skip]) && (best.r2 < 0.0 || b.r2 < best.r2))
+            best = b;
+    }
+    return best;
+}
+
+// the smallest ball with all support points on its surface
+static Ball BallFromSupport(const double* s[], unsigned int n) {
+    Ball b;
+    b.c[0] = b.c[1] = b.c[2] = 0.0;
+    b.r2 = -1.0;
+    if (n == 0) return b;
+    double a[3], e[3], f[3];
+    for (int k=0; k<3; k++) {
+        b.c[k] = s[0][k];
+        if (n > 1) a[k] = s[1][k] - s[0][k];
+        if (n > 2) e[k] = s[2][k] - s[0][k];
+        if (n > 3) f[k] = s[3][k] - s[0][k];
+    }
+    double o[3] = {0.0, 0.0, 0.0};
+    if (n == 2) {
+        for (int k=0; k<3; k++) o[k] = a[k] * 0.5;
+    } else if (n == 3) {
+        // circumcenter: ((|a|^2 e - |e|^2 a) x (a x e)) / (2 |a x e|^2)
+        double axe[3], t[3];
+        Cross(a, e, axe);
+        double den = 2.0 * Dot(axe, axe);
+        if (den <= 1e-12 * Dot(a, a) * Dot(e, e)) return BallFromSubsets(s, n);
+        for (int k=0; k<3; k++) t[k] = Dot(a, a) * e[k] - Dot(e, e) * a[k];
+        Cross(t, axe, o);
+        for (int k=0; k<3; k++) o[k] /= den;
+    } else if (n == 4) {
+        // solve 2 x . o = |x|^2 for x = a, e, f by Cramer's rule
+        double exf[3], fxa[3], axe[3];
+        Cross(e, f, exf);
+        Cross(f, a, fxa);
+        Cross(a, e, axe);
+        double det = 2.0 * Dot(a, exf);
+        double scale = sqrt(Dot(a, a) * Dot(e, e) * Dot(f, f));
+        if (fabs(det) <= 1e-9 * scale) return BallFromSubsets(s, n);
+        for (int k=0; k<3; k++)
+            o[k] = (Dot(a, a) * exf[k] + Dot(e, e) * fxa[k] + Dot(f, f) * axe[k]) / det;
+    }
+    for (int k=0; k<3; k++) b.c[k] += o[k];
+    b.r2 = Dot(o, o);
+    return b;
+}
+
+// Welzl's algorithm: the smallest ball containing the first n points
+// with the support points on its surface
+static Ball Welzl(const vector<double>& p, unsigned int n,
+                  const double* support[], unsigned int ns) {
+    Ball b = BallFromSupport(support, ns);
+    if (ns == 4) return b;
+    for (unsigned int i=0; i<n; i++) {
+        const double* q = &p[i*3];
+        if (Contains(b, q)) continue;
+        support[ns] = q;
+        b = Welzl(p, i, support, ns + 1);
+    }
+    return b;
+}
 
 /**
  * Create a sphere with center in [0,0,0] and diameter 0;
@@ -40,27 +144,116 @@ Sphere::Sphere(Vector<3,float> center, float diameter)
  * Create a sphere with a volume defined by a set of faces.
  *
  * @param faces Face set to calculate volume from.
+ * @param exact Find the smallest enclosing sphere [optional].
+ * @throws Exception if the faces have no volume.
+ */
+Sphere::Sphere(FaceSet& faces, bool exact) : diameter(0) {
+    vector<float> points;
+    points.reserve(faces.Size() * 9);
+    for (FaceList::iterator itr = faces.begin(); itr != faces.end(); itr++)
+        for (int i=0; i<3; i++)
+            for (int k=0; k<3; k++)
+                points.push_back((*itr)->vert[i][k]);
+    SetFromPoints(points.empty() ? NULL : &points[0],
+                  points.size() / 3, 3, exact);
+}
+
+/**
+ * Create a sphere enclosing a vertex array.
+ *
+ * @param va Vertex array to enclose.
+ * @param exact Find the smallest enclosing sphere [optional].
+ * @throws Exception if the vertices have no volume.
+ */
+Sphere::Sphere(VertexArray& va, bool exact) : diameter(0) {
+    unsigned int count = va.GetNumFaces() * 3;
+    if (!(va.GetAttributes() & VertexArray::VERTICES)) count = 0;
+    if (count > 0 && (va.GetFormats() & VertexArray::POSITION_16)) {
+        // decode a copy rather than decompressing the array
+        vector<float> points(count * 3);
+        va.GetAttribute(VertexArray::VERTICES, &points[0]);
+        SetFromPoints(&points[0], count, 3, exact);
+        return;
+    }
+    unsigned int stride = va.GetStride() / sizeof(float);
+    SetFromPoints(count ? va.GetVertices() : NULL, count,
+                  stride ? stride : 3, exact);
+}
+
+/**
+ * Fit the sphere to a set of points.
+ * Ritter: start with the sphere over the most distant pair of axis
+ * extremes and grow it to every point outside it.
  */
-Sphere::Sphere(FaceSet& faces) {
-    Vector<3,float> max, min;
-    FaceList::iterator itr;
-    for (itr = faces.begin(); itr != faces.end(); itr++) {
-        for (int i=0; i<3; i++) {
-            Vector<3,float> v = (*itr)->vert[i];
-            for (int j=0; j<3; j++)
-                if (v[j] < min[j]) min[j] = v[j];
-                else if (v[j] > max[j]) max[j] = v[j];
+void Sphere::SetFromPoints(const float* points, unsigned int count,
+                           unsigned int stride, bool exact) {
+    if (count == 0)
+        throw Exception("Invalid volume -  radius of the sphere was zero");
+
+    // the extreme points along each axis
+    unsigned int lo[3] = {0, 0, 0}, hi[3] = {0, 0, 0};
+    for (unsigned int i=1; i<count; i++)
+        for (int k=0; k<3; k++) {
+            float v = points[i*stride+k];
+            if (v < points[lo[k]*stride+k]) lo[k] = i;
+            if (v > points[hi[k]*stride+k]) hi[k] = i;
+        }
+    Ball b;
+    b.c[0] = b.c[1] = b.c[2] = 0.0;
+    b.r2 = -1.0;
+    for (int k=0; k<3; k++) {
+        const float* p = points + lo[k] * stride;
+        const float* q = points + hi[k] * stride;
+        double d2 = 0.0;
+        for (int j=0; j<3; j++) d2 += (q[j] - p[j]) * (double)(q[j] - p[j]);
+        if (d2 / 4.0 <= b.r2) continue;
+        for (int j=0; j<3; j++) b.c[j] = (p[j] + (double)q[j]) * 0.5;
+        b.r2 = d2 / 4.0;
+    }
+
+    // grow to enclose every point
+    double r = sqrt(b.r2);
+    for (unsigned int i=0; i<count; i++) {
+        const float* p = points + i * stride;
+        double d[3] = {p[0] - b.c[0], p[1] - b.c[1], p[2] - b.c[2]};
+        double d2 = Dot(d, d);
+        if (d2 <= r * r) continue;
+        double l = sqrt(d2);
+        double grown = (r + l) * 0.5;
+        for (int k=0; k<3; k++) b.c[k] += d[k] * ((grown - r) / l);
+        r = grown;
+    }
+    b.r2 = r * r;
+
+    // (points that are not numbers would make every ball fail)
+    if (exact && b.r2 == b.r2 && b.r2 < HUGE_VAL) {
+        // Welzl over the points in a fixed pseudo random order
+        vector<double> p(count * 3);
+        for (unsigned int i=0; i<count; i++)
+            for (int k=0; k<3; k++) p[i*3+k] = points[i*stride+k];
+        unsigned int seed = 2463534242u;
+        for (unsigned int i=count-1; i>0; i--) {
+            seed ^= seed << 13; seed ^= seed >> 17; seed ^= seed << 5;
+            unsigned int j = seed % (i + 1);
+            for (int k=0; k<3; k++) std::swap(p[i*3+k], p[j*3+k]);
         }
+        const double* support[4];
+        Ball w = Welzl(p, count, support, 0);
+        if (w.r2 >= 0.0 && w.r2 < b.r2) b = w;
     }
-    // set box center
-    center = (max - min) / 2 + min;
-    // set corner vector
-    Vector<3,float> corner = max - center;
 
-    if (corner.IsZero())
+    // round to floats and make sure the rounding lost no point
+    center = Vector<3,float>(b.c[0], b.c[1], b.c[2]);
+    float radius = sqrt(b.r2);
+    for (unsigned int i=0; i<count; i++) {
+        const float* p = points + i * stride;
+        Vector<3,float> d(p[0] - center[0], p[1] - center[1], p[2] - center[2]);
+        float l = d.GetLength();
+        if (l > radius) radius = l;
+    }
+    if (radius <= 0.0f)
         throw Exception("Invalid volume -  radius of the sphere was zero");
-    else
-        diameter = corner.GetLength() / 2.0f;
+    diameter = radius * 2.0f;
 }
 
 /**
@@ -120,29 +313,68 @@ void Sphere::SetRadius(const float r) {
 /**
  * Test if sphere contains a point.
  *
- * @todo Not implemented.
- *
  * @param point Point to test for containment.
  */
-bool Sphere::Intersects(const Vector<3,float> point) const { return false; }
+bool Sphere::Intersects(const Vector<3,float> point) const {
+    float r = GetRadius();
+    Vector<3,float> d = point - center;
+    return d * d <= r * r;
+}
 
 /**
- * Test if sphere intersects with a line.
- *
- * @todo Not implemented.
+ * Test if sphere intersects with a line segment.
  *
  * @param line Line to test for intersection.
  */
-bool Sphere::Intersects(const Line line) const { return false; }
+bool Sphere::Intersects(const Line line) const {
+    // closest point on the segment to the center
+    Vector<3,float> d = line.point2 - line.point1;
+    Vector<3,float> m = center - line.point1;
+    float l = d * d;
+    float t = l > 0 ? (m * d) / l : 0;
+    t = t < 0 ? 0 : (t > 1 ? 1 : t);
+    Vector<3,float> e = m - d * t;
+    float r = GetRadius();
+    return e * e <= r * r;
+}
 
 /**
  * Test if sphere intersects with a plane.
  *
- * @todo Not implemented.
- *
  * @param plane Plane to test for intersection.
  */
-bool Sphere::Intersects(const Plane plane) const { return false; }
+bool Sphere::Intersects(const Plane plane) const {
+    return fabs(plane.normal * center + plane.distance) <= GetRadius();
+}
+
+/**
+ * Test if two spheres intersect.
+ *
+ * @param sphere Sphere to test for intersection.
+ */
+bool Sphere::Intersects(const Sphere& sphere) const {
+    float r = GetRadius() + sphere.GetRadius();
+    Vector<3,float> d = sphere.center - center;
+    return d * d <= r * r;
+}
+
+/**
+ * Test if sphere intersects with a box.
+ *
+ * @param box Box to test for intersection.
+ */
+bool Sphere::Intersects(const Box& box) const {
+    // squared distance from the center to the box
+    Vector<3,float> min = box.GetMin(), max = box.GetMax();
+    float d2 = 0;
+    for (int i=0; i<3; i++) {
+        float c = center.Get(i);
+        float e = c < min[i] ? min[i] - c : (c > max[i] ? c - max[i] : 0);
+        d2 += e * e;
+    }
+    float r = GetRadius();
+    return d2 <= r * r;
+}
 
 } //NS Geometry
 } //NS OpenEngine
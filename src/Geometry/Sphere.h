@@ -12,6 +12,7 @@
 
 #include <Geometry/FaceSet.h>
 #include <Geometry/BoundingGeometry.h>
+#include <Geometry/GeometrySet.h>
 #include <string>
 
 namespace OpenEngine {
@@ -19,9 +20,18 @@ namespace Geometry {
 
 using OpenEngine::Math::Vector;
 
+class VertexArray;
+class Box;
+
 /**
  * Bounding geometry sphere.
  *
+ * Spheres built from geometry use Ritter's algorithm, which finds a
+ * sphere at most a few percent larger than the smallest one in two
+ * passes over the points. When \a exact is set the sphere is refined
+ * to the smallest enclosing sphere with Welzl's algorithm, in
+ * expected linear time.
+ *
  * @class Sphere Sphere.h Geometry/Sphere.h
  */
 class Sphere : public BoundingGeometry {
@@ -32,12 +42,28 @@ private:
     Vector<3,float> center;
     float diameter;    
 
+    void SetFromPoints(const float* points, unsigned int count,
+                       unsigned int stride, bool exact);
+
 public:
     explicit Sphere();
 
     Sphere(Vector<3,float> center, float diameter);
 
-    Sphere(FaceSet& faces);
+    Sphere(FaceSet& faces, bool exact = false);
+    explicit Sphere(VertexArray& va, bool exact = false);
+
+    /**
+     * Create a sphere enclosing a geometry set in space.
+     *
+     * @param set Geometry set to enclose.
+     * @param exact Find the smallest enclosing sphere [optional].
+     */
+    template <int Shape>
+    explicit Sphere(GeometrySet<3,Shape>& set, bool exact = false)
+        : diameter(0) {
+        SetFromPoints(set.GetVertArray(), set.GetVertLength() / 3, 3, exact);
+    }
     
     void Move(Vector<3,float> dir);
 
@@ -56,6 +82,10 @@ public:
 
     bool Intersects(const Plane plane) const;
 
+    bool Intersects(const Sphere& sphere) const;
+
+    bool Intersects(const Box& box) const;
+
 };
 
 } //NS Common
@@ -0,0 +1,285 @@
+// Sphere set.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Geometry/SphereSet.h>
+#include <Geometry/Box.h>
+#include <Geometry/Line.h>
+#include <Geometry/Plane.h>
+#include <Geometry/OrientedBox.h>
+
+#include <cmath>
+
+namespace OpenEngine {
+namespace Geometry {
+
+// The tests are functors over the component arrays, as in BoxSet.
+
+namespace {
+
+struct SphereArrays {
+    const float *x, *y, *z, *r;
+};
+
+struct PointTest {
+    SphereArrays s;
+    float p[3];
+    bool operator()(unsigned int i) const {
+        float dx = p[0] - s.x[i], dy = p[1] - s.y[i], dz = p[2] - s.z[i];
+        return dx*dx + dy*dy + dz*dz <= s.r[i] * s.r[i];
+    }
+};
+
+struct PlaneTest {
+    SphereArrays s;
+    float n[3], d;
+    bool operator()(unsigned int i) const {
+        return fabs(s.x[i]*n[0] + s.y[i]*n[1] + s.z[i]*n[2] + d) <= s.r[i];
+    }
+};
+
+struct LineTest {
+    SphereArrays s;
+    float p[3], d[3], invLength2;
+    bool operator()(unsigned int i) const {
+        float m[3] = {s.x[i] - p[0], s.y[i] - p[1], s.z[i] - p[2]};
+        float t = (m[0]*d[0] + m[1]*d[1] + m[2]*d[2]) * invLength2;
+        t = t < 0 ? 0 : (t > 1 ? 1 : t);
+        float ex = m[0] - d[0]*t, ey = m[1] - d[1]*t, ez = m[2] - d[2]*t;
+        return ex*ex + ey*ey + ez*ez <= s.r[i] * s.r[i];
+    }
+};
+
+struct BoxTest {
+    SphereArrays s;
+    float lo[3], hi[3];
+    static float Excess(float c, float lo, float hi) {
+        float e = lo - c > 0 ? lo - c : 0;
+        return c - hi > e ? c - hi : e;
+    }
+    bool operator()(unsigned int i) const {
+        float ex = Excess(s.x[i], lo[0], hi[0]);
+        float ey = Excess(s.y[i], lo[1], hi[1]);
+        float ez = Excess(s.z[i], lo[2], hi[2]);
+        return ex*ex + ey*ey + ez*ez <= s.r[i] * s.r[i];
+    }
+};
+
+struct SphereTest {
+    SphereArrays s;
+    float c[3], r;
+    bool operator()(unsigned int i) const {
+        float dx = c[0] - s.x[i], dy = c[1] - s.y[i], dz = c[2] - s.z[i];
+        float sum = r + s.r[i];
+        return dx*dx + dy*dy + dz*dz <= sum * sum;
+    }
+};
+
+// the sphere centers are moved to the space of the oriented box and
+// tested against the box there
+struct OrientedBoxTest {
+    SphereArrays s;
+    float c[3], axes[3][3], ext[3];
+    bool operator()(unsigned int i) const {
+        float d[3] = {s.x[i] - c[0], s.y[i] - c[1], s.z[i] - c[2]};
+        float d2 = 0;
+        for (int k=0; k<3; k++) {
+            float l = fabs(d[0]*axes[k][0] + d[1]*axes[k][1] + d[2]*axes[k][2]);
+            float e = l - ext[k] > 0 ? l - ext[k] : 0;
+            d2 += e * e;
+        }
+        return d2 <= s.r[i] * s.r[i];
+    }
+};
+
+} // anonymous namespace
+
+template <class Test>
+static void Fill(const Test& test, unsigned int size, vector<unsigned int>& mask) {
+    mask.assign((size + 31) / 32, 0);
+    for (unsigned int w=0; w<mask.size(); w++) {
+        unsigned int first = w * 32;
+        unsigned int count = size - first < 32 ? size - first : 32;
+        unsigned int bits = 0;
+        for (unsigned int j=0; j<count; j++)
+            bits |= (unsigned int)test(first + j) << j;
+        mask[w] = bits;
+    }
+}
+
+static SphereArrays Arrays(const vector<float>& x, const vector<float>& y,
+                           const vector<float>& z, const vector<float>& r) {
+    SphereArrays s;
+    s.x = x.empty() ? NULL : &x[0];
+    s.y = y.empty() ? NULL : &y[0];
+    s.z = z.empty() ? NULL : &z[0];
+    s.r = r.empty() ? NULL : &r[0];
+    return s;
+}
+
+/**
+ * Create an empty set.
+ */
+SphereSet::SphereSet() {}
+
+/**
+ * Destructor.
+ */
+SphereSet::~SphereSet() {}
+
+/**
+ * Add a sphere.
+ *
+ * @param sphere Sphere to add.
+ * @return Index of the sphere.
+ */
+unsigned int SphereSet::Add(const Sphere& sphere) {
+    Vector<3,float> c = sphere.GetCenter();
+    x.push_back(c[0]); y.push_back(c[1]); z.push_back(c[2]);
+    radius.push_back(sphere.GetRadius());
+    return x.size() - 1;
+}
+
+/**
+ * Replace a sphere.
+ *
+ * @param index Index of the sphere.
+ * @param sphere New sphere.
+ */
+void SphereSet::Set(unsigned int index, const Sphere& sphere) {
+    Vector<3,float> c = sphere.GetCenter();
+    x[index] = c[0]; y[index] = c[1]; z[index] = c[2];
+    radius[index] = sphere.GetRadius();
+}
+
+/**
+ * Get a sphere.
+ *
+ * @param index Index of the sphere.
+ * @return The sphere.
+ */
+Sphere SphereSet::Get(unsigned int index) const {
+    return Sphere(Vector<3,float>(x[index], y[index], z[index]), radius[index] * 2);
+}
+
+/**
+ * Get the number of spheres.
+ *
+ * @return Number of spheres.
+ */
+unsigned int SphereSet::GetSize() const {
+    return x.size();
+}
+
+/**
+ * Remove all spheres.
+ */
+void SphereSet::Clear() {
+    x.clear(); y.clear(); z.clear();
+    radius.clear();
+}
+
+/**
+ * Find the spheres containing a point.
+ *
+ * @param point Point to test.
+ * @param mask Set to one bit per sphere.
+ */
+void SphereSet::Intersects(const Vector<3,float> point, vector<unsigned int>& mask) const {
+    PointTest test;
+    test.s = Arrays(x, y, z, radius);
+    for (int k=0; k<3; k++) test.p[k] = point.Get(k);
+    Fill(test, GetSize(), mask);
+}
+
+/**
+ * Find the spheres cut by a plane.
+ *
+ * @param plane Plane to test.
+ * @param mask Set to one bit per sphere.
+ */
+void SphereSet::Intersects(const Plane& plane, vector<unsigned int>& mask) const {
+    PlaneTest test;
+    test.s = Arrays(x, y, z, radius);
+    for (int k=0; k<3; k++) test.n[k] = plane.normal.Get(k);
+    test.d = plane.distance;
+    Fill(test, GetSize(), mask);
+}
+
+/**
+ * Find the spheres intersecting a line segment.
+ *
+ * @param line Line segment to test.
+ * @param mask Set to one bit per sphere.
+ */
+void SphereSet::Intersects(const Line& line, vector<unsigned int>& mask) const {
+    LineTest test;
+    test.s = Arrays(x, y, z, radius);
+    float l2 = 0;
+    for (int k=0; k<3; k++) {
+        test.p[k] = line.point1.Get(k);
+        test.d[k] = line.point2.Get(k) - test.p[k];
+        l2 += test.d[k] * test.d[k];
+    }
+    test.invLength2 = l2 > 0 ? 1 / l2 : 0;
+    Fill(test, GetSize(), mask);
+}
+
+/**
+ * Find the spheres intersecting a box.
+ *
+ * @param box Box to test.
+ * @param mask Set to one bit per sphere.
+ */
+void SphereSet::Intersects(const Box& box, vector<unsigned int>& mask) const {
+    BoxTest test;
+    test.s = Arrays(x, y, z, radius);
+    Vector<3,float> lo = box.GetMin(), hi = box.GetMax();
+    for (int k=0; k<3; k++) {
+        test.lo[k] = lo[k];
+        test.hi[k] = hi[k];
+    }
+    Fill(test, GetSize(), mask);
+}
+
+/**
+ * Find the spheres intersecting a sphere.
+ *
+ * @param sphere Sphere to test.
+ * @param mask Set to one bit per sphere.
+ */
+void SphereSet::Intersects(const Sphere& sphere, vector<unsigned int>& mask) const {
+    SphereTest test;
+    test.s = Arrays(x, y, z, radius);
+    Vector<3,float> c = sphere.GetCenter();
+    for (int k=0; k<3; k++) test.c[k] = c[k];
+    test.r = sphere.GetRadius();
+    Fill(test, GetSize(), mask);
+}
+
+/**
+ * Find the spheres intersecting an oriented box.
+ *
+ * @param box Oriented box to test.
+ * @param mask Set to one bit per sphere.
+ */
+void SphereSet::Intersects(const OrientedBox& box, vector<unsigned int>& mask) const {
+    OrientedBoxTest test;
+    test.s = Arrays(x, y, z, radius);
+    Vector<3,float> c = box.GetCenter(), e = box.GetExtent();
+    for (int k=0; k<3; k++) {
+        Vector<3,float> axis = box.GetAxis(k);
+        test.c[k] = c[k];
+        test.ext[k] = e[k];
+        for (int j=0; j<3; j++) test.axes[k][j] = axis[j];
+    }
+    Fill(test, GetSize(), mask);
+}
+
+} // NS Geometry
+} // NS OpenEngine
@@ -0,0 +1,60 @@
+// Sphere set.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_SPHERE_SET_H_
+#define _OE_SPHERE_SET_H_
+
+#include <Geometry/Sphere.h>
+#include <vector>
+
+namespace OpenEngine {
+namespace Geometry {
+
+class Box;
+class Line;
+class Plane;
+class OrientedBox;
+
+using std::vector;
+
+/**
+ * Set of spheres tested together.
+ * The counterpart of \a BoxSet for spheres: centers and radii are
+ * stored as one array per component and tests write one bit per
+ * sphere.
+ *
+ * @class SphereSet SphereSet.h Geometry/SphereSet.h
+ */
+class SphereSet {
+private:
+    vector<float> x, y, z;
+    vector<float> radius;
+
+public:
+    SphereSet();
+    virtual ~SphereSet();
+
+    unsigned int Add(const Sphere& sphere);
+    void Set(unsigned int index, const Sphere& sphere);
+    Sphere Get(unsigned int index) const;
+    unsigned int GetSize() const;
+    void Clear();
+
+    void Intersects(const Vector<3,float> point, vector<unsigned int>& mask) const;
+    void Intersects(const Plane& plane, vector<unsigned int>& mask) const;
+    void Intersects(const Line& line, vector<unsigned int>& mask) const;
+    void Intersects(const Box& box, vector<unsigned int>& mask) const;
+    void Intersects(const Sphere& sphere, vector<unsigned int>& mask) const;
+    void Intersects(const OrientedBox& box, vector<unsigned int>& mask) const;
+};
+
+} // NS Geometry
+} // NS OpenEngine
+
+#endif // _OE_SPHERE_SET_H_
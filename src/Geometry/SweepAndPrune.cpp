@@ -0,0 +1,362 @@
+// Sweep and prune broadphase.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Geometry/SweepAndPrune.h>
+#include <Core/Exceptions.h>
+
+#include <algorithm>
+#include <cfloat>
+
+namespace OpenEngine {
+namespace Geometry {
+
+using boost::uint64_t;
+using OpenEngine::Core::Exception;
+
+// pair flags
+static const unsigned char OVERLAPPING = 1; //!< overlapping now
+static const unsigned char REPORTED    = 2; //!< last reported overlapping
+static const unsigned char QUEUED      = 4; //!< in the dirty list
+
+// additions above which all axes are sorted from scratch
+static const unsigned int REBUILD_THRESHOLD = 32;
+
+bool SweepAndPrune::Less::operator()(const EndPoint& a, const EndPoint& b) const {
+    // min ends sort before max ends at the same value, so touching
+    // boxes overlap as in Box::Intersects
+    return a.value < b.value ||
+        (a.value == b.value && !(a.proxy & 1) && (b.proxy & 1));
+}
+
+/**
+ * Create an empty broadphase.
+ */
+SweepAndPrune::SweepAndPrune()
+    : added(0), removed(0), active(0), numPairs(0), swaps(0) {}
+
+/**
+ * Destructor.
+ */
+SweepAndPrune::~SweepAndPrune() {}
+
+/**
+ * Add a proxy.
+ * The proxy takes part in the next \a Process.
+ *
+ * @param min Min corner of the proxy.
+ * @param max Max corner of the proxy.
+ * @return Id of the proxy.
+ */
+unsigned int SweepAndPrune::Add(const Vector<3,float>& min,
+                                const Vector<3,float>& max) {
+    unsigned int id;
+    if (unused.empty()) {
+        id = states.size();
+        states.push_back(FREE);
+        bounds.resize(bounds.size() + 6);
+        positions.resize(positions.size() + 6);
+    } else {
+        id = unused.back();
+        unused.pop_back();
+    }
+    states[id] = ADDED;
+    added++;
+    for (int axis=0; axis<3; axis++)
+        for (unsigned int end=0; end<2; end++) {
+            EndPoint e;
+            e.value = 0;
+            e.proxy = id << 1 | end;
+            positions[id*6 + axis*2 + end] = axes[axis].size();
+            axes[axis].push_back(e);
+        }
+    Update(id, min, max);
+    return id;
+}
+
+/**
+ * Move a proxy.
+ * The new bounds are used by the next \a Process.
+ *
+ * @param proxy Id of the proxy.
+ * @param min New min corner.
+ * @param max New max corner.
+ */
+void SweepAndPrune::Update(unsigned int proxy,
+                           const Vector<3,float>& min, const Vector<3,float>& max) {
+    if (proxy >= states.size() || states[proxy] == FREE || states[proxy] == REMOVED)
+        throw Exception("Update of an unknown proxy in sweep and prune");
+    for (int axis=0; axis<3; axis++) {
+        bounds[proxy*6 + axis]     = min.Get(axis);
+        bounds[proxy*6 + 3 + axis] = max.Get(axis);
+        axes[axis][positions[proxy*6 + axis*2]].value     = min.Get(axis);
+        axes[axis][positions[proxy*6 + axis*2 + 1]].value = max.Get(axis);
+    }
+}
+
+/**
+ * Remove a proxy.
+ * Its overlaps end on the next \a Process, after which the id may be
+ * reused.
+ *
+ * @param proxy Id of the proxy.
+ */
+void SweepAndPrune::Remove(unsigned int proxy) {
+    if (proxy >= states.size() || states[proxy] == FREE || states[proxy] == REMOVED)
+        throw Exception("Removal of an unknown proxy in sweep and prune");
+    if (states[proxy] == ADDED) added--;
+    else active--;
+    states[proxy] = REMOVED;
+    removed++;
+    // move it past everything, which ends all its overlaps
+    for (int axis=0; axis<3; axis++)
+        for (unsigned int end=0; end<2; end++) {
+            bounds[proxy*6 + end*3 + axis] = FLT_MAX;
+            axes[axis][positions[proxy*6 + axis*2 + end]].value = FLT_MAX;
+        }
+}
+
+/**
+ * Get the bounds of a proxy.
+ *
+ * @param proxy Id of the proxy.
+ * @param min Min corner as last added or updated.
+ * @param max Max corner as last added or updated.
+ */
+void SweepAndPrune::GetBounds(unsigned int proxy,
+                              Vector<3,float>& min, Vector<3,float>& max) const {
+    const float* b = &bounds[proxy*6];
+    min = Vector<3,float>(b[0], b[1], b[2]);
+    max = Vector<3,float>(b[3], b[4], b[5]);
+}
+
+/**
+ * Bring the overlapping pairs up to date with the added, moved and
+ * removed proxies, and notify the pairs that started or stopped
+ * overlapping since the last call.
+ */
+void SweepAndPrune::Process() {
+    if (added > REBUILD_THRESHOLD && added * 4 > active + added)
+        Rebuild();
+    else
+        for (int axis=0; axis<3; axis++) Sort(axis);
+
+    if (removed > 0) {
+        // end the overlaps between removed proxies, which tie at the
+        // end of the axes without swapping
+        boost::unordered_map<uint64_t, unsigned char>::iterator itr;
+        for (itr = pairs.begin(); itr != pairs.end(); itr++) {
+            unsigned int a = itr->first >> 32, b = itr->first & 0xFFFFFFFF;
+            if ((itr->second & OVERLAPPING) &&
+                (states[a] == REMOVED || states[b] == REMOVED))
+                SetPair(a, b, false);
+        }
+        // drop the end points of removed proxies
+        for (int axis=0; axis<3; axis++) {
+            vector<EndPoint>& ep = axes[axis];
+            unsigned int n = 0;
+            for (unsigned int i=0; i<ep.size(); i++) {
+                unsigned int proxy = ep[i].proxy;
+                if (states[proxy >> 1] == REMOVED) continue;
+                positions[(proxy >> 1)*6 + axis*2 + (proxy & 1)] = n;
+                ep[n++] = ep[i];
+            }
+            ep.resize(n);
+        }
+        for (unsigned int id=0; id<states.size(); id++)
+            if (states[id] == REMOVED) {
+                states[id] = FREE;
+                unused.push_back(id);
+            }
+        removed = 0;
+    }
+    if (added > 0) {
+        for (unsigned int id=0; id<states.size(); id++)
+            if (states[id] == ADDED) states[id] = ACTIVE;
+        active += added;
+        added = 0;
+    }
+
+    // settle the changed pairs before notifying, so listeners see a
+    // consistent state
+    vector<OverlapEventArg> changes;
+    for (unsigned int i=0; i<dirty.size(); i++) {
+        boost::unordered_map<uint64_t, unsigned char>::iterator itr = pairs.find(dirty[i]);
+        unsigned char flags = itr->second & ~QUEUED;
+        bool now = flags & OVERLAPPING, reported = flags & REPORTED;
+        if (now != reported) {
+            changes.push_back(OverlapEventArg(now ? OverlapEventArg::BEGIN
+                                              : OverlapEventArg::END,
+                                              dirty[i] >> 32, dirty[i] & 0xFFFFFFFF));
+            flags ^= REPORTED;
+            if (now) numPairs++;
+            else numPairs--;
+        }
+        if (flags == 0) pairs.erase(itr);
+        else itr->second = flags;
+    }
+    dirty.clear();
+    for (unsigned int i=0; i<changes.size(); i++)
+        overlapEvent.Notify(changes[i]);
+}
+
+/**
+ * Check if two proxies overlapped at the last \a Process.
+ *
+ * @param a Id of a proxy.
+ * @param b Id of another proxy.
+ * @return True if overlapping.
+ */
+bool SweepAndPrune::IsOverlapping(unsigned int a, unsigned int b) const {
+    boost::unordered_map<uint64_t, unsigned char>::const_iterator itr = pairs.find(Key(a, b));
+    return itr != pairs.end() && (itr->second & REPORTED);
+}
+
+/**
+ * Get the number of overlapping pairs at the last \a Process.
+ *
+ * @return Number of pairs.
+ */
+unsigned int SweepAndPrune::GetNumPairs() const {
+    return numPairs;
+}
+
+/**
+ * Get the overlapping pairs at the last \a Process.
+ *
+ * @param out Set to the pairs, lowest id first.
+ */
+void SweepAndPrune::GetPairs(vector<pair<unsigned int, unsigned int> >& out) const {
+    out.clear();
+    out.reserve(numPairs);
+    boost::unordered_map<uint64_t, unsigned char>::const_iterator itr;
+    for (itr = pairs.begin(); itr != pairs.end(); itr++)
+        if (itr->second & REPORTED)
+            out.push_back(std::make_pair((unsigned int)(itr->first >> 32),
+                                         (unsigned int)(itr->first & 0xFFFFFFFF)));
+}
+
+/**
+ * Get the number of end point swaps done so far.
+ * A measure of the work done by \a Process.
+ *
+ * @return Number of swaps.
+ */
+unsigned long SweepAndPrune::GetNumSwaps() const {
+    return swaps;
+}
+
+/**
+ * Overlap event list.
+ */
+IEvent<OverlapEventArg>& SweepAndPrune::OverlapEvent() {
+    return overlapEvent;
+}
+
+uint64_t SweepAndPrune::Key(unsigned int a, unsigned int b) {
+    if (a > b) std::swap(a, b);
+    return (uint64_t)a << 32 | b;
+}
+
+bool SweepAndPrune::Overlaps(unsigned int a, unsigned int b) const {
+    if (states[a] == REMOVED || states[b] == REMOVED) return false;
+    const float* p = &bounds[a*6];
+    const float* q = &bounds[b*6];
+    return p[0] <= q[3] && q[0] <= p[3] &&
+        p[1] <= q[4] && q[1] <= p[4] &&
+        p[2] <= q[5] && q[2] <= p[5];
+}
+
+void SweepAndPrune::SetPair(unsigned int a, unsigned int b, bool overlapping) {
+    uint64_t key = Key(a, b);
+    boost::unordered_map<uint64_t, unsigned char>::iterator itr = pairs.find(key);
+    if (itr == pairs.end()) {
+        if (!overlapping) return;
+        itr = pairs.insert(std::make_pair(key, (unsigned char)0)).first;
+    }
+    unsigned char& flags = itr->second;
+    if (overlapping) flags |= OVERLAPPING;
+    else flags &= ~OVERLAPPING;
+    if (!(flags & QUEUED)) {
+        flags |= QUEUED;
+        dirty.push_back(key);
+    }
+}
+
+/**
+ * Insertion sort an axis. Each swap of a min and a max end point of
+ * two proxies is the only way their overlap on this axis changes: a
+ * min passing below a max may start an overlap, which is confirmed
+ * on all axes, and a max passing below a min ends one.
+ */
+void SweepAndPrune::Sort(int axis) {
+    vector<EndPoint>& ep = axes[axis];
+    Less less;
+    for (unsigned int i=1; i<ep.size(); i++) {
+        EndPoint e = ep[i];
+        unsigned int j = i;
+        while (j > 0 && less(e, ep[j-1])) {
+            const EndPoint& f = ep[j-1];
+            unsigned int p = e.proxy >> 1, q = f.proxy >> 1;
+            bool eMax = e.proxy & 1, fMax = f.proxy & 1;
+            if (eMax != fMax && p != q) {
+                if (!eMax) {
+                    if (Overlaps(p, q)) SetPair(p, q, true);
+                } else SetPair(p, q, false);
+            }
+            ep[j] = f;
+            positions[q*6 + axis*2 + fMax] = j;
+            j--;
+            swaps++;
+        }
+        if (j != i) {
+            ep[j] = e;
+            positions[(e.proxy >> 1)*6 + axis*2 + (e.proxy & 1)] = j;
+        }
+    }
+}
+
+/**
+ * Sort all axes from scratch and find all pairs by sweeping the x
+ * axis, keeping the proxies whose x interval is open.
+ */
+void SweepAndPrune::Rebuild() {
+    boost::unordered_map<uint64_t, unsigned char>::iterator itr;
+    for (itr = pairs.begin(); itr != pairs.end(); itr++)
+        if (itr->second & OVERLAPPING)
+            SetPair(itr->first >> 32, itr->first & 0xFFFFFFFF, false);
+
+    for (int axis=0; axis<3; axis++) {
+        vector<EndPoint>& ep = axes[axis];
+        std::sort(ep.begin(), ep.end(), Less());
+        for (unsigned int i=0; i<ep.size(); i++)
+            positions[(ep[i].proxy >> 1)*6 + axis*2 + (ep[i].proxy & 1)] = i;
+    }
+
+    vector<unsigned int> open;
+    vector<unsigned int> slot(states.size());
+    const vector<EndPoint>& ep = axes[0];
+    for (unsigned int i=0; i<ep.size(); i++) {
+        unsigned int p = ep[i].proxy >> 1;
+        if (ep[i].proxy & 1) {
+            // close: swap the last open proxy into its slot
+            unsigned int last = open.back();
+            open[slot[p]] = last;
+            slot[last] = slot[p];
+            open.pop_back();
+            continue;
+        }
+        for (unsigned int k=0; k<open.size(); k++)
+            if (Overlaps(p, open[k])) SetPair(p, open[k], true);
+        slot[p] = open.size();
+        open.push_back(p);
+    }
+}
+
+} // NS Geometry
+} // NS OpenEngine
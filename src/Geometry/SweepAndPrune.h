@@ -0,0 +1,125 @@
+// Sweep and prune broadphase.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_SWEEP_AND_PRUNE_H_
+#define _OE_SWEEP_AND_PRUNE_H_
+
+#include <Core/Event.h>
+#include <Math/Vector.h>
+#include <vector>
+#include <utility>
+#include <boost/cstdint.hpp>
+#include <boost/unordered_map.hpp>
+
+namespace OpenEngine {
+namespace Geometry {
+
+using Core::IEvent;
+using Core::Event;
+using std::vector;
+using std::pair;
+using Math::Vector;
+
+/**
+ * Overlap event argument.
+ * Sent when the bounds of two proxies start or stop overlapping.
+ *
+ * @struct OverlapEventArg SweepAndPrune.h Geometry/SweepAndPrune.h
+ */
+struct OverlapEventArg {
+    enum Type { BEGIN, END };
+    Type type;                  //!< Started or stopped overlapping
+    unsigned int first;         //!< Proxy with the lowest id
+    unsigned int second;        //!< Proxy with the highest id
+    OverlapEventArg(Type type, unsigned int first, unsigned int second)
+        : type(type), first(first), second(second) {}
+};
+
+/**
+ * Sweep and prune broadphase.
+ * Finds the overlapping pairs in a set of axis aligned boxes, the
+ * proxies, given by their min and max corners. The
+ * start and end points of the boxes are kept sorted along each axis,
+ * and two boxes can only start or stop overlapping when an end point
+ * of one passes an end point of the other. As objects move little
+ * between frames, re-sorting with insertion sort costs O(n + swaps)
+ * rather than testing all pairs:
+ * @code
+ * SweepAndPrune sap;
+ * sap.OverlapEvent().Attach(collisions);
+ * Box box(*faces);
+ * unsigned int id = sap.Add(box.GetMin(), box.GetMax());
+ * // each frame
+ * sap.Update(id, moved.GetMin(), moved.GetMax());
+ * sap.Process();   // notifies the pairs that changed
+ * @endcode
+ * Proxies added or removed between two calls to \a Process take
+ * effect on the next call. Large batches of additions re-sort all
+ * axes from scratch instead.
+ *
+ * @class SweepAndPrune SweepAndPrune.h Geometry/SweepAndPrune.h
+ */
+class SweepAndPrune {
+private:
+    // an end point, the proxy and whether it is the max end
+    struct EndPoint {
+        float value;
+        unsigned int proxy;     //!< proxy << 1 | is max
+    };
+    struct Less {
+        bool operator()(const EndPoint& a, const EndPoint& b) const;
+    };
+
+    enum State { FREE, ADDED, ACTIVE, REMOVED };
+
+    vector<EndPoint> axes[3];
+    vector<float> bounds;           //!< min xyz, max xyz per proxy
+    vector<unsigned int> positions; //!< end point positions per proxy
+    vector<char> states;
+    vector<unsigned int> unused;    //!< ids free for reuse
+    unsigned int added, removed, active;
+
+    boost::unordered_map<boost::uint64_t, unsigned char> pairs;
+    vector<boost::uint64_t> dirty;
+    unsigned int numPairs;
+    unsigned long swaps;
+
+    Event<OverlapEventArg> overlapEvent;
+
+    static boost::uint64_t Key(unsigned int a, unsigned int b);
+    bool Overlaps(unsigned int a, unsigned int b) const;
+    void SetPair(unsigned int a, unsigned int b, bool overlapping);
+    void Sort(int axis);
+    void Rebuild();
+
+public:
+    SweepAndPrune();
+    virtual ~SweepAndPrune();
+
+    unsigned int Add(const Vector<3,float>& min, const Vector<3,float>& max);
+    void Update(unsigned int proxy,
+                const Vector<3,float>& min, const Vector<3,float>& max);
+    void Remove(unsigned int proxy);
+    void GetBounds(unsigned int proxy,
+                   Vector<3,float>& min, Vector<3,float>& max) const;
+
+    void Process();
+
+    bool IsOverlapping(unsigned int a, unsigned int b) const;
+    unsigned int GetNumPairs() const;
+    void GetPairs(vector<pair<unsigned int, unsigned int> >& out) const;
+    unsigned long GetNumSwaps() const;
+
+    IEvent<OverlapEventArg>& OverlapEvent();
+};
+
+} // NS Geometry
+} // NS OpenEngine
+
+#endif // _OE_SWEEP_AND_PRUNE_H_
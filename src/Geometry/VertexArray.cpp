@@ -1,84 +1,95 @@
 // Vertex Array
 // -------------------------------------------------------------------
-// Copyright (C) 2007 OpenEngine.dk (See AUTHORS) 
-// 
-// This program is free software; It is covered by the GNU General 
-// Public License version 2 or any later version. 
-// See the GNU General Public License for more details (see LICENSE). 
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
 //--------------------------------------------------------------------
- 
+
 #include <Geometry/VertexArray.h>
+#include <Utils/Serialization.h>
 #include <Geometry/FaceSet.h>
 #include <Geometry/Material.h>
+#include <Geometry/VertexCodec.h>
+
+#include <cstring>
 
 namespace OpenEngine {
 namespace Geometry {
 
 using OpenEngine::Math::Vector;
+using std::vector;
+
+// alignment of the block and of each stream in it
+static const unsigned long ALIGN = 16;
+
+// floats per vertex of each attribute, and bytes when packed
+static const unsigned int COMPONENTS[] = {3, 3, 4, 2};
+static const unsigned int PACKED_BYTES[] = {6, 4, 4, 4};
+
+static unsigned long Align(unsigned long size) {
+    return (size + ALIGN - 1) & ~(ALIGN - 1);
+}
 
 VertexArray::VertexArray() {
     Init();
 }
 
-VertexArray::VertexArray(FaceSet& faces) {
+/**
+ * Create a vertex array from a face set.
+ *
+ * @param faces Faces to copy, all of the same material.
+ * @param attributes Attributes to store, a combination of
+ * \a Attribute [optional].
+ * @param layout Memory layout [optional].
+ */
+VertexArray::VertexArray(FaceSet& faces, int attributes, Layout layout) {
     Init();
     // Set texture id, which should be the same for all faces in the set
-    this->mat = (*faces.begin())->mat;
-    int faceCount = faces.Size();
-    // Create vertex array
-    pVertices  = new float[faceCount*3*3];
-    pNormals   = new float[faceCount*3*3];
-    pColors    = new float[faceCount*3*4];
-    pTexCoords = new float[faceCount*3*2];
-
-    int index = 0;
-    int texIndex = 0;
-    int colorIndex = 0;
+    if (faces.Size() > 0)
+        this->mat = (*faces.begin())->mat;
+    numFaces = faces.Size();
+    vector<float> none[ATTRIBUTES];
+    Store(none, attributes | VERTICES, 0, layout);
+
+    unsigned int index = 0;
     for (FaceList::iterator itr = faces.begin(); itr != faces.end(); itr++) {
         FacePtr f = (*itr);
         // for each vertex ...
-        for (int i=0; i<3; i++) {
-             // Add each vertex and normal coordinate to array
-            Vector<3,float> v = f->vert[i];
-            Vector<3,float> n = f->norm[i];
-            for(int j=0; j<3; j++) {
-                pVertices[index] = v[j];
-                pNormals[index]  = n[j];
-                index++;
-            }
-
-            // Add texture coords to array
-            Vector<2,float> t = f->texc[i];
-            for( int j=0; j<2; j++ )
-                pTexCoords[texIndex++] = t[j];
-
-            // Add color components to array
-            Vector<4,float> c = f->colr[i];
-            for( int j=0; j<4; j++ )
-                pColors[colorIndex++] = c[j];
+        for (int i=0; i<3; i++, index++) {
+            float* v = Element(0, index);
+            for (int j=0; j<3; j++) v[j] = f->vert[i][j];
+            if (float* n = Element(1, index))
+                for (int j=0; j<3; j++) n[j] = f->norm[i][j];
+            if (float* c = Element(2, index))
+                for (int j=0; j<4; j++) c[j] = f->colr[i][j];
+            if (float* t = Element(3, index))
+                for (int j=0; j<2; j++) t[j] = f->texc[i][j];
         }
     }
-    numFaces = faces.Size();
 }
 
-
 void VertexArray::Init() {
-    pVertices = NULL;
-    pNormals = NULL;
-    pColors = NULL;
-    pTexCoords = NULL;
+    block = NULL;
+    blockSize = 0;
+    for (int i=0; i<ATTRIBUTES; i++) {
+        streams[i] = NULL;
+        packed[i] = NULL;
+    }
+    stride = 0;
+    attributes = 0;
+    formats = 0;
+    layout = PLANAR;
     numFaces = 0;
 }
 
 VertexArray::~VertexArray() {
-    if( pVertices ) delete[] pVertices;
-    if( pNormals  ) delete[] pNormals;
-    if( pColors   ) delete[] pColors;
-    if( pTexCoords) delete[] pTexCoords;
+    delete[] block;
 }
 
 float* VertexArray::GetVertices() {
-    return pVertices;
+    return streams[0];
 }
 
 int VertexArray::GetNumFaces() {
@@ -86,17 +97,315 @@ int VertexArray::GetNumFaces() {
 }
 
 float* VertexArray::GetNormals() {
-    return pNormals;
+    return streams[1];
 }
- 
+
 
 float* VertexArray::GetColors() {
-    return pColors;
+    return streams[2];
 }
 
 float* VertexArray::GetTexCoords() {
-    return pTexCoords;
+    return streams[3];
+}
+
+/**
+ * Get the distance between the float attributes of two vertices.
+ *
+ * @return Stride in bytes, or zero for tightly packed (planar) arrays.
+ */
+unsigned int VertexArray::GetStride() {
+    return stride;
+}
+
+/**
+ * Get the stored attributes.
+ *
+ * @return Combination of \a Attribute.
+ */
+int VertexArray::GetAttributes() {
+    return attributes;
+}
+
+/**
+ * Get the memory layout.
+ *
+ * @return Layout.
+ */
+VertexArray::Layout VertexArray::GetLayout() {
+    return layout;
+}
+
+/**
+ * Change the memory layout.
+ *
+ * @param layout New layout.
+ */
+void VertexArray::SetLayout(Layout layout) {
+    if (layout != this->layout) Rebuild(attributes, formats, layout);
+}
+
+/**
+ * Copy an attribute to a tightly packed array.
+ * Works for any layout and for compressed attributes.
+ *
+ * @param attribute Attribute to copy.
+ * @param out Array of \a GetNumFaces()*3 elements.
+ */
+void VertexArray::GetAttribute(Attribute attribute, float* out) {
+    vector<float> data[ATTRIBUTES];
+    for (int a=0; a<ATTRIBUTES; a++) {
+        if (attribute != 1 << a || !(attributes & attribute)) continue;
+        if (formats & attribute) {
+            Extract(data);
+            if (!data[a].empty())
+                memcpy(out, &data[a][0], data[a].size() * sizeof(float));
+            return;
+        }
+        for (unsigned int i=0; i<(unsigned int)numFaces*3; i++)
+            memcpy(out + i * COMPONENTS[a], Element(a, i),
+                   COMPONENTS[a] * sizeof(float));
+    }
+}
+
+/**
+ * Set an attribute from a tightly packed array.
+ * The attribute is added if it is not stored yet, and decompressed
+ * if it is compressed.
+ *
+ * @param attribute Attribute to set.
+ * @param in Array of \a GetNumFaces()*3 elements.
+ */
+void VertexArray::SetAttribute(Attribute attribute, const float* in) {
+    if (!(attributes & attribute) || (formats & attribute))
+        Rebuild(attributes | attribute, formats & ~attribute, layout);
+    for (int a=0; a<ATTRIBUTES; a++) {
+        if (attribute != 1 << a) continue;
+        for (unsigned int i=0; i<(unsigned int)numFaces*3; i++)
+            memcpy(Element(a, i), in + i * COMPONENTS[a],
+                   COMPONENTS[a] * sizeof(float));
+    }
+}
+
+/**
+ * Compress streams to packed formats.
+ * Streams that are missing or already compressed are skipped.
+ *
+ * @param formats Streams to compress, a combination of \a Format.
+ */
+void VertexArray::Compress(int formats) {
+    formats &= attributes & ~this->formats;
+    if (formats) Rebuild(attributes, this->formats | formats, layout);
+}
+
+/**
+ * Restore compressed streams to floats.
+ *
+ * @param formats Streams to decompress, a combination of \a Format.
+ */
+void VertexArray::Decompress(int formats) {
+    formats &= this->formats;
+    if (formats) Rebuild(attributes, this->formats & ~formats, layout);
+}
+
+/**
+ * Get the compressed streams.
+ *
+ * @return Combination of \a Format.
+ */
+int VertexArray::GetFormats() {
+    return formats;
+}
+
+/**
+ * Quantized vertices, three per vertex, or NULL if not compressed.
+ */
+boost::uint16_t* VertexArray::GetPackedVertices() {
+    return (boost::uint16_t*)packed[0];
+}
+
+/**
+ * Octahedral normals, two per vertex, or NULL if not compressed.
+ */
+boost::int16_t* VertexArray::GetPackedNormals() {
+    return (boost::int16_t*)packed[1];
+}
+
+/**
+ * RGBA colors, four bytes per vertex, or NULL if not compressed.
+ */
+boost::uint8_t* VertexArray::GetPackedColors() {
+    return (boost::uint8_t*)packed[2];
+}
+
+/**
+ * Half float texture coordinates, two per vertex, or NULL if not
+ * compressed.
+ */
+boost::uint16_t* VertexArray::GetPackedTexCoords() {
+    return (boost::uint16_t*)packed[3];
+}
+
+/**
+ * Offset of the quantized vertices.
+ */
+Vector<3,float> VertexArray::GetPositionOffset() {
+    return posOffset;
+}
+
+/**
+ * Scale of the quantized vertices.
+ */
+Vector<3,float> VertexArray::GetPositionScale() {
+    return posScale;
+}
+
+/**
+ * Get the size of the vertex data in its current formats.
+ *
+ * @return Size in bytes.
+ */
+unsigned long VertexArray::GetDataSize() {
+    return blockSize;
+}
+
+/**
+ * Get the float attribute of a vertex.
+ *
+ * @return Pointer to the first component, or NULL if not stored.
+ */
+float* VertexArray::Element(int attribute, unsigned int vertex) {
+    if (streams[attribute] == NULL) return NULL;
+    unsigned int step = stride ? stride / sizeof(float) : COMPONENTS[attribute];
+    return streams[attribute] + vertex * step;
+}
+
+/**
+ * Copy all attributes to tightly packed arrays, decoding the packed
+ * ones. Missing attributes are left empty.
+ */
+void VertexArray::Extract(vector<float> data[ATTRIBUTES]) const {
+    unsigned int count = numFaces * 3;
+    for (int a=0; a<ATTRIBUTES; a++) {
+        data[a].clear();
+        if (!(attributes & (1 << a)) || count == 0) continue;
+        data[a].resize(count * COMPONENTS[a]);
+        float* out = &data[a][0];
+        if (packed[a]) {
+            switch (a) {
+            case 0:
+                VertexCodec::DecodePositions((boost::uint16_t*)packed[a], count,
+                                             posOffset, posScale, out);
+                break;
+            case 1:
+                VertexCodec::DecodeNormals((boost::int16_t*)packed[a], count, out);
+                break;
+            case 2:
+                VertexCodec::DecodeColors((boost::uint8_t*)packed[a], count, out);
+                break;
+            case 3:
+                VertexCodec::DecodeHalf((boost::uint16_t*)packed[a], count * 2, out);
+                break;
+            }
+            continue;
+        }
+        unsigned int step = stride ? stride / sizeof(float) : COMPONENTS[a];
+        for (unsigned int i=0; i<count; i++)
+            memcpy(out + i * COMPONENTS[a], streams[a] + i * step,
+                   COMPONENTS[a] * sizeof(float));
+    }
+}
+
+/**
+ * Replace the block with a new one holding the given attributes in
+ * the given formats and layout. Attributes with no data are zero
+ * filled.
+ */
+void VertexArray::Store(const vector<float> data[ATTRIBUTES], int attributes,
+                        int formats, Layout layout) {
+    unsigned int count = numFaces * 3;
+    attributes &= ALL_ATTRIBUTES;
+    formats &= attributes;
+
+    // lay out the streams: interleaved floats first, then each planar
+    // float stream, then each packed stream, all aligned
+    unsigned long offsets[ATTRIBUTES];
+    unsigned long packedOffsets[ATTRIBUTES];
+    unsigned long size = 0;
+    unsigned int floats = 0;
+    for (int a=0; a<ATTRIBUTES; a++) {
+        if (!(attributes & (1 << a)) || (formats & (1 << a))) continue;
+        if (layout == INTERLEAVED) {
+            offsets[a] = floats * sizeof(float);
+            floats += COMPONENTS[a];
+        } else {
+            offsets[a] = size;
+            size = Align(size + count * COMPONENTS[a] * sizeof(float));
+        }
+    }
+    if (layout == INTERLEAVED)
+        size = Align(count * floats * sizeof(float));
+    for (int a=0; a<ATTRIBUTES; a++) {
+        if (!(formats & (1 << a))) continue;
+        packedOffsets[a] = size;
+        size = Align(size + count * PACKED_BYTES[a]);
+    }
+
+    char* old = block;
+    block = new char[size + ALIGN];
+    memset(block, 0, size + ALIGN);
+    char* base = block + (ALIGN - (unsigned long)block % ALIGN) % ALIGN;
+    blockSize = size;
+    stride = layout == INTERLEAVED ? floats * sizeof(float) : 0;
+    this->attributes = attributes;
+    this->formats = formats;
+    this->layout = layout;
+
+    for (int a=0; a<ATTRIBUTES; a++) {
+        streams[a] = NULL;
+        packed[a] = NULL;
+        bool has = (attributes & (1 << a)) && data[a].size() >= count * COMPONENTS[a]
+            && count > 0;
+        if (formats & (1 << a)) {
+            packed[a] = base + packedOffsets[a];
+            if (!has) continue;
+            const float* in = &data[a][0];
+            switch (a) {
+            case 0:
+                VertexCodec::EncodePositions(in, count, (boost::uint16_t*)packed[a],
+                                             posOffset, posScale);
+                break;
+            case 1:
+                VertexCodec::EncodeNormals(in, count, (boost::int16_t*)packed[a]);
+                break;
+            case 2:
+                VertexCodec::EncodeColors(in, count, (boost::uint8_t*)packed[a]);
+                break;
+            case 3:
+                VertexCodec::EncodeHalf(in, count * 2, (boost::uint16_t*)packed[a]);
+                break;
+            }
+        } else if (attributes & (1 << a)) {
+            streams[a] = (float*)(base + offsets[a]);
+            if (!has) continue;
+            for (unsigned int i=0; i<count; i++)
+                memcpy(Element(a, i), &data[a][i * COMPONENTS[a]],
+                       COMPONENTS[a] * sizeof(float));
+        }
+    }
+    delete[] old;
+}
+
+/**
+ * Move the current data to a new attribute set, format and layout.
+ */
+void VertexArray::Rebuild(int attributes, int formats, Layout layout) {
+    vector<float> data[ATTRIBUTES];
+    Extract(data);
+    Store(data, attributes, formats, layout);
 }
 
 } // NS Gemometry
 } // NS OpenEngine
+
+BOOST_CLASS_EXPORT_IMPLEMENT(OpenEngine::Geometry::VertexArray)
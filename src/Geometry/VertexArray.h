@@ -11,8 +11,14 @@
 #define _OE_VERTEX_ARRAY_H_
 
 #include <Geometry/Material.h>
+#include <Math/Vector.h>
+#include <vector>
+#include <boost/cstdint.hpp>
 #include <boost/serialization/utility.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/split_member.hpp>
 #include <boost/serialization/export.hpp>
+#include <boost/serialization/version.hpp>
 
 namespace OpenEngine {
 namespace Geometry {
@@ -22,12 +28,71 @@ class FaceSet;
 /**
  * Vertex Array.
  *
+ * The attributes of all vertices are kept in a single aligned
+ * allocation, either planar (one tightly packed array per attribute)
+ * or interleaved (all attributes of a vertex next to each other).
+ * Only the attributes in the attribute mask are stored, so geometry
+ * that is never lit or colored need not carry normals or colors:
+ * @code
+ * VertexArray* va = new VertexArray(faces, VertexArray::VERTICES |
+ *                                          VertexArray::TEXCOORDS,
+ *                                   VertexArray::INTERLEAVED);
+ * glVertexPointer(3, GL_FLOAT, va->GetStride(), va->GetVertices());
+ * @endcode
+ * The stride is given in bytes, and is zero for planar arrays, as in
+ * OpenGL. Missing attributes have NULL accessors.
+ *
+ * The streams can also be compressed to formats graphics cards read
+ * directly (see \a VertexCodec), which shrinks the vertex data from
+ * 48 to 18 bytes per vertex:
+ * @code
+ * va->Compress();                          // all streams
+ * uint16_t* pos = va->GetPackedVertices(); // pos * scale + offset
+ * @endcode
+ * Packed streams are always planar. The float accessors return NULL
+ * for a compressed stream, as decompressing would move all streams
+ * and change the stride under pointers already handed out. Code
+ * unaware of the packed formats reads through \a GetAttribute, or
+ * calls \a Decompress first.
+ *
  * @class VertexArray VertexArray.h Geometry/VertexArray.h
  */
 class VertexArray {
 public:
+
+    /**
+     * Vertex attributes.
+     */
+    enum Attribute {
+        VERTICES       = 1,
+        NORMALS        = 2,
+        COLORS         = 4,
+        TEXCOORDS      = 8,
+        ALL_ATTRIBUTES = 15
+    };
+
+    /**
+     * Memory layout of the float attributes.
+     */
+    enum Layout {
+        PLANAR,                 //!< one array per attribute
+        INTERLEAVED             //!< one array of whole vertices
+    };
+
+    /**
+     * Compressed stream formats, one per attribute.
+     */
+    enum Format {
+        POSITION_16   = VERTICES,   //!< 16 bit positions quantized to the bounds
+        NORMAL_OCT16  = NORMALS,    //!< octahedral normals, 2 x 16 bit
+        COLOR_RGBA8   = COLORS,     //!< 8 bit RGBA colors
+        TEXCOORD_HALF = TEXCOORDS,  //!< half float texture coordinates
+        COMPRESS_ALL  = ALL_ATTRIBUTES
+    };
+
     VertexArray();
-    explicit VertexArray(FaceSet& faces);
+    explicit VertexArray(FaceSet& faces, int attributes = ALL_ATTRIBUTES,
+                         Layout layout = PLANAR);
     virtual ~VertexArray();
 
     MaterialPtr mat;            //!< Shared material definition
@@ -36,36 +101,101 @@ public:
     float* GetNormals();
     float* GetColors();
     float* GetTexCoords();
+    unsigned int GetStride();
 
     int GetNumFaces();
+    int GetAttributes();
+    Layout GetLayout();
+    void SetLayout(Layout layout);
+
+    void GetAttribute(Attribute attribute, float* out);
+    void SetAttribute(Attribute attribute, const float* in);
+
+    void Compress(int formats = COMPRESS_ALL);
+    void Decompress(int formats = COMPRESS_ALL);
+    int GetFormats();
+
+    boost::uint16_t* GetPackedVertices();
+    boost::int16_t* GetPackedNormals();
+    boost::uint8_t* GetPackedColors();
+    boost::uint16_t* GetPackedTexCoords();
+    Math::Vector<3,float> GetPositionOffset();
+    Math::Vector<3,float> GetPositionScale();
+
+    unsigned long GetDataSize();
 
 private:
-    float* pVertices;           //!< Pointer to vertex array
-    float* pNormals;            //!< Pointer to normal array
-    float* pColors;             //!< Pointer to color array
-    float* pTexCoords;          //!< Pointer to texture coordinate array
+    static const int ATTRIBUTES = 4;
+
+    char* block;                //!< The allocation holding all streams
+    unsigned long blockSize;    //!< Bytes of vertex data in the block
+    float* streams[ATTRIBUTES]; //!< Float streams, NULL if absent or packed
+    void* packed[ATTRIBUTES];   //!< Packed streams, NULL if not packed
+    unsigned int stride;        //!< Bytes between interleaved vertices
+    int attributes;             //!< Stored attributes
+    int formats;                //!< Compressed attributes
+    Layout layout;
+    Math::Vector<3,float> posOffset;
+    Math::Vector<3,float> posScale;
 
     int numFaces;
 
     void Init();
+    float* Element(int attribute, unsigned int vertex);
+    void Extract(std::vector<float> data[ATTRIBUTES]) const;
+    void Store(const std::vector<float> data[ATTRIBUTES], int attributes,
+               int formats, Layout layout);
+    void Rebuild(int attributes, int formats, Layout layout);
 
     friend class boost::serialization::access;
     template<class Archive>
-    void serialize(Archive & ar, const unsigned int version) {
+    void save(Archive & ar, const unsigned int version) const {
+        std::vector<float> data[ATTRIBUTES];
+        Extract(data);
+        int l = layout;
         ar & numFaces;
-        for (int i=0; i<numFaces; i++) {
-            ar & pVertices[i];
-            ar & pNormals[i];
-            ar & pColors[i];
-            ar & pTexCoords[i];
+        ar & attributes;
+        ar & formats;
+        ar & l;
+        for (int i=0; i<ATTRIBUTES; i++)
+            ar & data[i];
+    }
+    template<class Archive>
+    void load(Archive & ar, const unsigned int version) {
+        std::vector<float> data[ATTRIBUTES];
+        if (version == 0) {
+            // the first numFaces floats of each array, interleaved,
+            // the rest of the vertices are zero
+            static const int floatsPerFace[ATTRIBUTES] = {9, 9, 12, 6};
+            ar & numFaces;
+            for (int i=0; i<numFaces; i++)
+                for (int j=0; j<ATTRIBUTES; j++) {
+                    float x;
+                    ar & x;
+                    data[j].push_back(x);
+                }
+            for (int i=0; i<ATTRIBUTES; i++)
+                data[i].resize(numFaces * floatsPerFace[i]);
+            Store(data, ALL_ATTRIBUTES, 0, PLANAR);
+            return;
         }
+        int a, f, l;
+        ar & numFaces;
+        ar & a;
+        ar & f;
+        ar & l;
+        for (int i=0; i<ATTRIBUTES; i++)
+            ar & data[i];
+        Store(data, a, f, (Layout)l);
     }
+    BOOST_SERIALIZATION_SPLIT_MEMBER()
 
 };
 
 } // NS Geometry
 } // NS OpenEngine
 
-BOOST_CLASS_EXPORT(OpenEngine::Geometry::VertexArray)
+BOOST_CLASS_VERSION(OpenEngine::Geometry::VertexArray, 1)
+BOOST_CLASS_EXPORT_KEY(OpenEngine::Geometry::VertexArray)
 
 #endif // _VERTEX_ARRAY_H_
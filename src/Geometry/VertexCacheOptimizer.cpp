@@ -0,0 +1,228 @@
+// Vertex cache optimizer.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Geometry/VertexCacheOptimizer.h>
+#include <Core/Exceptions.h>
+
+#include <vector>
+#include <cstring>
+
+namespace OpenEngine {
+namespace Geometry {
+
+using std::vector;
+using OpenEngine::Core::Exception;
+
+static const unsigned int NONE = 0xFFFFFFFF;
+
+/**
+ * Create an optimizer.
+ *
+ * @param cacheSize Number of vertices in the simulated cache
+ * [optional].
+ */
+VertexCacheOptimizer::VertexCacheOptimizer(unsigned int cacheSize)
+    : cacheSize(cacheSize), before(0.0f), after(0.0f) {}
+
+/**
+ * Destructor.
+ */
+VertexCacheOptimizer::~VertexCacheOptimizer() {}
+
+/**
+ * Set the cache size to optimize for.
+ *
+ * @param cacheSize Number of vertices in the cache.
+ */
+void VertexCacheOptimizer::SetCacheSize(unsigned int cacheSize) {
+    this->cacheSize = cacheSize;
+}
+
+/**
+ * Get the cache size optimized for.
+ *
+ * @return Number of vertices in the cache.
+ */
+unsigned int VertexCacheOptimizer::GetCacheSize() const {
+    return cacheSize;
+}
+
+/**
+ * Reorder the triangles of an index buffer for the vertex cache.
+ * The ACMR before and after is recorded.
+ *
+ * @param indices Triangle list to reorder in place.
+ * @param numIndices Number of indices, three per triangle.
+ * @param numVertices Number of vertices the indices refer to.
+ * @throws Exception if an index is out of range.
+ */
+void VertexCacheOptimizer::Optimize(unsigned int* indices, unsigned int numIndices,
+                                    unsigned int numVertices) {
+    const unsigned int triangles = numIndices / 3;
+    const unsigned int k = cacheSize;
+    before = ACMR(indices, numIndices, numVertices, k);
+
+    // triangles by vertex (counting sort)
+    vector<unsigned int> live(numVertices, 0);
+    for (unsigned int i=0; i<triangles*3; i++) {
+        if (indices[i] >= numVertices)
+            throw Exception("Vertex index out of range in cache optimizer");
+        live[indices[i]]++;
+    }
+    vector<unsigned int> first(numVertices + 1, 0);
+    for (unsigned int v=0; v<numVertices; v++)
+        first[v + 1] = first[v] + live[v];
+    vector<unsigned int> adjacent(triangles * 3);
+    vector<unsigned int> fill(first.begin(), first.end() - 1);
+    for (unsigned int i=0; i<triangles*3; i++)
+        adjacent[fill[indices[i]]++] = i / 3;
+
+    vector<unsigned int> output;
+    output.reserve(triangles * 3);
+    vector<unsigned int> stamp(numVertices, 0);
+    vector<char> emitted(triangles, 0);
+    vector<unsigned int> deadEnd;
+    vector<unsigned int> candidates;
+    unsigned int time = k + 1;
+    unsigned int cursor = 0;
+
+    // start at the first used vertex
+    unsigned int fan = NONE;
+    while (cursor < numVertices && live[cursor] == 0) cursor++;
+    if (cursor < numVertices) fan = cursor;
+
+    while (fan != NONE) {
+        // emit the remaining triangles around the fanning vertex
+        candidates.clear();
+        for (unsigned int a=first[fan]; a<first[fan+1]; a++) {
+            unsigned int t = adjacent[a];
+            if (emitted[t]) continue;
+            emitted[t] = 1;
+            for (unsigned int c=0; c<3; c++) {
+                unsigned int v = indices[t*3+c];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - stamp[v] > k) stamp[v] = time++;
+            }
+        }
+
+        // prefer the candidate that is in the cache and stays there
+        // while its remaining triangles are emitted
+        fan = NONE;
+        int priority = -1;
+        for (unsigned int i=0; i<candidates.size(); i++) {
+            unsigned int v = candidates[i];
+            if (live[v] == 0) continue;
+            int p = 0;
+            if (time - stamp[v] + 2 * live[v] <= k) p = time - stamp[v];
+            if (p > priority) {
+                priority = p;
+                fan = v;
+            }
+        }
+        if (fan != NONE) continue;
+
+        // dead end: take the latest vertex with triangles left, or
+        // the next one in input order
+        while (!deadEnd.empty() && fan == NONE) {
+            unsigned int v = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[v] > 0) fan = v;
+        }
+        while (fan == NONE && cursor < numVertices) {
+            if (live[cursor] > 0) fan = cursor;
+            cursor++;
+        }
+    }
+
+    if (!output.empty())
+        memcpy(indices, &output[0], output.size() * sizeof(unsigned int));
+    after = ACMR(indices, numIndices, numVertices, k);
+}
+
+/**
+ * Reorder the vertices in the order they are first used by the
+ * indices, and update the indices to match. Unused vertices are
+ * dropped.
+ *
+ * @param indices Triangle list to update in place.
+ * @param numIndices Number of indices.
+ * @param vertices Vertex data to reorder in place.
+ * @param numVertices Number of vertices.
+ * @param stride Floats per vertex.
+ * @return Number of vertices left.
+ * @throws Exception if an index is out of range.
+ */
+unsigned int VertexCacheOptimizer::OptimizeFetch(unsigned int* indices,
+                                                 unsigned int numIndices,
+                                                 float* vertices,
+                                                 unsigned int numVertices,
+                                                 unsigned int stride) {
+    vector<unsigned int> remap(numVertices, NONE);
+    unsigned int next = 0;
+    for (unsigned int i=0; i<numIndices; i++) {
+        unsigned int v = indices[i];
+        if (v >= numVertices)
+            throw Exception("Vertex index out of range in cache optimizer");
+        if (remap[v] == NONE) remap[v] = next++;
+        indices[i] = remap[v];
+    }
+    if (next == 0) return 0;
+    vector<float> reordered(next * stride);
+    for (unsigned int v=0; v<numVertices; v++)
+        if (remap[v] != NONE)
+            memcpy(&reordered[remap[v] * stride], vertices + v * stride,
+                   stride * sizeof(float));
+    memcpy(vertices, &reordered[0], reordered.size() * sizeof(float));
+    return next;
+}
+
+/**
+ * Get the ACMR of the last optimized buffer before optimizing.
+ */
+float VertexCacheOptimizer::GetACMRBefore() const {
+    return before;
+}
+
+/**
+ * Get the ACMR of the last optimized buffer after optimizing.
+ */
+float VertexCacheOptimizer::GetACMRAfter() const {
+    return after;
+}
+
+/**
+ * Compute the average cache miss ratio of an index buffer.
+ *
+ * @param indices Triangle list.
+ * @param numIndices Number of indices.
+ * @param numVertices Number of vertices.
+ * @param cacheSize Size of the simulated FIFO cache.
+ * @return Cache misses per triangle.
+ */
+float VertexCacheOptimizer::ACMR(const unsigned int* indices, unsigned int numIndices,
+                                 unsigned int numVertices, unsigned int cacheSize) {
+    unsigned int triangles = numIndices / 3;
+    if (triangles == 0) return 0.0f;
+    // a vertex is cached if it entered within the last cacheSize misses
+    vector<unsigned int> entered(numVertices, NONE);
+    unsigned int misses = 0;
+    for (unsigned int i=0; i<triangles*3; i++) {
+        unsigned int v = indices[i];
+        if (v >= numVertices) continue;
+        if (entered[v] == NONE || misses - entered[v] >= cacheSize)
+            entered[v] = misses++;
+    }
+    return (float)misses / triangles;
+}
+
+} // NS Geometry
+} // NS OpenEngine
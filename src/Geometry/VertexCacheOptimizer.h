@@ -0,0 +1,69 @@
+// Vertex cache optimizer.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_VERTEX_CACHE_OPTIMIZER_H_
+#define _OE_VERTEX_CACHE_OPTIMIZER_H_
+
+namespace OpenEngine {
+namespace Geometry {
+
+/**
+ * Vertex cache optimizer.
+ * Reorders the triangles of an index buffer so vertices are reused
+ * while they are still in the post-transform cache of the graphics
+ * card, and then reorders the vertices in the order they are first
+ * used, so they are fetched sequentially. Both passes run in linear
+ * time and are meant for preparing geometry when it is loaded or
+ * cooked, not for every frame.
+ *
+ * The triangle order is computed with the Tipsify algorithm (Sander,
+ * Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality
+ * and Reduced Overdraw", 2007). The effect is measured as the average
+ * cache miss ratio (ACMR): transformed vertices per triangle for a
+ * FIFO cache, between 0.5 for an ideal mesh and 3.
+ *
+ * @code
+ * VertexCacheOptimizer opt(16);
+ * opt.Optimize(indices, numIndices, numVertices);
+ * numVertices = opt.OptimizeFetch(indices, numIndices, vertices, numVertices, 8);
+ * logger.info << "ACMR " << opt.GetACMRBefore()
+ *             << " -> " << opt.GetACMRAfter() << logger.end;
+ * @endcode
+ *
+ * @class VertexCacheOptimizer VertexCacheOptimizer.h Geometry/VertexCacheOptimizer.h
+ */
+class VertexCacheOptimizer {
+public:
+    explicit VertexCacheOptimizer(unsigned int cacheSize = 16);
+    virtual ~VertexCacheOptimizer();
+
+    void SetCacheSize(unsigned int cacheSize);
+    unsigned int GetCacheSize() const;
+
+    void Optimize(unsigned int* indices, unsigned int numIndices,
+                  unsigned int numVertices);
+    unsigned int OptimizeFetch(unsigned int* indices, unsigned int numIndices,
+                               float* vertices, unsigned int numVertices,
+                               unsigned int stride);
+
+    float GetACMRBefore() const;
+    float GetACMRAfter() const;
+
+    static float ACMR(const unsigned int* indices, unsigned int numIndices,
+                      unsigned int numVertices, unsigned int cacheSize);
+
+private:
+    unsigned int cacheSize;
+    float before, after;
+};
+
+} // NS Geometry
+} // NS OpenEngine
+
+#endif // _OE_VERTEX_CACHE_OPTIMIZER_H_
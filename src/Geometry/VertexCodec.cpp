@@ -0,0 +1,226 @@
+// Vertex attribute codec.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Geometry/VertexCodec.h>
+
+#include <cmath>
+#include <cstring>
+
+namespace OpenEngine {
+namespace Geometry {
+
+using boost::int16_t;
+using boost::uint8_t;
+using boost::uint16_t;
+using boost::uint32_t;
+
+/**
+ * Quantize positions to 16 bits per component.
+ *
+ * @param in Positions, three floats each.
+ * @param count Number of positions.
+ * @param out Quantized positions, three per position.
+ * @param offset Set to the lower bound of the positions.
+ * @param scale Set to the size of a quantization step per axis.
+ */
+void VertexCodec::EncodePositions(const float* in, unsigned int count,
+                                  uint16_t* out,
+                                  Vector<3,float>& offset, Vector<3,float>& scale) {
+    float lo[3] = {0, 0, 0}, hi[3] = {0, 0, 0};
+    if (count > 0)
+        for (int k=0; k<3; k++) lo[k] = hi[k] = in[k];
+    for (unsigned int i=0; i<count; i++)
+        for (int k=0; k<3; k++) {
+            float v = in[i*3+k];
+            if (v < lo[k]) lo[k] = v;
+            if (v > hi[k]) hi[k] = v;
+        }
+    float inv[3];
+    for (int k=0; k<3; k++) {
+        float range = hi[k] - lo[k];
+        offset[k] = lo[k];
+        scale[k] = range / 65535.0f;
+        inv[k] = range > 0.0f ? 65535.0f / range : 0.0f;
+    }
+    for (unsigned int i=0; i<count; i++)
+        for (int k=0; k<3; k++)
+            out[i*3+k] = (uint16_t)((in[i*3+k] - lo[k]) * inv[k] + 0.5f);
+}
+
+/**
+ * Restore quantized positions.
+ *
+ * @param in Quantized positions, three per position.
+ * @param count Number of positions.
+ * @param offset Lower bound of the positions.
+ * @param scale Size of a quantization step per axis.
+ * @param out Positions, three floats each.
+ */
+void VertexCodec::DecodePositions(const uint16_t* in, unsigned int count,
+                                  const Vector<3,float>& offset,
+                                  const Vector<3,float>& scale, float* out) {
+    const float o[3] = {offset.Get(0), offset.Get(1), offset.Get(2)};
+    const float s[3] = {scale.Get(0), scale.Get(1), scale.Get(2)};
+    for (unsigned int i=0; i<count; i++)
+        for (int k=0; k<3; k++)
+            out[i*3+k] = o[k] + in[i*3+k] * s[k];
+}
+
+/**
+ * Encode unit normals in octahedral mapping.
+ * The normal is projected onto the octahedron |x|+|y|+|z| = 1, whose
+ * lower half is folded over the upper half, and the resulting x and y
+ * are stored as signed 16 bit values. The largest angular error is
+ * about 0.04 degrees.
+ *
+ * @param in Normals, three floats each.
+ * @param count Number of normals.
+ * @param out Encoded normals, two per normal.
+ */
+void VertexCodec::EncodeNormals(const float* in, unsigned int count, int16_t* out) {
+    for (unsigned int i=0; i<count; i++) {
+        float x = in[i*3], y = in[i*3+1], z = in[i*3+2];
+        float l = fabs(x) + fabs(y) + fabs(z);
+        float inv = l > 0.0f ? 1.0f / l : 0.0f;
+        x *= inv; y *= inv; z *= inv;
+        if (z < 0.0f) {
+            float fx = (1.0f - fabs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+            float fy = (1.0f - fabs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+            x = fx; y = fy;
+        }
+        out[i*2]   = (int16_t)floor(x * 32767.0f + 0.5f);
+        out[i*2+1] = (int16_t)floor(y * 32767.0f + 0.5f);
+    }
+}
+
+/**
+ * Decode octahedral normals to unit normals.
+ *
+ * @param in Encoded normals, two per normal.
+ * @param count Number of normals.
+ * @param out Normals, three floats each.
+ */
+void VertexCodec::DecodeNormals(const int16_t* in, unsigned int count, float* out) {
+    for (unsigned int i=0; i<count; i++) {
+        float x = in[i*2]   / 32767.0f;
+        float y = in[i*2+1] / 32767.0f;
+        float z = 1.0f - fabs(x) - fabs(y);
+        float t = z < 0.0f ? -z : 0.0f;
+        x += x >= 0.0f ? -t : t;
+        y += y >= 0.0f ? -t : t;
+        float l = sqrt(x*x + y*y + z*z);
+        float inv = l > 0.0f ? 1.0f / l : 0.0f;
+        out[i*3]   = x * inv;
+        out[i*3+1] = y * inv;
+        out[i*3+2] = z * inv;
+    }
+}
+
+/**
+ * Encode colors as 8 bit RGBA.
+ *
+ * @param in Colors, four floats in [0,1] each; clamped.
+ * @param count Number of colors.
+ * @param out Encoded colors, four bytes per color.
+ */
+void VertexCodec::EncodeColors(const float* in, unsigned int count, uint8_t* out) {
+    for (unsigned int i=0; i<count*4; i++) {
+        float c = in[i];
+        c = c < 0.0f ? 0.0f : (c > 1.0f ? 1.0f : c);
+        out[i] = (uint8_t)(c * 255.0f + 0.5f);
+    }
+}
+
+/**
+ * Decode 8 bit RGBA colors.
+ *
+ * @param in Encoded colors, four bytes per color.
+ * @param count Number of colors.
+ * @param out Colors, four floats each.
+ */
+void VertexCodec::DecodeColors(const uint8_t* in, unsigned int count, float* out) {
+    for (unsigned int i=0; i<count*4; i++)
+        out[i] = in[i] * (1.0f / 255.0f);
+}
+
+/**
+ * Convert floats to half floats.
+ *
+ * @param in Floats.
+ * @param count Number of floats.
+ * @param out Half floats.
+ */
+void VertexCodec::EncodeHalf(const float* in, unsigned int count, uint16_t* out) {
+    for (unsigned int i=0; i<count; i++)
+        out[i] = FloatToHalf(in[i]);
+}
+
+/**
+ * Convert half floats to floats.
+ *
+ * @param in Half floats.
+ * @param count Number of half floats.
+ * @param out Floats.
+ */
+void VertexCodec::DecodeHalf(const uint16_t* in, unsigned int count, float* out) {
+    for (unsigned int i=0; i<count; i++)
+        out[i] = HalfToFloat(in[i]);
+}
+
+/**
+ * Convert a float to a half float, rounding to nearest even.
+ * Values too large for a half float become infinity.
+ *
+ * @param f Float.
+ * @return Half float bits.
+ */
+uint16_t VertexCodec::FloatToHalf(float f) {
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    uint16_t sign = (u >> 16) & 0x8000;
+    u &= 0x7FFFFFFF;
+    if (u > 0x7F800000) return sign | 0x7E00;           // NaN
+    if (u >= 0x477FF000) return sign | 0x7C00;          // overflow
+    if (u < 0x38800000) {                               // subnormal
+        float a;
+        memcpy(&a, &u, sizeof(a));
+        return sign | (uint16_t)floor(a * 16777216.0f + 0.5f);
+    }
+    u -= 0x38000000;                                    // rebias exponent
+    u += 0x0FFF + ((u >> 13) & 1);
+    return sign | (uint16_t)(u >> 13);
+}
+
+/**
+ * Convert a half float to a float.
+ *
+ * @param h Half float bits.
+ * @return Float.
+ */
+float VertexCodec::HalfToFloat(uint16_t h) {
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+    uint32_t exponent = (h >> 10) & 0x1F;
+    uint32_t mantissa = h & 0x3FF;
+    uint32_t u;
+    if (exponent == 0) {
+        float f = mantissa * (1.0f / 16777216.0f);
+        memcpy(&u, &f, sizeof(u));
+        u |= sign;
+    } else if (exponent == 31) {
+        u = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        u = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+} // NS Geometry
+} // NS OpenEngine
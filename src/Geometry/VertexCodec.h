@@ -0,0 +1,68 @@
+// Vertex attribute codec.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_VERTEX_CODEC_H_
+#define _OE_VERTEX_CODEC_H_
+
+#include <Math/Vector.h>
+#include <boost/cstdint.hpp>
+
+namespace OpenEngine {
+namespace Geometry {
+
+using OpenEngine::Math::Vector;
+
+/**
+ * Vertex attribute codec.
+ * Conversions between float vertex streams and compact formats that
+ * graphics cards read directly:
+ *   - positions as 16 bit unsigned integers quantized against the
+ *     bounds of the stream, decoded as \a offset + \a q * \a scale,
+ *   - unit normals as two 16 bit signed integers in octahedral
+ *     mapping,
+ *   - colors as 8 bit RGBA,
+ *   - texture coordinates (or any value) as 16 bit half floats.
+ *
+ * All functions work on whole streams with branch-free inner loops,
+ * so the compiler can vectorize them.
+ *
+ * @class VertexCodec VertexCodec.h Geometry/VertexCodec.h
+ */
+class VertexCodec {
+public:
+    static void EncodePositions(const float* in, unsigned int count,
+                                boost::uint16_t* out,
+                                Vector<3,float>& offset, Vector<3,float>& scale);
+    static void DecodePositions(const boost::uint16_t* in, unsigned int count,
+                                const Vector<3,float>& offset,
+                                const Vector<3,float>& scale, float* out);
+
+    static void EncodeNormals(const float* in, unsigned int count,
+                              boost::int16_t* out);
+    static void DecodeNormals(const boost::int16_t* in, unsigned int count,
+                              float* out);
+
+    static void EncodeColors(const float* in, unsigned int count,
+                             boost::uint8_t* out);
+    static void DecodeColors(const boost::uint8_t* in, unsigned int count,
+                             float* out);
+
+    static void EncodeHalf(const float* in, unsigned int count,
+                           boost::uint16_t* out);
+    static void DecodeHalf(const boost::uint16_t* in, unsigned int count,
+                           float* out);
+
+    static boost::uint16_t FloatToHalf(float f);
+    static float HalfToFloat(boost::uint16_t h);
+};
+
+} // NS Geometry
+} // NS OpenEngine
+
+#endif // _OE_VERTEX_CODEC_H_
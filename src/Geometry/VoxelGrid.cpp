@@ -0,0 +1,526 @@
+// Voxel occupancy grid.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Geometry/VoxelGrid.h>
+#include <Geometry/FaceSet.h>
+#include <Geometry/Face.h>
+#include <Geometry/Box.h>
+
+#include <cmath>
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+namespace OpenEngine {
+namespace Geometry {
+
+using boost::uint32_t;
+using boost::uint64_t;
+
+const unsigned int VoxelGrid::BRICK_SIZE;
+const unsigned int VoxelGrid::EMPTY_BRICK;
+
+// tile side in voxels, along y and z
+static const unsigned int TILE = 16;
+
+// faces below which voxelizing is not worth a thread
+static const unsigned int PARALLEL_THRESHOLD = 1 << 12;
+
+// The faces are tested in grid space, where voxel (x,y,z) spans
+// [x,x+1] x [y,y+1] x [z,z+1]. The surface test is the triangle/box
+// overlap test of Schwarz and Seidel: the plane of the face must
+// cross the voxel, and the projections of the voxel onto the three
+// axis planes must overlap the projections of the face. Every test is
+// linear in x, so each row is clipped to an interval of voxels.
+
+// the voxel range covered by [a, b], clamped to [0, dim). Voxels are
+// closed, so a face on the far side of the grid still touches the last.
+static bool Range(float a, float b, unsigned int dim,
+                  unsigned int& lo, unsigned int& hi) {
+    if (!(b >= 0) || !(a <= dim)) return false;
+    lo = a < 0 ? 0 : (a >= dim ? dim - 1 : (unsigned int)a);
+    hi = b >= dim ? dim - 1 : (unsigned int)b;
+    return true;
+}
+
+// clip [lo, hi] to the x where a * x + c >= 0
+static bool Clip(float a, float c, float& lo, float& hi) {
+    if (a > 0) {
+        float t = -c / a;
+        if (t > lo) lo = t;
+    }
+    else if (a < 0) {
+        float t = -c / a;
+        if (t < hi) hi = t;
+    }
+    else if (c < 0) return false;
+    return lo <= hi;
+}
+
+// set bits a to b of a row
+static void SetRun(uint32_t* row, unsigned int a, unsigned int b) {
+    unsigned int wa = a >> 5, wb = b >> 5;
+    uint32_t ma = ~0u << (a & 31), mb = ~0u >> (31 - (b & 31));
+    if (wa == wb) {
+        row[wa] |= ma & mb;
+        return;
+    }
+    row[wa] |= ma;
+    for (unsigned int w=wa+1; w<wb; w++) row[w] = ~0u;
+    row[wb] |= mb;
+}
+
+// the face corners, nine floats per face
+static void Flatten(FaceSet& faces, vector<float>& vertices) {
+    vertices.reserve(faces.Size() * 9);
+    for (FaceList::iterator itr = faces.begin(); itr != faces.end(); itr++)
+        for (int i=0; i<3; i++)
+            for (int k=0; k<3; k++)
+                vertices.push_back((*itr)->vert[i][k]);
+}
+
+static void Edges(const float* v, float e[3][3], float n[3]) {
+    for (int i=0; i<3; i++)
+        for (int k=0; k<3; k++)
+            e[i][k] = v[(i+1)%3*3+k] - v[i*3+k];
+    n[0] = e[0][1]*e[1][2] - e[0][2]*e[1][1];
+    n[1] = e[0][2]*e[1][0] - e[0][0]*e[1][2];
+    n[2] = e[0][0]*e[1][1] - e[0][1]*e[1][0];
+}
+
+// set the voxels of rows [y0,y1] x [z0,z1] touched by a face
+static void Surface(const float* v, const unsigned int dims[3],
+                    unsigned int rowWords, uint32_t* bits,
+                    unsigned int y0, unsigned int y1,
+                    unsigned int z0, unsigned int z1) {
+    unsigned int lo[3], hi[3];
+    for (int k=0; k<3; k++) {
+        float a = v[k], b = v[k];
+        for (int i=1; i<3; i++) {
+            a = v[i*3+k] < a ? v[i*3+k] : a;
+            b = v[i*3+k] > b ? v[i*3+k] : b;
+        }
+        if (!Range(a, b, dims[k], lo[k], hi[k])) return;
+    }
+    if (lo[1] < y0) lo[1] = y0;
+    if (hi[1] > y1) hi[1] = y1;
+    if (lo[2] < z0) lo[2] = z0;
+    if (hi[2] > z1) hi[2] = z1;
+    if (lo[1] > hi[1] || lo[2] > hi[2]) return;
+
+    float e[3][3], n[3];
+    Edges(v, e, n);
+
+    // the voxel crosses the plane if n.p + d1 >= 0 >= n.p + d2
+    float d1 = -(n[0]*v[0] + n[1]*v[1] + n[2]*v[2]), d2 = d1;
+    for (int k=0; k<3; k++)
+        if (n[k] > 0) d1 += n[k];
+        else d2 += n[k];
+
+    // edge functions a * u + b * w + d >= 0 of the projection onto
+    // the plane orthogonal to axis q, with (u,w) the following axes
+    float a[3][3], b[3][3], d[3][3];
+    for (int q=0; q<3; q++) {
+        int u = (q+1) % 3, w = (q+2) % 3;
+        float s = n[q] < 0 ? -1 : 1;
+        for (int i=0; i<3; i++) {
+            a[q][i] = -e[i][w] * s;
+            b[q][i] = e[i][u] * s;
+            d[q][i] = -(a[q][i]*v[i*3+u] + b[q][i]*v[i*3+w])
+                + (a[q][i] > 0 ? a[q][i] : 0) + (b[q][i] > 0 ? b[q][i] : 0);
+        }
+    }
+
+    for (unsigned int z=lo[2]; z<=hi[2]; z++)
+        for (unsigned int y=lo[1]; y<=hi[1]; y++) {
+            bool inside = true;
+            for (int i=0; i<3; i++)
+                inside &= a[0][i]*y + b[0][i]*z + d[0][i] >= 0;
+            if (!inside) continue;
+            float xl = lo[0], xh = hi[0];
+            float s = n[1]*y + n[2]*z;
+            inside = Clip(n[0], s + d1, xl, xh) && Clip(-n[0], -s - d2, xl, xh);
+            for (int i=0; inside && i<3; i++)
+                inside = Clip(b[1][i], a[1][i]*z + d[1][i], xl, xh)
+                    && Clip(a[2][i], b[2][i]*y + d[2][i], xl, xh);
+            if (!inside) continue;
+            unsigned int xa = (unsigned int)ceil(xl), xb = (unsigned int)floor(xh);
+            if (xa <= xb) SetRun(bits + (z*dims[1] + y)*rowWords, xa, xb);
+        }
+}
+
+// flip the voxel where the face crosses a row, for the rows of the
+// tile whose centers lie inside the face seen along x
+static bool Crossings(const float* v, const unsigned int dims[3],
+                      unsigned int rowWords, uint32_t* flips,
+                      unsigned int y0, unsigned int y1,
+                      unsigned int z0, unsigned int z1) {
+    float e[3][3], n[3];
+    Edges(v, e, n);
+    if (n[0] == 0) return false;
+    float s = n[0] < 0 ? -1 : 1;
+    float a[3], b[3];
+    float lo[2] = {v[1], v[2]}, hi[2] = {v[1], v[2]};
+    for (int i=0; i<3; i++) {
+        a[i] = -e[i][2] * s;
+        b[i] = e[i][1] * s;
+        for (int k=0; k<2; k++) {
+            lo[k] = v[i*3+1+k] < lo[k] ? v[i*3+1+k] : lo[k];
+            hi[k] = v[i*3+1+k] > hi[k] ? v[i*3+1+k] : hi[k];
+        }
+    }
+    // rows whose centers y+0.5, z+0.5 are inside the bounds
+    float ya = ceil(lo[0] - 0.5f), yb = floor(hi[0] - 0.5f);
+    float za = ceil(lo[1] - 0.5f), zb = floor(hi[1] - 0.5f);
+    if (ya < y0) ya = y0;
+    if (yb > y1) yb = y1;
+    if (za < z0) za = z0;
+    if (zb > z1) zb = z1;
+
+    bool flipped = false;
+    for (float z=za; z<=zb; z++)
+        for (float y=ya; y<=yb; y++) {
+            float py = y + 0.5f, pz = z + 0.5f;
+            bool inside = true;
+            for (int i=0; i<3; i++) {
+                float f = a[i]*(py - v[i*3+1]) + b[i]*(pz - v[i*3+2]);
+                // centers on a shared edge go to one of the faces only
+                inside &= f > 0 || (f == 0 && (a[i] > 0 || (a[i] == 0 && b[i] > 0)));
+            }
+            if (!inside) continue;
+            float x = v[0] - (n[1]*(py - v[1]) + n[2]*(pz - v[2])) / n[0];
+            // the first voxel whose center is past the crossing
+            float c = floor(x + 0.5f);
+            if (c >= dims[0]) continue;
+            unsigned int i = c < 0 ? 0 : (unsigned int)c;
+            unsigned int row = ((unsigned int)z - z0) * TILE + (unsigned int)y - y0;
+            flips[row*rowWords + (i >> 5)] ^= 1u << (i & 31);
+            flipped = true;
+        }
+    return flipped;
+}
+
+/**
+ * Create an empty grid.
+ *
+ * @param origin Lowest corner of the grid.
+ * @param voxelSize Side of the voxels.
+ * @param dimensions Number of voxels along each axis.
+ */
+VoxelGrid::VoxelGrid(const Vector<3,float>& origin, float voxelSize,
+                     const Vector<3,unsigned int>& dimensions)
+    : origin(origin), size(voxelSize) {
+    Resize(dimensions);
+}
+
+/**
+ * Voxelize a face set.
+ * The grid is fitted to the bounds of the faces with cubic voxels,
+ * \a resolution of them along the longest side.
+ *
+ * @param faces Faces to voxelize.
+ * @param resolution Voxels along the longest side of the bounds.
+ * @param solid Also fill the interior, see \a Voxelize [optional].
+ */
+VoxelGrid::VoxelGrid(FaceSet& faces, unsigned int resolution, bool solid)
+    : size(1) {
+    vector<float> vertices;
+    Flatten(faces, vertices);
+
+    Vector<3,float> min, max;
+    if (!Box::ComputeBounds(vertices.empty() ? NULL : &vertices[0],
+                            vertices.size() / 3, 3, min, max)) {
+        Resize(Vector<3,unsigned int>(1, 1, 1));
+        return;
+    }
+    if (resolution < 1) resolution = 1;
+    Vector<3,float> extent = max - min;
+    float longest = extent.Get(0);
+    for (int k=1; k<3; k++)
+        if (extent.Get(k) > longest) longest = extent.Get(k);
+    if (longest > 0) size = longest / resolution;
+    origin = min;
+    Vector<3,unsigned int> dimensions;
+    for (int k=0; k<3; k++) {
+        unsigned int d = (unsigned int)ceil(extent.Get(k) / size);
+        dimensions[k] = d < 1 ? 1 : (d > resolution ? resolution : d);
+    }
+    Resize(dimensions);
+    Voxelize(&vertices[0], vertices.size() / 9, solid);
+}
+
+/**
+ * Destructor.
+ */
+VoxelGrid::~VoxelGrid() {}
+
+/**
+ * Voxelize a face set into the grid.
+ * Voxels already set stay set.
+ *
+ * @param faces Faces to voxelize.
+ * @param solid Also fill the interior [optional].
+ * @see Voxelize(const float*, unsigned int, bool)
+ */
+void VoxelGrid::Voxelize(FaceSet& faces, bool solid) {
+    vector<float> vertices;
+    Flatten(faces, vertices);
+    if (!vertices.empty())
+        Voxelize(&vertices[0], vertices.size() / 9, solid);
+}
+
+/**
+ * Voxelize triangles into the grid.
+ * Every voxel touching a triangle is set. With \a solid the voxels
+ * whose centers are inside the mesh are set too, found by counting
+ * the crossings of each row with the mesh, so the mesh must be
+ * closed. Voxels already set stay set.
+ *
+ * @param vertices Triangle corners, nine floats per triangle.
+ * @param numFaces Number of triangles.
+ * @param solid Also fill the interior [optional].
+ */
+void VoxelGrid::Voxelize(const float* vertices, unsigned int numFaces, bool solid) {
+    if (numFaces == 0 || bits.empty()) return;
+
+    // move to grid space
+    vector<float> grid(numFaces * 9);
+    float scale = 1 / size;
+    for (unsigned int i=0; i<numFaces*3; i++)
+        for (int k=0; k<3; k++)
+            grid[i*3+k] = (vertices[i*3+k] - origin.Get(k)) * scale;
+
+    // bin the faces into the tiles they cover, counting first
+    unsigned int tilesY = (dims[1] + TILE - 1) / TILE;
+    unsigned int numTiles = tilesY * ((dims[2] + TILE - 1) / TILE);
+    vector<unsigned int> start(numTiles + 1, 0), faces;
+    vector<unsigned int> ranges(numFaces * 4);
+    for (int pass=0; pass<2; pass++) {
+        for (unsigned int f=0; f<numFaces; f++) {
+            unsigned int* r = &ranges[f*4];
+            if (pass == 0) {
+                const float* v = &grid[f*9];
+                float lo[3], hi[3];
+                for (int k=0; k<3; k++) {
+                    lo[k] = hi[k] = v[k];
+                    for (int i=1; i<3; i++) {
+                        lo[k] = v[i*3+k] < lo[k] ? v[i*3+k] : lo[k];
+                        hi[k] = v[i*3+k] > hi[k] ? v[i*3+k] : hi[k];
+                    }
+                }
+                // faces left of the grid still cross its rows
+                bool covered = Range(lo[1], hi[1], dims[1], r[0], r[1])
+                    && Range(lo[2], hi[2], dims[2], r[2], r[3])
+                    && lo[0] <= dims[0] && (solid || hi[0] >= 0);
+                if (!covered) {
+                    r[0] = 1; r[1] = 0;
+                    continue;
+                }
+                r[0] /= TILE; r[1] /= TILE; r[2] /= TILE; r[3] /= TILE;
+            }
+            for (unsigned int tz=r[2]; r[0]<=r[1] && tz<=r[3]; tz++)
+                for (unsigned int ty=r[0]; ty<=r[1]; ty++) {
+                    unsigned int t = tz * tilesY + ty;
+                    if (pass == 0) start[t+1]++;
+                    else faces[start[t]++] = f;
+                }
+        }
+        if (pass == 0) {
+            for (unsigned int t=0; t<numTiles; t++) start[t+1] += start[t];
+            faces.resize(start[numTiles]);
+        }
+        else {
+            // filling moved every start to the next one
+            for (unsigned int t=numTiles; t>0; t--) start[t] = start[t-1];
+            start[0] = 0;
+        }
+    }
+
+    unsigned int threads = boost::thread::hardware_concurrency();
+    if (threads > numTiles) threads = numTiles;
+    if (threads < 2 || numFaces < PARALLEL_THRESHOLD) {
+        VoxelizeTiles(&grid, &start, &faces, solid, 0, 1);
+        return;
+    }
+    boost::thread_group group;
+    for (unsigned int t=1; t<threads; t++)
+        group.create_thread(boost::bind(&VoxelGrid::VoxelizeTiles, this,
+                                        &grid, &start, &faces, solid,
+                                        t, threads));
+    VoxelizeTiles(&grid, &start, &faces, solid, 0, threads);
+    group.join_all();
+}
+
+// voxelize the tiles first, first+step, ...
+void VoxelGrid::VoxelizeTiles(const vector<float>* vertices,
+                              const vector<unsigned int>* start,
+                              const vector<unsigned int>* faces,
+                              bool solid, unsigned int first,
+                              unsigned int step) {
+    unsigned int tilesY = (dims[1] + TILE - 1) / TILE;
+    unsigned int numTiles = start->size() - 1;
+    uint32_t last = dims[0] & 31 ? (1u << (dims[0] & 31)) - 1 : ~0u;
+    vector<uint32_t> flips(solid ? TILE * TILE * rowWords : 0);
+    for (unsigned int t=first; t<numTiles; t+=step) {
+        unsigned int begin = (*start)[t], end = (*start)[t+1];
+        if (begin == end) continue;
+        unsigned int y0 = t % tilesY * TILE, z0 = t / tilesY * TILE;
+        unsigned int y1 = (y0 + TILE < dims[1] ? y0 + TILE : dims[1]) - 1;
+        unsigned int z1 = (z0 + TILE < dims[2] ? z0 + TILE : dims[2]) - 1;
+        bool flipped = false;
+        for (unsigned int i=begin; i<end; i++) {
+            const float* v = &(*vertices)[(*faces)[i] * 9];
+            Surface(v, dims, rowWords, &bits[0], y0, y1, z0, z1);
+            if (solid)
+                flipped |= Crossings(v, dims, rowWords, &flips[0], y0, y1, z0, z1);
+        }
+        if (!flipped) continue;
+
+        // a voxel is inside if an odd number of crossings precede it
+        for (unsigned int z=z0; z<=z1; z++)
+            for (unsigned int y=y0; y<=y1; y++) {
+                uint32_t* f = &flips[((z - z0) * TILE + y - y0) * rowWords];
+                uint32_t* row = &bits[(z * dims[1] + y) * rowWords];
+                uint32_t carry = 0;
+                for (unsigned int w=0; w<rowWords; w++) {
+                    uint32_t x = f[w];
+                    x ^= x << 1; x ^= x << 2; x ^= x << 4;
+                    x ^= x << 8; x ^= x << 16;
+                    x ^= carry;
+                    carry = 0 - (x >> 31);
+                    row[w] |= w + 1 == rowWords ? x & last : x;
+                    f[w] = 0;
+                }
+            }
+    }
+}
+
+/**
+ * Get the number of voxels along each axis.
+ */
+Vector<3,unsigned int> VoxelGrid::GetDimensions() const {
+    return Vector<3,unsigned int>(dims[0], dims[1], dims[2]);
+}
+
+/**
+ * Get the lowest corner of the grid.
+ */
+Vector<3,float> VoxelGrid::GetOrigin() const {
+    return origin;
+}
+
+/**
+ * Get the side of the voxels.
+ */
+float VoxelGrid::GetVoxelSize() const {
+    return size;
+}
+
+/**
+ * Check if a voxel is set.
+ *
+ * @param x,y,z Voxel, inside the grid.
+ * @return True if set.
+ */
+bool VoxelGrid::Get(unsigned int x, unsigned int y, unsigned int z) const {
+    return bits[(z * dims[1] + y) * rowWords + (x >> 5)] >> (x & 31) & 1;
+}
+
+/**
+ * Set or clear a voxel.
+ *
+ * @param x,y,z Voxel, inside the grid.
+ * @param filled New state.
+ */
+void VoxelGrid::Set(unsigned int x, unsigned int y, unsigned int z, bool filled) {
+    uint32_t& word = bits[(z * dims[1] + y) * rowWords + (x >> 5)];
+    if (filled) word |= 1u << (x & 31);
+    else word &= ~(1u << (x & 31));
+}
+
+/**
+ * Clear all voxels.
+ */
+void VoxelGrid::Clear() {
+    bits.assign(bits.size(), 0);
+}
+
+/**
+ * Count the voxels set.
+ */
+unsigned int VoxelGrid::GetNumFilled() const {
+    unsigned int count = 0;
+    for (unsigned int i=0; i<bits.size(); i++) {
+        uint32_t x = bits[i];
+        x = x - ((x >> 1) & 0x55555555);
+        x = (x & 0x33333333) + ((x >> 2) & 0x33333333);
+        count += (((x + (x >> 4)) & 0x0f0f0f0f) * 0x01010101) >> 24;
+    }
+    return count;
+}
+
+/**
+ * Get the voxel bits, see the class description for the layout.
+ */
+const vector<uint32_t>& VoxelGrid::GetBits() const {
+    return bits;
+}
+
+/**
+ * Get the number of words per row of voxels.
+ */
+unsigned int VoxelGrid::GetRowWords() const {
+    return rowWords;
+}
+
+/**
+ * Get the grid as sparse bricks.
+ * The grid is split into bricks of 4x4x4 voxels, stored as 64 bit
+ * words with voxel (x,y,z) of a brick in bit z*16 + y*4 + x. Only
+ * bricks with voxels set are stored; the table has an entry per
+ * brick, x fastest, holding its index in \a bricks or \a EMPTY_BRICK.
+ *
+ * @param table Set to the brick table.
+ * @param bricks Set to the non-empty bricks.
+ */
+void VoxelGrid::GetBricks(vector<unsigned int>& table,
+                          vector<uint64_t>& bricks) const {
+    unsigned int b[3];
+    for (int k=0; k<3; k++) b[k] = (dims[k] + BRICK_SIZE - 1) / BRICK_SIZE;
+    table.assign(b[0] * b[1] * b[2], EMPTY_BRICK);
+    bricks.clear();
+    for (unsigned int bz=0; bz<b[2]; bz++)
+        for (unsigned int by=0; by<b[1]; by++)
+            for (unsigned int bx=0; bx<b[0]; bx++) {
+                // bricks are aligned, so a brick row is within one word
+                uint64_t brick = 0;
+                unsigned int x = bx * BRICK_SIZE;
+                for (unsigned int z=0; z<BRICK_SIZE; z++) {
+                    if (bz * BRICK_SIZE + z >= dims[2]) break;
+                    for (unsigned int y=0; y<BRICK_SIZE; y++) {
+                        if (by * BRICK_SIZE + y >= dims[1]) break;
+                        unsigned int row = (bz * BRICK_SIZE + z) * dims[1]
+                            + by * BRICK_SIZE + y;
+                        uint64_t nibble = bits[row * rowWords + (x >> 5)] >> (x & 31) & 0xf;
+                        brick |= nibble << (z * 16 + y * 4);
+                    }
+                }
+                if (brick == 0) continue;
+                table[(bz * b[1] + by) * b[0] + bx] = bricks.size();
+                bricks.push_back(brick);
+            }
+}
+
+void VoxelGrid::Resize(const Vector<3,unsigned int>& dimensions) {
+    for (int k=0; k<3; k++) dims[k] = dimensions.Get(k);
+    rowWords = (dims[0] + 31) / 32;
+    bits.assign(rowWords * dims[1] * dims[2], 0);
+}
+
+} // NS Geometry
+} // NS OpenEngine
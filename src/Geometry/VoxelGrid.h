@@ -0,0 +1,95 @@
+// Voxel occupancy grid.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_VOXEL_GRID_H_
+#define _OE_VOXEL_GRID_H_
+
+#include <Math/Vector.h>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+namespace OpenEngine {
+namespace Geometry {
+
+using std::vector;
+using OpenEngine::Math::Vector;
+
+class FaceSet;
+
+/**
+ * Voxel occupancy grid.
+ * One bit per cubic voxel, stored row by row along x with every row
+ * starting on a new 32 bit word, so the voxel (x,y,z) is bit x%32 of
+ * word (z * height + y) * GetRowWords() + x/32 of \a GetBits().
+ *
+ * Face sets are voxelized conservatively: a voxel is set if it
+ * touches a face at all, so thin and sloped surfaces leave no gaps.
+ * Closed meshes can also be voxelized solid, filling the interior by
+ * the parity of the surface crossings along each row.
+ *
+ * @code
+ * VoxelGrid grid(faces, 256, true);     // 256 voxels along the longest side
+ * if (grid.Get(x, y, z)) ...
+ * vector<unsigned int> table;
+ * vector<boost::uint64_t> bricks;
+ * grid.GetBricks(table, bricks);       // sparse 4x4x4 bricks
+ * @endcode
+ *
+ * The grid is split into tiles of rows, the faces are binned into the
+ * tiles they cover, and the tiles are voxelized in parallel. Each
+ * tile owns its rows, so no two threads write the same word.
+ *
+ * @class VoxelGrid VoxelGrid.h Geometry/VoxelGrid.h
+ */
+class VoxelGrid {
+public:
+    static const unsigned int BRICK_SIZE = 4;           //!< brick side in voxels
+    static const unsigned int EMPTY_BRICK = 0xffffffff; //!< brick table entry of empty bricks
+
+    VoxelGrid(const Vector<3,float>& origin, float voxelSize,
+              const Vector<3,unsigned int>& dimensions);
+    VoxelGrid(FaceSet& faces, unsigned int resolution, bool solid = false);
+    virtual ~VoxelGrid();
+
+    void Voxelize(FaceSet& faces, bool solid = false);
+    void Voxelize(const float* vertices, unsigned int numFaces, bool solid = false);
+
+    Vector<3,unsigned int> GetDimensions() const;
+    Vector<3,float> GetOrigin() const;
+    float GetVoxelSize() const;
+
+    bool Get(unsigned int x, unsigned int y, unsigned int z) const;
+    void Set(unsigned int x, unsigned int y, unsigned int z, bool filled);
+    void Clear();
+    unsigned int GetNumFilled() const;
+
+    const vector<boost::uint32_t>& GetBits() const;
+    unsigned int GetRowWords() const;
+
+    void GetBricks(vector<unsigned int>& table,
+                   vector<boost::uint64_t>& bricks) const;
+
+private:
+    Vector<3,float> origin;
+    float size;
+    unsigned int dims[3];
+    unsigned int rowWords;
+    vector<boost::uint32_t> bits;
+
+    void Resize(const Vector<3,unsigned int>& dimensions);
+    void VoxelizeTiles(const vector<float>* vertices,
+                       const vector<unsigned int>* start,
+                       const vector<unsigned int>* faces,
+                       bool solid, unsigned int first, unsigned int step);
+};
+
+} // NS Geometry
+} // NS OpenEngine
+
+#endif // _OE_VOXEL_GRID_H_
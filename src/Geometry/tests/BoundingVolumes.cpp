@@ -0,0 +1,117 @@
+#include <Testing/Testing.h>
+
+#include <Geometry/Sphere.h>
+#include <Geometry/Box.h>
+#include <Geometry/GeometrySet.h>
+
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+using namespace OpenEngine::Geometry;
+
+static float Random(float lo, float hi) {
+    return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+// true if the sphere holds all points, allowing for rounding
+static bool Contains(const Sphere& s, GeometrySet<3,3>& set) {
+    float* p = set.GetVertArray();
+    float r = s.GetRadius() * (1.0f + 1e-5f) + 1e-6f;
+    Vector<3,float> c = s.GetCenter();
+    for (unsigned int i=0; i<set.GetVertLength(); i+=3) {
+        Vector<3,float> d = Vector<3,float>(p[i], p[i+1], p[i+2]) - c;
+        if (d.GetLength() > r) return false;
+    }
+    return true;
+}
+
+int test_main(int argc, char* argv[]) {
+    srand(1);
+
+    // random clouds: both spheres hold every point, the exact one is
+    // never larger and Ritter is close to it
+    for (unsigned int run=0; run<20; run++) {
+        GeometrySet<3,3> set(50 + run * 50);
+        float* p = set.GetVertArray();
+        for (unsigned int i=0; i<set.GetVertLength(); i+=3) {
+            p[i]   = Random(-5, 5) + run;
+            p[i+1] = Random(-1, 1);
+            p[i+2] = Random(-2, 3) * (run % 3);
+        }
+        Sphere ritter(set);
+        Sphere exact(set, true);
+        OE_CHECK(Contains(ritter, set));
+        OE_CHECK(Contains(exact, set));
+        OE_CHECK(exact.GetRadius() <= ritter.GetRadius() * (1.0f + 1e-5f));
+        OE_CHECK(ritter.GetRadius() <= exact.GetRadius() * 1.2f);
+    }
+
+    // known smallest spheres
+    {
+        // the six axis points of the unit sphere
+        GeometrySet<3,3> set(2);
+        float axes[] = { 1,0,0,  0,1,0,  0,0,1,  -1,0,0,  0,-1,0,  0,0,-1 };
+        for (unsigned int i=0; i<18; i++) set.GetVertArray()[i] = axes[i];
+        Sphere exact(set, true);
+        OE_CHECK(fabs(exact.GetRadius() - 1.0f) < 1e-4f);
+        OE_CHECK(exact.GetCenter().GetLength() < 1e-4f);
+    }
+    {
+        // a flat triangle is held by the sphere on its longest edge
+        GeometrySet<3,3> set(1);
+        float tri[] = { -1,0,0,  1,0,0,  0,0.1f,0 };
+        for (unsigned int i=0; i<9; i++) set.GetVertArray()[i] = tri[i];
+        Sphere exact(set, true);
+        OE_CHECK(fabs(exact.GetRadius() - 1.0f) < 1e-4f);
+        OE_CHECK(exact.GetCenter().GetLength() < 1e-4f);
+    }
+    {
+        // an equilateral triangle by its circumcircle
+        GeometrySet<3,3> set(1);
+        float h = sqrt(3.0f) / 2;
+        float tri[] = { 1,0,0,  -0.5f,h,0,  -0.5f,-h,0 };
+        for (unsigned int i=0; i<9; i++) set.GetVertArray()[i] = tri[i];
+        Sphere exact(set, true);
+        OE_CHECK(fabs(exact.GetRadius() - 1.0f) < 1e-4f);
+        OE_CHECK(Contains(Sphere(set), set));
+    }
+
+    // one pass bounds match a plain scan, also when split up
+    for (unsigned int n=1; n<300000; n*=7) {
+        vector<float> p(n * 4);
+        for (unsigned int i=0; i<p.size(); i++) p[i] = Random(-100, 100);
+        for (unsigned int stride=3; stride<=4; stride++) {
+            Vector<3,float> lo, hi;
+            OE_CHECK(Box::ComputeBounds(&p[0], n, stride, lo, hi));
+            float l[3] = { p[0], p[1], p[2] }, u[3] = { p[0], p[1], p[2] };
+            for (unsigned int i=0; i<n; i++)
+                for (unsigned int k=0; k<3; k++) {
+                    float v = p[i*stride+k];
+                    if (v < l[k]) l[k] = v;
+                    if (v > u[k]) u[k] = v;
+                }
+            for (unsigned int k=0; k<3; k++)
+                OE_CHECK(lo[k] == l[k] && hi[k] == u[k]);
+        }
+    }
+    {
+        Vector<3,float> lo, hi;
+        float none[1];
+        OE_CHECK(!Box::ComputeBounds(none, 0, 3, lo, hi));
+    }
+
+    // a box from a set keeps its corners
+    {
+        GeometrySet<3,3> set(1);
+        float tri[] = { 1,2,3,  -1,5,0,  4,-2,1 };
+        for (unsigned int i=0; i<9; i++) set.GetVertArray()[i] = tri[i];
+        Box box(set);
+        OE_CHECK((box.GetMin() == Vector<3,float>(-1,-2,0)));
+        OE_CHECK((box.GetMax() == Vector<3,float>(4,5,3)));
+        OE_CHECK((box.GetCenter() == Vector<3,float>(1.5f,1.5f,1.5f)));
+        OE_CHECK((box.GetCorner(true, false, true) == Vector<3,float>(4,-2,3)));
+    }
+
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <Testing/Testing.h>
+
+#include <Geometry/HalfEdgeMesh.h>
+
+#include <set>
+#include <vector>
+
+using namespace std;
+using namespace OpenEngine::Geometry;
+
+static const unsigned int NONE = HalfEdgeMesh::NONE;
+
+// twins are mutual and run in opposite directions
+static bool TwinsConsistent(const HalfEdgeMesh& mesh) {
+    for (unsigned int e=0; e<mesh.GetNumEdges(); e++) {
+        unsigned int t = mesh.GetTwin(e);
+        if (t == NONE) continue;
+        if (mesh.GetTwin(t) != e) return false;
+        if (mesh.GetOrigin(t) != mesh.GetTarget(e)) return false;
+        if (mesh.GetTarget(t) != mesh.GetOrigin(e)) return false;
+    }
+    return true;
+}
+
+// the neighbors of a vertex found by the ring iterator
+static set<unsigned int> Ring(const HalfEdgeMesh& mesh, unsigned int v) {
+    set<unsigned int> ring;
+    for (HalfEdgeMesh::RingIterator itr = mesh.GetRing(v);
+         itr.HasMore(); itr.Next()) {
+        if (mesh.GetOrigin(itr.GetEdge()) != v) return set<unsigned int>();
+        ring.insert(itr.GetVertex());
+    }
+    return ring;
+}
+
+int test_main(int argc, char* argv[]) {
+
+    // closed tetrahedron
+    {
+        float v[] = { 0,0,0,  1,0,0,  0,1,0,  0,0,1 };
+        unsigned int i[] = { 0,2,1,  0,1,3,  1,2,3,  0,3,2 };
+        HalfEdgeMesh mesh(v, 4, i, 12);
+        OE_CHECK(mesh.GetNumVertices() == 4);
+        OE_CHECK(mesh.GetNumFaces() == 4);
+        OE_CHECK(mesh.GetNumEdges() == 12);
+        OE_CHECK(mesh.IsManifold());
+        OE_CHECK(TwinsConsistent(mesh));
+        for (unsigned int e=0; e<12; e++)
+            OE_CHECK(!mesh.IsBoundary(e));
+        for (unsigned int k=0; k<4; k++) {
+            OE_CHECK(!mesh.IsBoundaryVertex(k));
+            OE_CHECK(mesh.GetValence(k) == 3);
+            OE_CHECK(Ring(mesh, k).size() == 3);
+            OE_CHECK(Ring(mesh, k).count(k) == 0);
+        }
+        // face 0 edge 0 goes 0->2, shared with face 3 (2->0)
+        OE_CHECK(mesh.GetNeighbor(0, 0) == 3);
+        vector<vector<unsigned int> > loops;
+        mesh.GetBoundaryLoops(loops);
+        OE_CHECK(loops.empty());
+    }
+
+    // open quad from a triangle soup, welded to four vertices
+    {
+        float c[] = { 0,0,0,  1,0,0,  1,1,0,
+                      0,0,0,  1,1,0,  0,1,0 };
+        HalfEdgeMesh mesh(c, 2);
+        OE_CHECK(mesh.GetNumVertices() == 4);
+        OE_CHECK(mesh.IsManifold());
+        OE_CHECK(TwinsConsistent(mesh));
+        unsigned int shared = 0;
+        for (unsigned int e=0; e<6; e++)
+            if (!mesh.IsBoundary(e)) shared++;
+        OE_CHECK(shared == 2);
+        OE_CHECK(mesh.GetNeighbor(0, 2) == 1);
+        for (unsigned int k=0; k<4; k++)
+            OE_CHECK(mesh.IsBoundaryVertex(k));
+        // the ring holds the outgoing edges, so it misses the
+        // neighbor only reached through an incoming boundary edge
+        OE_CHECK(Ring(mesh, 0).size() == 2);
+        OE_CHECK(mesh.GetValence(0) == 2);
+        OE_CHECK(mesh.GetValence(1) == 1);
+        vector<vector<unsigned int> > loops;
+        mesh.GetBoundaryLoops(loops);
+        OE_REQUIRE(loops.size() == 1);
+        OE_CHECK(loops[0].size() == 4);
+        OE_CHECK(set<unsigned int>(loops[0].begin(), loops[0].end()).size() == 4);
+    }
+
+    // welding distance
+    {
+        float c[] = { 0,0,0,      1,0,0,  0,1,0,
+                      0.001f,0,0, 0,1,0,  1,1,0 };
+        HalfEdgeMesh exact(c, 2);
+        OE_CHECK(exact.GetNumVertices() == 5);
+        HalfEdgeMesh welded(c, 2, 0.01f);
+        OE_CHECK(welded.GetNumVertices() == 4);
+    }
+
+    // huge positions and a tiny welding distance do not overflow
+    {
+        float c[] = { -1e30f,0,0,  1e30f,0,0,  0,1e30f,0,
+                      1e30f,0,0,   2e30f,0,0,  0,1e30f,0 };
+        HalfEdgeMesh mesh(c, 2, 1e-30f);
+        OE_CHECK(mesh.GetNumVertices() == 4);
+        OE_CHECK(mesh.GetNumFaces() == 2);
+    }
+
+    // three faces on one edge
+    {
+        float v[] = { 0,0,0,  1,0,0,  0,1,0,  0,-1,0,  0,0,1 };
+        unsigned int i[] = { 0,1,2,  1,0,3,  1,0,4 };
+        HalfEdgeMesh mesh(v, 5, i, 9);
+        OE_CHECK(!mesh.IsManifold());
+        OE_CHECK(TwinsConsistent(mesh));
+        const vector<unsigned int>& bad = mesh.GetNonManifoldEdges();
+        OE_CHECK(bad.size() == 3);
+        for (unsigned int k=0; k<bad.size(); k++) {
+            OE_CHECK(mesh.IsBoundary(bad[k]));
+            unsigned int a = mesh.GetOrigin(bad[k]);
+            unsigned int b = mesh.GetTarget(bad[k]);
+            OE_CHECK((a == 0 && b == 1) || (a == 1 && b == 0));
+        }
+    }
+
+    // two fans meeting in a vertex
+    {
+        float v[] = { 0,0,0,  1,0,0,  1,1,0,  -1,0,0,  -1,-1,0 };
+        unsigned int i[] = { 0,1,2,  0,3,4 };
+        HalfEdgeMesh mesh(v, 5, i, 6);
+        OE_CHECK(mesh.GetNonManifoldEdges().empty());
+        OE_REQUIRE(mesh.GetNonManifoldVertices().size() == 1);
+        OE_CHECK(mesh.GetNonManifoldVertices()[0] == 0);
+        OE_CHECK(!mesh.IsManifold());
+    }
+
+    // out of range index
+    {
+        float v[] = { 0,0,0,  1,0,0,  0,1,0 };
+        unsigned int i[] = { 0,1,3 };
+        bool thrown = false;
+        try { HalfEdgeMesh mesh(v, 3, i, 3); }
+        catch (...) { thrown = true; }
+        OE_CHECK(thrown);
+    }
+
+    return 0;
+}
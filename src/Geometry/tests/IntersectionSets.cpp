@@ -0,0 +1,174 @@
+#include <Testing/Testing.h>
+
+#include <Geometry/BoxSet.h>
+#include <Geometry/SphereSet.h>
+#include <Geometry/OrientedBox.h>
+#include <Geometry/Box.h>
+#include <Geometry/Sphere.h>
+#include <Geometry/Line.h>
+#include <Geometry/Plane.h>
+#include <Math/Quaternion.h>
+
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+using namespace OpenEngine::Geometry;
+using OpenEngine::Math::Quaternion;
+
+static float Random(float lo, float hi) {
+    return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+static Vector<3,float> RandomPoint(float size) {
+    return Vector<3,float>(Random(-size, size), Random(-size, size),
+                           Random(-size, size));
+}
+
+static Vector<3,float> RandomDirection() {
+    Vector<3,float> d;
+    do d = RandomPoint(1); while (d.GetLength() < 0.1f);
+    d.Normalize();
+    return d;
+}
+
+static Box RandomBox() {
+    Vector<3,float> c = RandomPoint(10), e = RandomPoint(2);
+    for (int k=0; k<3; k++) e[k] = fabs(e[k]) + 0.1f;
+    return Box(c - e, c + e);
+}
+
+static OrientedBox RandomOrientedBox() {
+    Vector<3,float> e = RandomPoint(3);
+    for (int k=0; k<3; k++) e[k] = fabs(e[k]) + 0.1f;
+    return OrientedBox(RandomPoint(10),
+                       Quaternion<float>(Random(0, 6.28f), RandomDirection()),
+                       e);
+}
+
+// sphere against oriented box, by the closest point in the box frame
+static bool Intersects(const Sphere& s, const OrientedBox& obb) {
+    Vector<3,float> d = s.GetCenter() - obb.GetCenter();
+    Vector<3,float> e = obb.GetExtent();
+    float dist = 0;
+    for (int k=0; k<3; k++) {
+        float t = d * obb.GetAxis(k);
+        float out = fabs(t) - e[k];
+        if (out > 0) dist += out * out;
+    }
+    return dist <= s.GetRadius() * s.GetRadius();
+}
+
+static bool Bit(const vector<unsigned int>& mask, unsigned int i) {
+    return (mask[i / 32] >> (i % 32)) & 1;
+}
+
+int test_main(int argc, char* argv[]) {
+    srand(1);
+    const unsigned int n = 1000;
+
+    BoxSet boxes;
+    SphereSet spheres;
+    vector<Box> box;
+    vector<Sphere> sphere;
+    for (unsigned int i=0; i<n; i++) {
+        box.push_back(RandomBox());
+        sphere.push_back(Sphere(RandomPoint(10), Random(0.2f, 4)));
+        OE_CHECK(boxes.Add(box[i]) == i);
+        OE_CHECK(spheres.Add(sphere[i]) == i);
+    }
+    OE_CHECK(boxes.GetSize() == n);
+    OE_CHECK(spheres.GetSize() == n);
+
+    // every batch mask matches the single tests, over many queries
+    unsigned int mismatches = 0, hits = 0;
+    vector<unsigned int> mask;
+    for (unsigned int q=0; q<20; q++) {
+        Vector<3,float> point = RandomPoint(10);
+        Plane plane(RandomDirection(), Random(-10, 10));
+        Line line(RandomPoint(12), RandomPoint(12));
+        Box qbox = RandomBox();
+        Sphere qsphere(RandomPoint(10), Random(0.2f, 6));
+        OrientedBox qobb = RandomOrientedBox();
+
+        boxes.Intersects(point, mask);
+        for (unsigned int i=0; i<n; i++)
+            mismatches += Bit(mask, i) != box[i].Intersects(point);
+        boxes.Intersects(plane, mask);
+        for (unsigned int i=0; i<n; i++)
+            mismatches += Bit(mask, i) != box[i].Intersects(plane);
+        boxes.Intersects(line, mask);
+        for (unsigned int i=0; i<n; i++)
+            mismatches += Bit(mask, i) != box[i].Intersects(line);
+        boxes.Intersects(qbox, mask);
+        for (unsigned int i=0; i<n; i++)
+            mismatches += Bit(mask, i) != box[i].Intersects(qbox);
+        boxes.Intersects(qsphere, mask);
+        for (unsigned int i=0; i<n; i++)
+            mismatches += Bit(mask, i) != qsphere.Intersects(box[i]);
+        boxes.Intersects(qobb, mask);
+        for (unsigned int i=0; i<n; i++) {
+            mismatches += Bit(mask, i) != qobb.Intersects(box[i]);
+            hits += Bit(mask, i);
+        }
+
+        spheres.Intersects(point, mask);
+        for (unsigned int i=0; i<n; i++)
+            mismatches += Bit(mask, i) != sphere[i].Intersects(point);
+        spheres.Intersects(plane, mask);
+        for (unsigned int i=0; i<n; i++)
+            mismatches += Bit(mask, i) != sphere[i].Intersects(plane);
+        spheres.Intersects(line, mask);
+        for (unsigned int i=0; i<n; i++)
+            mismatches += Bit(mask, i) != sphere[i].Intersects(line);
+        spheres.Intersects(qbox, mask);
+        for (unsigned int i=0; i<n; i++)
+            mismatches += Bit(mask, i) != sphere[i].Intersects(qbox);
+        spheres.Intersects(qsphere, mask);
+        for (unsigned int i=0; i<n; i++)
+            mismatches += Bit(mask, i) != sphere[i].Intersects(qsphere);
+        spheres.Intersects(qobb, mask);
+        for (unsigned int i=0; i<n; i++)
+            mismatches += Bit(mask, i) != Intersects(sphere[i], qobb);
+    }
+    OE_CHECK(mismatches == 0);
+    OE_CHECK(hits > 0);
+    // bits past the last element are clear
+    OE_CHECK(mask.size() == (n + 31) / 32);
+    OE_CHECK((mask.back() >> (n % 32)) == 0);
+
+    // an oriented box without rotation is its box
+    for (unsigned int i=0; i<100; i++) {
+        OrientedBox obb(box[i]);
+        for (unsigned int j=0; j<100; j++)
+            mismatches += obb.Intersects(OrientedBox(box[j])) !=
+                box[i].Intersects(box[j]);
+    }
+    OE_CHECK(mismatches == 0);
+
+    // SAT is symmetric
+    for (unsigned int i=0; i<500; i++) {
+        OrientedBox a = RandomOrientedBox(), b = RandomOrientedBox();
+        mismatches += a.Intersects(b) != b.Intersects(a);
+    }
+    OE_CHECK(mismatches == 0);
+
+    // separated by a face axis of the turned box, where the axis
+    // aligned bounds of the two would overlap
+    {
+        Vector<3,float> half(0.5f, 0.5f, 0.5f);
+        OrientedBox a(Box(-half, half));
+        Quaternion<float> turn(3.14159265f / 4, Vector<3,float>(0,0,1));
+        OrientedBox b(Vector<3,float>(1,1,0), turn, half);
+        OE_CHECK(!a.Intersects(b));
+        OE_CHECK(a.Intersects(OrientedBox(Vector<3,float>(0.8f,0.8f,0),
+                                          turn, half)));
+        // the box of b does overlap
+        Vector<3,float> reach(0.71f, 0.71f, 0.5f);
+        OE_CHECK(a.Intersects(Box(Vector<3,float>(1,1,0) - reach,
+                                  Vector<3,float>(1,1,0) + reach)));
+    }
+
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include <Testing/Testing.h>
+
+#include <Geometry/MeshletSet.h>
+#include <Geometry/HalfEdgeMesh.h>
+#include <Geometry/Plane.h>
+
+#include <vector>
+
+using namespace std;
+using namespace OpenEngine::Geometry;
+
+// a grid of n by n quads in the xy plane, facing +z
+static HalfEdgeMesh* Grid(unsigned int n) {
+    vector<float> v;
+    vector<unsigned int> i;
+    for (unsigned int y=0; y<=n; y++)
+        for (unsigned int x=0; x<=n; x++) {
+            v.push_back(x); v.push_back(y); v.push_back(0);
+        }
+    for (unsigned int y=0; y<n; y++)
+        for (unsigned int x=0; x<n; x++) {
+            unsigned int a = y*(n+1) + x, b = a + 1;
+            unsigned int c = a + n + 1, d = c + 1;
+            i.push_back(a); i.push_back(b); i.push_back(d);
+            i.push_back(a); i.push_back(d); i.push_back(c);
+        }
+    return new HalfEdgeMesh(&v[0], v.size() / 3, &i[0], i.size());
+}
+
+int test_main(int argc, char* argv[]) {
+    HalfEdgeMesh* grid = Grid(8);
+    MeshletSet meshlets(*grid, 8, 16);
+    vector<unsigned int> visible;
+    unsigned int count = meshlets.GetNumMeshlets();
+    OE_CHECK(count >= 128 / 8);
+
+    // every face in one meshlet, within the limits
+    vector<unsigned int> seen(grid->GetNumFaces(), 0);
+    for (unsigned int m=0; m<count; m++) {
+        const Meshlet& let = meshlets.GetMeshlet(m);
+        OE_CHECK(let.numFaces > 0 && let.numFaces <= 8);
+        OE_CHECK(let.numVertices <= 16);
+        for (unsigned int f=let.firstFace; f<let.firstFace+let.numFaces; f++) {
+            seen[meshlets.GetFaces()[f]]++;
+            for (unsigned int k=0; k<3; k++) {
+                unsigned int l = meshlets.GetLocalIndices()[f*3+k];
+                OE_CHECK(l < let.numVertices);
+                OE_CHECK(meshlets.GetVertices()[let.firstVertex + l] ==
+                         grid->GetFaceVertex(meshlets.GetFaces()[f], k));
+            }
+        }
+        // flat meshlets have a zero width cone along the normal
+        OE_CHECK(let.coneAxis.Get(2) > 0.99f);
+        OE_CHECK(let.coneCutoff < 0.01f);
+    }
+    for (unsigned int f=0; f<seen.size(); f++)
+        OE_CHECK(seen[f] == 1);
+
+    // seen from the front all meshlets are visible, from behind none
+    OE_CHECK(meshlets.Cull(NULL, 0, Vector<3,float>(4,4,10), visible) == count);
+    OE_CHECK(meshlets.Cull(NULL, 0, Vector<3,float>(4,4,-10), visible) == 0);
+    OE_CHECK(visible.empty());
+    // edge on they are kept, as the cone test is conservative
+    OE_CHECK(meshlets.Cull(NULL, 0, Vector<3,float>(-50,4,0), visible) == count);
+
+    // a plane keeps the meshlets in front of it
+    Plane right(Vector<3,float>(1,0,0), -4.5f);
+    Plane* planes[] = { &right };
+    unsigned int n = meshlets.Cull(planes, 1, Vector<3,float>(4,4,10), visible);
+    OE_CHECK(n > 0 && n < count);
+    for (unsigned int i=0; i<visible.size(); i++) {
+        const Meshlet& let = meshlets.GetMeshlet(visible[i]);
+        OE_CHECK(let.center.Get(0) + let.radius >= 4.5f);
+    }
+
+    // a closed mesh in one meshlet can not be backface culled
+    {
+        float v[] = { 0,0,0,  1,0,0,  0,1,0,  0,0,1 };
+        unsigned int i[] = { 0,2,1,  0,1,3,  0,3,2,  1,2,3 };
+        HalfEdgeMesh tetra(v, 4, i, 12);
+        MeshletSet one(tetra);
+        OE_REQUIRE(one.GetNumMeshlets() == 1);
+        OE_CHECK(one.GetMeshlet(0).coneCutoff > 1.0f);
+        OE_CHECK(one.Cull(NULL, 0, Vector<3,float>(5,5,5), visible) == 1);
+        OE_CHECK(one.Cull(NULL, 0, Vector<3,float>(-5,-5,-5), visible) == 1);
+    }
+
+    delete grid;
+    return 0;
+}
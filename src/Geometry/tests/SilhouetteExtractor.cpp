@@ -0,0 +1,83 @@
+#include <Testing/Testing.h>
+
+#include <Geometry/SilhouetteExtractor.h>
+#include <Geometry/HalfEdgeMesh.h>
+#include <Geometry/FaceSet.h>
+#include <Geometry/Face.h>
+
+using namespace std;
+using namespace OpenEngine::Geometry;
+
+// the corner tetrahedron, its slanted face last
+static FaceSet* Tetrahedron() {
+    Vector<3,float> p[] = { Vector<3,float>(0,0,0), Vector<3,float>(1,0,0),
+                            Vector<3,float>(0,1,0), Vector<3,float>(0,0,1) };
+    unsigned int i[] = { 0,2,1,  0,1,3,  0,3,2,  1,2,3 };
+    FaceSet* faces = new FaceSet();
+    for (unsigned int f=0; f<4; f++)
+        faces->Add(FacePtr(new Face(p[i[f*3]], p[i[f*3+1]], p[i[f*3+2]])));
+    return faces;
+}
+
+// true if the edges are all the edges of one face
+static bool IsFace(const vector<unsigned int>& edges, unsigned int face) {
+    if (edges.size() != 3) return false;
+    for (unsigned int k=0; k<3; k++)
+        if (edges[k] / 3 != face) return false;
+    return true;
+}
+
+int test_main(int argc, char* argv[]) {
+    FaceSet* faces = Tetrahedron();
+    HalfEdgeMesh mesh(*faces);
+    OE_REQUIRE(mesh.IsManifold());
+    SilhouetteExtractor silhouettes(mesh);
+
+    Vector<4,float> above(0,0,1,0);   // directional, from +z
+    Vector<4,float> below(0,0,-1,0);  // directional, from -z
+    Vector<4,float> inside(0.1f,0.1f,0.1f,1); // point light
+
+    // only the face towards the light is lit, its edges outline it
+    const vector<unsigned int>& top = silhouettes.Extract(above);
+    OE_CHECK(IsFace(top, 3));
+    OE_CHECK(silhouettes.GetFacing(0)[3] && !silhouettes.GetFacing(0)[0]);
+    OE_CHECK(IsFace(silhouettes.Extract(below, 1), 0));
+    OE_CHECK(silhouettes.Extract(inside, 2).empty());
+    OE_CHECK(silhouettes.GetNumSlots() == 3);
+
+    // three lit faces have the edges of the fourth as silhouette,
+    // wound the other way
+    vector<unsigned int> back =
+        silhouettes.Extract(Vector<4,float>(-1,-1,-1,0), 3);
+    OE_CHECK(back.size() == 3);
+    for (unsigned int k=0; k<back.size(); k++)
+        OE_CHECK(mesh.GetTwin(back[k]) / 3 == 3);
+
+    // flipping the slanted face is not seen until Update
+    FacePtr slanted = mesh.GetSourceFace(3);
+    slanted->hardNorm = -slanted->hardNorm;
+    OE_CHECK(IsFace(silhouettes.Extract(above), 3));
+    silhouettes.Update();
+    OE_CHECK(silhouettes.Extract(above).empty());
+
+    // a moved light is recomputed in its slot, others are kept
+    slanted->hardNorm = -slanted->hardNorm;
+    silhouettes.Update();
+    OE_CHECK(IsFace(silhouettes.Extract(above), 3));
+    OE_CHECK(IsFace(silhouettes.Extract(below), 0));
+    OE_CHECK(IsFace(silhouettes.GetSilhouette(1), 0));
+    OE_CHECK(silhouettes.GetSilhouette(2).empty());
+
+    // the batch gives the same as one light at a time
+    vector<Vector<4,float> > lights;
+    lights.push_back(above);
+    lights.push_back(below);
+    lights.push_back(inside);
+    silhouettes.Extract(lights);
+    OE_CHECK(IsFace(silhouettes.GetSilhouette(0), 3));
+    OE_CHECK(IsFace(silhouettes.GetSilhouette(1), 0));
+    OE_CHECK(silhouettes.GetSilhouette(2).empty());
+
+    delete faces;
+    return 0;
+}
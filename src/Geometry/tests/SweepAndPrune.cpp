@@ -0,0 +1,105 @@
+#include <Testing/Testing.h>
+
+#include <Geometry/SweepAndPrune.h>
+#include <Core/IListener.h>
+
+#include <set>
+#include <vector>
+#include <cstdlib>
+
+using namespace std;
+using namespace OpenEngine;
+using namespace OpenEngine::Geometry;
+
+// keeps the pairs reported through the overlap event
+class PairListener : public Core::IListener<OverlapEventArg> {
+public:
+    set<pair<unsigned int, unsigned int> > pairs;
+    bool consistent;
+    PairListener() : consistent(true) {}
+    void Handle(OverlapEventArg arg) {
+        pair<unsigned int, unsigned int> p(arg.first, arg.second);
+        if (arg.type == OverlapEventArg::BEGIN)
+            consistent &= pairs.insert(p).second;
+        else
+            consistent &= pairs.erase(p) == 1;
+    }
+};
+
+struct Object {
+    Vector<3,float> position, velocity, extent;
+    unsigned int proxy;
+    bool alive;
+};
+
+static float Random() {
+    return rand() / (float)RAND_MAX;
+}
+
+// the proxy bounds overlap, touching included
+static bool Intersects(SweepAndPrune& sap, unsigned int a, unsigned int b) {
+    Vector<3,float> amin, amax, bmin, bmax;
+    sap.GetBounds(a, amin, amax);
+    sap.GetBounds(b, bmin, bmax);
+    for (int i=0; i<3; i++)
+        if (bmin[i] > amax[i] || bmax[i] < amin[i]) return false;
+    return true;
+}
+
+static void Spawn(Object& o, SweepAndPrune& sap, float size, float speed) {
+    o.position = Vector<3,float>(Random(), Random(), Random()) * size;
+    o.velocity = Vector<3,float>(Random() - 0.5f, Random() - 0.5f, Random() - 0.5f) * speed;
+    o.extent = Vector<3,float>(Random() + 0.1f, Random() + 0.1f, Random() + 0.1f);
+    o.proxy = sap.Add(o.position - o.extent, o.position + o.extent);
+    o.alive = true;
+}
+
+static void Move(vector<Object>& objects, SweepAndPrune& sap) {
+    for (unsigned int i=0; i<objects.size(); i++) {
+        Object& o = objects[i];
+        if (!o.alive) continue;
+        o.position += o.velocity;
+        sap.Update(o.proxy, o.position - o.extent, o.position + o.extent);
+    }
+}
+
+int test_main(int argc, char* argv[]) {
+    srand(1);
+
+    // compare with all pairs while objects move, die and spawn
+    {
+        SweepAndPrune sap;
+        PairListener listener;
+        sap.OverlapEvent().Attach(listener);
+        vector<Object> objects(1000);
+        for (unsigned int i=0; i<objects.size(); i++)
+            Spawn(objects[i], sap, 40, 0.5f);
+        for (int frame=0; frame<30; frame++) {
+            Move(objects, sap);
+            for (int k=0; k<20; k++) {
+                Object& o = objects[rand() % objects.size()];
+                if (o.alive) { sap.Remove(o.proxy); o.alive = false; }
+                else Spawn(o, sap, 40, 0.5f);
+            }
+            sap.Process();
+
+            set<pair<unsigned int, unsigned int> > expected;
+            for (unsigned int i=0; i<objects.size(); i++)
+                for (unsigned int j=i+1; j<objects.size(); j++) {
+                    if (!objects[i].alive || !objects[j].alive) continue;
+                    unsigned int a = objects[i].proxy, b = objects[j].proxy;
+                    if (Intersects(sap, a, b))
+                        expected.insert(make_pair(min(a, b), max(a, b)));
+                }
+            vector<pair<unsigned int, unsigned int> > found;
+            sap.GetPairs(found);
+            set<pair<unsigned int, unsigned int> > pairs(found.begin(), found.end());
+            OE_CHECK(pairs == expected);
+            OE_CHECK(listener.pairs == expected);
+            OE_CHECK(sap.GetNumPairs() == expected.size());
+        }
+        OE_CHECK(listener.consistent);
+    }
+
+    return 0;
+}
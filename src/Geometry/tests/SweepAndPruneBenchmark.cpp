@@ -0,0 +1,65 @@
+#include <Geometry/SweepAndPrune.h>
+
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+
+using namespace std;
+using namespace OpenEngine;
+using namespace OpenEngine::Geometry;
+
+struct Object {
+    Vector<3,float> position, velocity, extent;
+    unsigned int proxy;
+    bool alive;
+};
+
+static float Random() {
+    return rand() / (float)RAND_MAX;
+}
+
+static void Spawn(Object& o, SweepAndPrune& sap, float size, float speed) {
+    o.position = Vector<3,float>(Random(), Random(), Random()) * size;
+    o.velocity = Vector<3,float>(Random() - 0.5f, Random() - 0.5f, Random() - 0.5f) * speed;
+    o.extent = Vector<3,float>(Random() + 0.1f, Random() + 0.1f, Random() + 0.1f);
+    o.proxy = sap.Add(o.position - o.extent, o.position + o.extent);
+    o.alive = true;
+}
+
+static void Move(vector<Object>& objects, SweepAndPrune& sap) {
+    for (unsigned int i=0; i<objects.size(); i++) {
+        Object& o = objects[i];
+        if (!o.alive) continue;
+        o.position += o.velocity;
+        sap.Update(o.proxy, o.position - o.extent, o.position + o.extent);
+    }
+}
+
+// Benchmark of the sweep and prune broadphase with objects moving a
+// little each frame, the case it is built for.
+int main(int argc, char* argv[]) {
+    srand(1);
+    unsigned int count = argc > 1 ? atoi(argv[1]) : 50000;
+    SweepAndPrune sap;
+    vector<Object> objects(count);
+    for (unsigned int i=0; i<objects.size(); i++)
+        Spawn(objects[i], sap, 1000, 0.1f);
+    clock_t start = clock();
+    sap.Process();
+    clock_t built = clock();
+    unsigned long swaps = sap.GetNumSwaps();
+    const int frames = 10;
+    for (int frame=0; frame<frames; frame++) {
+        Move(objects, sap);
+        sap.Process();
+    }
+    clock_t end = clock();
+    printf("sweep and prune, %u objects: build %.1f ms, "
+           "%.1f ms and %lu swaps per frame, %u pairs\n",
+           (unsigned int)objects.size(),
+           (built - start) * 1000.0 / CLOCKS_PER_SEC,
+           (end - built) * 1000.0 / CLOCKS_PER_SEC / frames,
+           (sap.GetNumSwaps() - swaps) / frames, sap.GetNumPairs());
+    return 0;
+}
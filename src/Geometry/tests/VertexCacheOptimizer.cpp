@@ -0,0 +1,113 @@
+#include <Testing/Testing.h>
+
+#include <Geometry/VertexCacheOptimizer.h>
+#include <Core/Exceptions.h>
+
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+using namespace OpenEngine;
+using namespace OpenEngine::Geometry;
+
+typedef set<vector<unsigned int> > Triangles;
+
+// a grid of n by n quads as a triangle list
+static vector<unsigned int> Grid(unsigned int n) {
+    vector<unsigned int> i;
+    for (unsigned int y=0; y<n; y++)
+        for (unsigned int x=0; x<n; x++) {
+            unsigned int a = y*(n+1) + x, b = a + 1;
+            unsigned int c = a + n + 1, d = c + 1;
+            i.push_back(a); i.push_back(b); i.push_back(d);
+            i.push_back(a); i.push_back(d); i.push_back(c);
+        }
+    return i;
+}
+
+// the triangles of a list, each rotated to start at its least index
+// so the winding is kept
+static Triangles GetTriangles(const vector<unsigned int>& i) {
+    Triangles tris;
+    for (unsigned int t=0; t<i.size(); t+=3) {
+        unsigned int k = 0;
+        if (i[t+1] < i[t+k]) k = 1;
+        if (i[t+2] < i[t+k]) k = 2;
+        vector<unsigned int> tri;
+        for (unsigned int j=0; j<3; j++) tri.push_back(i[t + (k+j)%3]);
+        tris.insert(tri);
+    }
+    return tris;
+}
+
+int test_main(int argc, char* argv[]) {
+
+    // a lone triangle misses three times, a shared edge saves two
+    {
+        unsigned int one[] = { 0,1,2 };
+        OE_CHECK(VertexCacheOptimizer::ACMR(one, 3, 3, 16) == 3.0f);
+        unsigned int two[] = { 0,1,2,  2,1,3 };
+        OE_CHECK(VertexCacheOptimizer::ACMR(two, 6, 4, 16) == 2.0f);
+        // a cache of three is too small to keep the first vertex
+        unsigned int fan[] = { 0,1,2,  0,2,3,  0,3,4 };
+        OE_CHECK(VertexCacheOptimizer::ACMR(fan, 9, 5, 16) == 5.0f / 3);
+        OE_CHECK(VertexCacheOptimizer::ACMR(fan, 9, 5, 3) == 2.0f);
+    }
+
+    // a shuffled grid is reordered close to the ideal ratio
+    {
+        const unsigned int n = 32;
+        vector<unsigned int> grid = Grid(n);
+        vector<unsigned int> i;
+        vector<unsigned int> order(grid.size() / 3);
+        for (unsigned int t=0; t<order.size(); t++) order[t] = t;
+        srand(1);
+        random_shuffle(order.begin(), order.end());
+        for (unsigned int t=0; t<order.size(); t++)
+            i.insert(i.end(), &grid[order[t]*3], &grid[order[t]*3] + 3);
+        unsigned int vertices = (n+1) * (n+1);
+
+        VertexCacheOptimizer opt(16);
+        opt.Optimize(&i[0], i.size(), vertices);
+        OE_CHECK(opt.GetACMRBefore() > 2.0f);
+        OE_CHECK(opt.GetACMRAfter() < 0.8f);
+        OE_CHECK(opt.GetACMRAfter() ==
+                 VertexCacheOptimizer::ACMR(&i[0], i.size(), vertices, 16));
+        // the same triangles with the same winding
+        OE_CHECK(GetTriangles(i) == GetTriangles(grid));
+
+        // fetch order follows first use, positions follow the indices
+        vector<float> v(vertices);
+        for (unsigned int k=0; k<vertices; k++) v[k] = k;
+        vector<unsigned int> used(i);
+        OE_CHECK(opt.OptimizeFetch(&i[0], i.size(), &v[0], vertices, 1)
+                 == vertices);
+        unsigned int next = 0;
+        for (unsigned int k=0; k<i.size(); k++) {
+            OE_CHECK(v[i[k]] == used[k]);
+            if (i[k] == next) next++;
+            else OE_CHECK(i[k] < next);
+        }
+    }
+
+    // unused vertices are dropped
+    {
+        unsigned int i[] = { 4,2,0 };
+        float v[] = { 0,0,  1,1,  2,2,  3,3,  4,4 };
+        VertexCacheOptimizer opt;
+        OE_CHECK(opt.OptimizeFetch(i, 3, v, 5, 2) == 3);
+        OE_CHECK(i[0] == 0 && i[1] == 1 && i[2] == 2);
+        OE_CHECK(v[0] == 4 && v[2] == 2 && v[4] == 0 && v[5] == 0);
+    }
+
+    // out of range indices are rejected
+    {
+        unsigned int i[] = { 0,1,5 };
+        VertexCacheOptimizer opt;
+        OE_CHECK_THROW(opt.Optimize(i, 3, 3), Core::Exception);
+    }
+
+    return 0;
+}
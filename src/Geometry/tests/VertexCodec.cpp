@@ -0,0 +1,125 @@
+#include <Testing/Testing.h>
+
+#include <Geometry/VertexCodec.h>
+
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+using namespace std;
+using namespace OpenEngine::Geometry;
+using boost::int16_t;
+using boost::uint8_t;
+using boost::uint16_t;
+
+static float Random(float lo, float hi) {
+    return lo + (hi - lo) * (rand() / (float)RAND_MAX);
+}
+
+int test_main(int argc, char* argv[]) {
+    srand(1);
+
+    // every half float but NaN converts to a float and back exactly
+    {
+        bool exact = true;
+        for (unsigned int h=0; h<0x10000; h++) {
+            if ((h & 0x7C00) == 0x7C00 && (h & 0x3FF)) continue;
+            exact &= VertexCodec::FloatToHalf(VertexCodec::HalfToFloat(h)) == h;
+        }
+        OE_CHECK(exact);
+        OE_CHECK(VertexCodec::FloatToHalf(1.0f) == 0x3C00);
+        OE_CHECK(VertexCodec::FloatToHalf(-2.0f) == 0xC000);
+        OE_CHECK(VertexCodec::FloatToHalf(65504.0f) == 0x7BFF);
+        OE_CHECK(VertexCodec::FloatToHalf(65520.0f) == 0x7C00);
+        OE_CHECK(VertexCodec::FloatToHalf(-1e10f) == 0xFC00);
+        float nan = sqrt(-1.0f);
+        OE_CHECK(VertexCodec::HalfToFloat(VertexCodec::FloatToHalf(nan)) !=
+                 VertexCodec::HalfToFloat(VertexCodec::FloatToHalf(nan)));
+        // halfway between two halfs rounds to the even one
+        OE_CHECK(VertexCodec::FloatToHalf(1.0f + 1.0f/2048) == 0x3C00);
+        OE_CHECK(VertexCodec::FloatToHalf(1.0f + 3.0f/2048) == 0x3C02);
+        // the streams do the same
+        float in[] = { 0.5f, -0.25f, 1000.0f };
+        uint16_t half[3];
+        float out[3];
+        VertexCodec::EncodeHalf(in, 3, half);
+        VertexCodec::DecodeHalf(half, 3, out);
+        OE_CHECK(out[0] == in[0] && out[1] == in[1] && out[2] == in[2]);
+    }
+
+    // positions are within half a step of the original
+    {
+        const unsigned int n = 1000;
+        vector<float> in(n * 3), out(n * 3);
+        vector<uint16_t> q(n * 3);
+        for (unsigned int i=0; i<n; i++) {
+            in[i*3]   = Random(-10, 10);
+            in[i*3+1] = Random(100, 101);
+            in[i*3+2] = 7.0f; // flat axis
+        }
+        Vector<3,float> offset, scale;
+        VertexCodec::EncodePositions(&in[0], n, &q[0], offset, scale);
+        VertexCodec::DecodePositions(&q[0], n, offset, scale, &out[0]);
+        bool close = true, bounded = true;
+        unsigned int lo = 0xFFFF, hi = 0;
+        for (unsigned int i=0; i<n*3; i++) {
+            float step = scale[i%3];
+            close &= fabs(out[i] - in[i]) <= step * 0.5f + 1e-5f * fabs(in[i]);
+            if (i%3 == 0) {
+                if (q[i] < lo) lo = q[i];
+                if (q[i] > hi) hi = q[i];
+            }
+            bounded &= i%3 != 2 || (q[i] == 0 && out[i] == 7.0f);
+        }
+        OE_CHECK(close);
+        OE_CHECK(bounded);
+        OE_CHECK(lo == 0 && hi == 0xFFFF);
+    }
+
+    // normals keep their direction to a small fraction of a degree
+    {
+        const unsigned int n = 2000;
+        vector<float> in, out(n * 3);
+        vector<int16_t> q(n * 2);
+        float axes[] = { 1,0,0,  -1,0,0,  0,1,0,  0,-1,0,  0,0,1,  0,0,-1 };
+        in.assign(axes, axes + 18);
+        while (in.size() < n * 3) {
+            float x = Random(-1, 1), y = Random(-1, 1), z = Random(-1, 1);
+            float l = sqrt(x*x + y*y + z*z);
+            if (l < 0.1f || l > 1.0f) continue;
+            in.push_back(x / l); in.push_back(y / l); in.push_back(z / l);
+        }
+        VertexCodec::EncodeNormals(&in[0], n, &q[0]);
+        VertexCodec::DecodeNormals(&q[0], n, &out[0]);
+        float worst = 1.0f;
+        bool unit = true;
+        for (unsigned int i=0; i<n; i++) {
+            float d = in[i*3]*out[i*3] + in[i*3+1]*out[i*3+1] + in[i*3+2]*out[i*3+2];
+            if (d < worst) worst = d;
+            float l = out[i*3]*out[i*3] + out[i*3+1]*out[i*3+1] + out[i*3+2]*out[i*3+2];
+            unit &= fabs(l - 1.0f) < 1e-5f;
+        }
+        OE_CHECK(unit);
+        OE_CHECK(worst > cos(0.05f * 3.14159265f / 180.0f));
+        for (unsigned int i=0; i<18; i++)
+            OE_CHECK(fabs(out[i] - in[i]) < 1e-6f);
+    }
+
+    // every color byte round trips, floats out of range are clamped
+    {
+        uint8_t bytes[256], back[256];
+        float f[256];
+        for (unsigned int i=0; i<256; i++) bytes[i] = i;
+        VertexCodec::DecodeColors(bytes, 64, f);
+        VertexCodec::EncodeColors(f, 64, back);
+        bool exact = true;
+        for (unsigned int i=0; i<256; i++) exact &= back[i] == bytes[i];
+        OE_CHECK(exact);
+        float c[] = { -0.5f, 1.5f, 0.5f, 1.0f };
+        uint8_t e[4];
+        VertexCodec::EncodeColors(c, 1, e);
+        OE_CHECK(e[0] == 0 && e[1] == 255 && e[2] == 128 && e[3] == 255);
+    }
+
+    return 0;
+}
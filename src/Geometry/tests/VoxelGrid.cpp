@@ -0,0 +1,126 @@
+#include <Testing/Testing.h>
+
+#include <Geometry/VoxelGrid.h>
+#include <Geometry/FaceSet.h>
+#include <Geometry/Face.h>
+
+#include <vector>
+
+using namespace std;
+using namespace OpenEngine::Geometry;
+using boost::uint64_t;
+
+// the twelve outward facing triangles of a cube
+static vector<float> Cube(float lo, float hi) {
+    float c[8][3];
+    for (int i=0; i<8; i++) {
+        c[i][0] = i & 1 ? hi : lo;
+        c[i][1] = i & 2 ? hi : lo;
+        c[i][2] = i & 4 ? hi : lo;
+    }
+    unsigned int quads[6][4] = { {0,2,3,1}, {4,5,7,6}, {0,1,5,4},
+                                 {2,6,7,3}, {0,4,6,2}, {1,3,7,5} };
+    vector<float> v;
+    for (int q=0; q<6; q++) {
+        unsigned int t[6] = { quads[q][0], quads[q][1], quads[q][2],
+                              quads[q][0], quads[q][2], quads[q][3] };
+        for (int k=0; k<6; k++)
+            v.insert(v.end(), c[t[k]], c[t[k]] + 3);
+    }
+    return v;
+}
+
+static FaceSet* Faces(const vector<float>& v) {
+    FaceSet* faces = new FaceSet();
+    for (unsigned int i=0; i<v.size(); i+=9)
+        faces->Add(FacePtr(new Face(Vector<3,float>(v[i],   v[i+1], v[i+2]),
+                                    Vector<3,float>(v[i+3], v[i+4], v[i+5]),
+                                    Vector<3,float>(v[i+6], v[i+7], v[i+8]))));
+    return faces;
+}
+
+int test_main(int argc, char* argv[]) {
+
+    // a cube covering 9 voxels a side inside a larger grid
+    {
+        vector<float> cube = Cube(1.25f, 9.75f);
+        VoxelGrid grid(Vector<3,float>(0,0,0), 1.0f,
+                       Vector<3,unsigned int>(11,11,11));
+        grid.Voxelize(&cube[0], 12);
+        OE_CHECK(grid.GetNumFilled() == 9*9*9 - 7*7*7);
+        OE_CHECK(grid.Get(1,1,1) && grid.Get(9,5,5) && !grid.Get(5,5,5));
+        OE_CHECK(!grid.Get(0,5,5) && !grid.Get(10,5,5));
+        grid.Clear();
+        OE_CHECK(grid.GetNumFilled() == 0);
+        grid.Voxelize(&cube[0], 12, true);
+        OE_CHECK(grid.GetNumFilled() == 9*9*9);
+        OE_CHECK(grid.Get(5,5,5));
+        // nothing leaks out of the cube along the rows
+        unsigned int outside = 0;
+        for (unsigned int z=0; z<11; z++)
+            for (unsigned int y=0; y<11; y++)
+                for (unsigned int x=0; x<11; x++)
+                    if (x < 1 || x > 9 || y < 1 || y > 9 || z < 1 || z > 9)
+                        outside += grid.Get(x, y, z);
+        OE_CHECK(outside == 0);
+    }
+
+    // fitted to a face set, the cube fills the grid
+    {
+        FaceSet* faces = Faces(Cube(0, 9));
+        VoxelGrid shell(*faces, 9);
+        OE_CHECK((shell.GetDimensions() == Vector<3,unsigned int>(9,9,9)));
+        OE_CHECK(shell.GetVoxelSize() == 1.0f);
+        OE_CHECK(shell.GetNumFilled() == 386);
+        VoxelGrid solid(*faces, 9, true);
+        OE_CHECK(solid.GetNumFilled() == 729);
+        delete faces;
+    }
+
+    // a sloped triangle leaves no gaps
+    {
+        float tri[] = { 0.5f,0.5f,0.5f,  15.5f,0.5f,15.5f,  0.5f,15.5f,8.0f };
+        VoxelGrid grid(Vector<3,float>(0,0,0), 1.0f,
+                       Vector<3,unsigned int>(16,16,16));
+        grid.Voxelize(tri, 1);
+        // every column under the triangle (x + y < 15) has a voxel
+        bool covered = true;
+        for (unsigned int y=0; y<15; y++)
+            for (unsigned int x=0; x+y<15; x++) {
+                bool any = false;
+                for (unsigned int z=0; z<16; z++) any |= grid.Get(x, y, z);
+                covered &= any;
+            }
+        OE_CHECK(covered);
+    }
+
+    // bricks hold the same voxels as the grid
+    {
+        VoxelGrid grid(Vector<3,float>(0,0,0), 1.0f,
+                       Vector<3,unsigned int>(10,6,5));
+        grid.Set(0,0,0, true);
+        grid.Set(9,5,4, true);
+        grid.Set(5,2,1, true);
+        grid.Set(5,2,1, false);
+        grid.Set(6,1,3, true);
+        OE_CHECK(grid.GetNumFilled() == 3);
+        vector<unsigned int> table;
+        vector<uint64_t> bricks;
+        grid.GetBricks(table, bricks);
+        OE_CHECK(table.size() == 3 * 2 * 2);
+        OE_CHECK(bricks.size() == 3);
+        unsigned int filled = 0;
+        for (unsigned int z=0; z<5; z++)
+            for (unsigned int y=0; y<6; y++)
+                for (unsigned int x=0; x<10; x++) {
+                    unsigned int b = table[(z/4 * 2 + y/4) * 3 + x/4];
+                    bool set = b != VoxelGrid::EMPTY_BRICK &&
+                        (bricks[b] >> ((z%4)*16 + (y%4)*4 + x%4)) & 1;
+                    OE_CHECK(set == grid.Get(x, y, z));
+                    filled += set;
+                }
+        OE_CHECK(filled == 3);
+    }
+
+    return 0;
+}
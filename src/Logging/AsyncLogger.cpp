@@ -0,0 +1,242 @@
+// Asynchronous logger.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+#include <Logging/AsyncLogger.h>
+#include <Utils/Convert.h>
+
+#include <boost/bind/bind.hpp>
+
+namespace OpenEngine {
+namespace Logging {
+
+using OpenEngine::Utils::Convert;
+
+/**
+ * Create an asynchronous logger and start its writer thread.
+ *
+ * @param logger Logger to write to (ownership is transferred).
+ * @param capacity Number of message slots, rounded up to a power of two.
+ * @param policy Overflow policy for a full ring.
+ */
+AsyncLogger::AsyncLogger(ILogger* logger, unsigned int capacity,
+                         OverflowPolicy policy)
+    : logger(logger)
+    , policy(policy)
+    , capacity(2)
+    , head(0)
+    , tail(0)
+    , written(0)
+    , dropped(0)
+    , reported(0)
+    , running(true)
+    , waiting(false)
+    , blocked(0)
+    , writer(NULL)
+{
+    while (this->capacity < capacity) this->capacity <<= 1;
+    mask = this->capacity - 1;
+    slots = new Slot[this->capacity];
+    for (unsigned long i=0; i<this->capacity; i++)
+        slots[i].sequence.store(i, boost::memory_order_relaxed);
+    writer = new boost::thread(boost::bind(&AsyncLogger::Run, this));
+}
+
+/**
+ * Destruct the asynchronous logger.
+ * All pending messages are written before the writer thread stops
+ * and the decorated logger is deleted.
+ */
+AsyncLogger::~AsyncLogger() {
+    running = false;
+    Wakeup();
+    writer->join();
+    delete writer;
+    delete[] slots;
+    delete logger;
+}
+
+/**
+ * Enqueue a message stamped with the current time.
+ *
+ * @param type Log message type.
+ * @param msg Message to log.
+ */
+void AsyncLogger::Write(LoggerType type, string msg) {
+    time_t t; time(&t);
+    Write(type, msg, t);
+}
+
+/**
+ * Enqueue a time stamped message.
+ * Returns as soon as the message is in the ring. If the ring is full
+ * the message is dropped or the call blocks depending on the
+ * overflow policy. A blocked call sleeps until the writer has freed
+ * a slot.
+ *
+ * @param type Log message type.
+ * @param msg Message to log.
+ * @param time Time the message was logged.
+ */
+void AsyncLogger::Write(LoggerType type, string msg, time_t time) {
+    while (!TryEnqueue(type, msg, time)) {
+        if (policy == OVERFLOW_DROP) {
+            dropped++;
+            return;
+        }
+        boost::unique_lock<boost::mutex> lock(mutex);
+        blocked++;
+        wakeup.notify_one();
+        // recheck under the lock so a slot freed before blocked was
+        // raised is not missed
+        if (IsFull())
+            room.timed_wait(lock, boost::posix_time::milliseconds(100));
+        blocked--;
+    }
+    if (waiting) Wakeup();
+}
+
+/**
+ * Block until every message enqueued before the call is written.
+ */
+void AsyncLogger::Flush() {
+    unsigned long target = head.load();
+    while (written.load() < target) {
+        Wakeup();
+        boost::this_thread::yield();
+    }
+}
+
+/**
+ * Get the number of messages dropped due to overflow.
+ *
+ * @return Number of dropped messages.
+ */
+unsigned long AsyncLogger::GetDropped() const {
+    return dropped.load();
+}
+
+/**
+ * Get the number of message slots.
+ *
+ * @return Ring capacity.
+ */
+unsigned int AsyncLogger::GetCapacity() const {
+    return capacity;
+}
+
+/**
+ * Claim a free slot and fill it.
+ * Safe to call from any number of threads.
+ *
+ * @param msg Message, swapped into the slot to avoid a copy.
+ * @return True if enqueued, false if the ring is full.
+ */
+bool AsyncLogger::TryEnqueue(LoggerType type, string& msg, time_t time) {
+    unsigned long pos = head.load(boost::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots[pos & mask];
+        unsigned long seq = slot->sequence.load(boost::memory_order_acquire);
+        long diff = (long)seq - (long)pos;
+        if (diff == 0) {
+            if (head.compare_exchange_weak(pos, pos + 1,
+                                           boost::memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            return false; // full
+        } else {
+            pos = head.load(boost::memory_order_relaxed);
+        }
+    }
+    slot->type = type;
+    slot->time = time;
+    slot->msg.swap(msg);
+    slot->sequence.store(pos + 1, boost::memory_order_release);
+    return true;
+}
+
+/**
+ * Check if the enqueue position is still taken.
+ *
+ * @return True if the ring is full.
+ */
+bool AsyncLogger::IsFull() {
+    unsigned long pos = head.load();
+    unsigned long seq =
+        slots[pos & mask].sequence.load(boost::memory_order_acquire);
+    return (long)seq - (long)pos < 0;
+}
+
+/**
+ * Write the next message in the ring to the decorated logger.
+ * Only called by the writer thread.
+ *
+ * @return True if a message was written, false if the ring is empty.
+ */
+bool AsyncLogger::Dequeue() {
+    Slot* slot = &slots[tail & mask];
+    if (slot->sequence.load(boost::memory_order_acquire) != tail + 1)
+        return false;
+    logger->Write(slot->type, slot->msg, slot->time);
+    slot->msg.clear(); // keeps the capacity for reuse
+    slot->sequence.store(tail + capacity, boost::memory_order_release);
+    tail++;
+    written++;
+    return true;
+}
+
+/**
+ * Wake up the writer if it is idle.
+ */
+void AsyncLogger::Wakeup() {
+    boost::lock_guard<boost::mutex> lock(mutex);
+    wakeup.notify_one();
+}
+
+/**
+ * Writer thread main loop.
+ * Drains the ring and sleeps when it is empty. On shutdown the ring
+ * is drained up to the last claimed slot before returning.
+ */
+void AsyncLogger::Run() {
+    for (;;) {
+        while (Dequeue());
+        if (blocked.load()) {
+            boost::lock_guard<boost::mutex> lock(mutex);
+            room.notify_all();
+        }
+        unsigned long d = dropped.load();
+        if (d != reported) {
+            time_t t; time(&t);
+            logger->Write(Warning, "Log overflow, dropped "
+                          + Convert::ToString(d - reported)
+                          + " messages.", t);
+            reported = d;
+        }
+        if (!running) {
+            // a producer may have claimed a slot without having
+            // published it yet, so wait for it instead of stopping
+            if (tail == head.load()) break;
+            if (!Dequeue()) boost::this_thread::yield();
+            continue;
+        }
+        boost::unique_lock<boost::mutex> lock(mutex);
+        waiting = true;
+        // recheck so a message enqueued before waiting was set is
+        // not left until the timeout
+        Slot* slot = &slots[tail & mask];
+        if (running &&
+            slot->sequence.load(boost::memory_order_acquire) != tail + 1)
+            wakeup.timed_wait(lock, boost::posix_time::milliseconds(100));
+        waiting = false;
+    }
+}
+
+} //NS Logging
+} //NS OpenEngine
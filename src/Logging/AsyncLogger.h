@@ -0,0 +1,116 @@
+// Asynchronous logger.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+#ifndef _ASYNC_LOGGER_H_
+#define _ASYNC_LOGGER_H_
+
+#include <Logging/ILogger.h>
+
+#include <string>
+#include <boost/atomic.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+namespace OpenEngine {
+namespace Logging {
+
+using std::string;
+
+/**
+ * Asynchronous logger.
+ * Decorates another logger so messages are formatted and written on
+ * a dedicated writer thread instead of on the logging thread.
+ *
+ * Messages are enqueued in a lock-free ring of preallocated slots
+ * and are time stamped when enqueued, so the written time is the
+ * time of logging and not the time of writing. When the ring is full
+ * the overflow policy decides if the message is dropped or if the
+ * logging thread blocks until the writer has made room. Dropped
+ * messages are reported by the writer once room is available.
+ *
+ * @code
+ * // log to standard out on a background thread
+ * Logger::AddLogger(new AsyncLogger(new StreamLogger(&std::cout)));
+ * @endcode
+ *
+ * The async logger takes ownership of the decorated logger. Deleting
+ * the async logger (fx. through Logger::Deinitialize) flushes all
+ * pending messages before stopping the writer thread.
+ *
+ * @class AsyncLogger AsyncLogger.h Logging/AsyncLogger.h
+ */
+class AsyncLogger : public ILogger {
+public:
+
+    /**
+     * Overflow policies.
+     * OVERFLOW_DROP discards messages logged while the ring is full.
+     * OVERFLOW_BLOCK makes the logging thread sleep until the writer
+     * has freed a slot.
+     */
+    enum OverflowPolicy {
+        OVERFLOW_DROP,
+        OVERFLOW_BLOCK
+    };
+
+    AsyncLogger(ILogger* logger,
+                unsigned int capacity = 1024,
+                OverflowPolicy policy = OVERFLOW_DROP);
+    virtual ~AsyncLogger();
+
+    void Write(LoggerType type, string msg);
+    void Write(LoggerType type, string msg, time_t time);
+    void Flush();
+
+    unsigned long GetDropped() const;
+    unsigned int GetCapacity() const;
+
+private:
+    // Preallocated message slot. The sequence number tells if the
+    // slot is free for the enqueue position or filled for the dequeue
+    // position [Vyukov bounded queue].
+    struct Slot {
+        boost::atomic<unsigned long> sequence;
+        LoggerType type;
+        time_t time;
+        string msg;
+    };
+
+    ILogger* logger;            //!< decorated logger
+    OverflowPolicy policy;      //!< overflow policy
+    unsigned int capacity;      //!< number of slots (power of two)
+    unsigned long mask;         //!< capacity - 1
+    Slot* slots;                //!< the ring
+
+    boost::atomic<unsigned long> head;    //!< next enqueue position
+    unsigned long tail;                   //!< next dequeue position (writer only)
+    boost::atomic<unsigned long> written; //!< messages handed to the logger
+    boost::atomic<unsigned long> dropped; //!< messages lost to overflow
+    unsigned long reported;               //!< drops reported (writer only)
+
+    boost::atomic<bool> running;
+    boost::atomic<bool> waiting;          //!< writer is idle
+    boost::atomic<unsigned int> blocked;  //!< producers waiting for room
+    boost::mutex mutex;
+    boost::condition_variable wakeup;     //!< signals the writer
+    boost::condition_variable room;       //!< signals blocked producers
+    boost::thread* writer;
+
+    bool TryEnqueue(LoggerType type, string& msg, time_t time);
+    bool IsFull();
+    bool Dequeue();
+    void Wakeup();
+    void Run();
+};
+
+} //NS Logging
+} //NS OpenEngine
+
+#endif // _ASYNC_LOGGER_H_
@@ -0,0 +1,281 @@
+// Binary log decoder.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+#include <Logging/BinaryLogDecoder.h>
+#include <Logging/BinaryLogger.h>
+#include <Logging/ILogger.h>
+#include <Utils/Convert.h>
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+
+namespace OpenEngine {
+namespace Logging {
+
+using OpenEngine::Utils::Convert;
+using boost::int32_t;
+using boost::int64_t;
+using boost::uint8_t;
+using boost::uint16_t;
+using boost::uint32_t;
+using boost::uint64_t;
+
+// Reverse the bytes of a value read from a log of the other byte
+// order.
+static void Swap(void* data, unsigned int size) {
+    char* bytes = (char*)data;
+    std::reverse(bytes, bytes + size);
+}
+
+// Read an argument value from a record.
+template <class T>
+static T Get(const char* args, unsigned int& pos, bool swap) {
+    T value;
+    memcpy(&value, args + pos, sizeof(T));
+    if (swap) Swap(&value, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+// Size of the value of an argument with a given tag, not counting a
+// string's characters.
+static unsigned int TagSize(uint8_t tag) {
+    switch (tag) {
+    case BinaryLogger::ARG_INT32:
+    case BinaryLogger::ARG_UINT32:
+    case BinaryLogger::ARG_FLOAT:  return 4;
+    case BinaryLogger::ARG_INT64:
+    case BinaryLogger::ARG_UINT64:
+    case BinaryLogger::ARG_DOUBLE: return 8;
+    case BinaryLogger::ARG_STRING: return 2;
+    }
+    return 0;
+}
+
+/**
+ * Create a decoder reading from \a stream.
+ * The file header is read and checked immediately.
+ *
+ * @param stream Binary stream holding the log.
+ */
+BinaryLogDecoder::BinaryLogDecoder(istream* stream)
+    : stream(stream), valid(false), swap(false) {
+    char magic[4];
+    uint32_t order;
+    if (!ReadRaw(magic, sizeof(magic)) || !ReadRaw(&order, sizeof(order)))
+        return;
+    if (memcmp(magic, BinaryLogger::MAGIC, sizeof(magic)) != 0)
+        return;
+    if (order == BinaryLogger::BYTE_ORDER_MARK)
+        valid = true;
+    else {
+        Swap(&order, sizeof(order));
+        swap = valid = (order == BinaryLogger::BYTE_ORDER_MARK);
+    }
+}
+
+/**
+ * Destructor.
+ */
+BinaryLogDecoder::~BinaryLogDecoder() {}
+
+/**
+ * Check that the stream holds a binary log.
+ *
+ * @return True if the file header is valid.
+ */
+bool BinaryLogDecoder::IsValid() const {
+    return valid;
+}
+
+/**
+ * Read the next record.
+ * Format definitions are consumed on the way.
+ *
+ * @param entry Entry to read into.
+ * @return True if a record was read, false at the end of the log or
+ * if the log is truncated.
+ */
+bool BinaryLogDecoder::Next(Entry& entry) {
+    if (!valid) return false;
+    for (;;) {
+        uint8_t kind;
+        if (!ReadRaw(&kind, sizeof(kind))) return false;
+        if (kind == BinaryLogger::ENTRY_FORMAT) {
+            uint32_t id;
+            uint16_t len;
+            if (!Read(&id, sizeof(id)) || !Read(&len, sizeof(len)))
+                return false;
+            string format(len, '\0');
+            if (len > 0 && !ReadRaw(&format[0], len)) return false;
+            if (id >= formats.size()) formats.resize(id + 1);
+            formats[id] = format;
+        } else if (kind == BinaryLogger::ENTRY_RECORD) {
+            uint8_t type;
+            uint32_t id;
+            uint64_t time;
+            uint16_t size;
+            char args[0x10000];
+            if (!ReadRaw(&type, sizeof(type)) || !Read(&id, sizeof(id)) ||
+                !Read(&time, sizeof(time)) || !Read(&size, sizeof(size)))
+                return false;
+            if (size > 0 && !ReadRaw(args, size)) return false;
+            entry.type = (LoggerType)type;
+            entry.format = id;
+            entry.time = time;
+            entry.text = Render(id, args, size);
+            return true;
+        } else {
+            // unknown entry, the rest of the log can not be trusted
+            valid = false;
+            return false;
+        }
+    }
+}
+
+/**
+ * Write all remaining records to a text logger.
+ *
+ * @param logger Logger to write to, fx. a StreamLogger.
+ * @return Number of records written.
+ */
+unsigned int BinaryLogDecoder::Decode(ILogger* logger) {
+    unsigned int count = 0;
+    Entry e;
+    while (Next(e)) {
+        logger->Write(e.type, e.text, (time_t)(e.time / 1000000));
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Render the arguments of a record using its format.
+ * Conversions are matched with arguments in order. The length
+ * modifier of a conversion is replaced to fit the stored argument, so
+ * fx. %d renders both 32 and 64 bit integers. Missing arguments are
+ * rendered as "?" and extra arguments are appended.
+ *
+ * @param format Format id.
+ * @param args Tagged arguments.
+ * @param size Size of the arguments in bytes.
+ * @return The rendered text.
+ */
+string BinaryLogDecoder::Render(unsigned int format, const char* args,
+                                unsigned int size) const {
+    string fmt = "%s";
+    if (format < formats.size()) fmt = formats[format];
+    else if (format != 0)
+        fmt = "<unknown format " + Convert::ToString(format) + ">";
+
+    string out;
+    unsigned int pos = 0;
+    char buf[512];
+    unsigned int i = 0;
+    for (;;) {
+        // copy literal text up to the next conversion
+        unsigned int start = i;
+        while (i < fmt.size() && fmt[i] != '%') i++;
+        out.append(fmt, start, i - start);
+        bool extra = i >= fmt.size();
+        if (!extra && i + 1 < fmt.size() && fmt[i+1] == '%') {
+            out += '%';
+            i += 2;
+            continue;
+        }
+        // parse flags, width and precision, skip the length modifier
+        string spec = "%";
+        char conv = 's';
+        if (!extra) {
+            i++;
+            while (i < fmt.size() && strchr("-+ #0123456789.", fmt[i]))
+                spec += fmt[i++];
+            while (i < fmt.size() && strchr("hlLqjzt", fmt[i])) i++;
+            if (i < fmt.size()) conv = fmt[i++];
+        }
+        if (pos >= size) {
+            if (extra) break;
+            out += "?";
+            continue;
+        }
+        if (extra) out += " ";
+        uint8_t tag = args[pos++];
+        if (pos + TagSize(tag) > size) break;
+        bool integer = strchr("diouxX", conv) != NULL;
+        bool real = strchr("fFeEgGaA", conv) != NULL;
+        switch (tag) {
+        case BinaryLogger::ARG_INT32:
+        case BinaryLogger::ARG_INT64: {
+            long long v = (tag == BinaryLogger::ARG_INT32)
+                ? (long long)Get<int32_t>(args, pos, swap)
+                : (long long)Get<int64_t>(args, pos, swap);
+            if (real) snprintf(buf, sizeof(buf), (spec + conv).c_str(), (double)v);
+            else if (integer) snprintf(buf, sizeof(buf), (spec + "ll" + conv).c_str(), v);
+            else snprintf(buf, sizeof(buf), (spec + "lld").c_str(), v);
+            break;
+        }
+        case BinaryLogger::ARG_UINT32:
+        case BinaryLogger::ARG_UINT64: {
+            unsigned long long v = (tag == BinaryLogger::ARG_UINT32)
+                ? (unsigned long long)Get<uint32_t>(args, pos, swap)
+                : (unsigned long long)Get<uint64_t>(args, pos, swap);
+            if (real) snprintf(buf, sizeof(buf), (spec + conv).c_str(), (double)v);
+            else if (integer) snprintf(buf, sizeof(buf), (spec + "ll" + conv).c_str(), v);
+            else snprintf(buf, sizeof(buf), (spec + "llu").c_str(), v);
+            break;
+        }
+        case BinaryLogger::ARG_FLOAT:
+        case BinaryLogger::ARG_DOUBLE: {
+            double v = (tag == BinaryLogger::ARG_FLOAT)
+                ? (double)Get<float>(args, pos, swap)
+                : Get<double>(args, pos, swap);
+            if (integer) snprintf(buf, sizeof(buf), (spec + "lld").c_str(), (long long)v);
+            else if (real) snprintf(buf, sizeof(buf), (spec + conv).c_str(), v);
+            else snprintf(buf, sizeof(buf), (spec + "g").c_str(), v);
+            break;
+        }
+        case BinaryLogger::ARG_STRING: {
+            uint16_t len = Get<uint16_t>(args, pos, swap);
+            if (pos + len > size) len = size - pos;
+            string str(args + pos, len);
+            pos += len;
+            if (spec == "%") { out += str; buf[0] = '\0'; }
+            else snprintf(buf, sizeof(buf), (spec + "s").c_str(), str.c_str());
+            break;
+        }
+        default:
+            // unknown tag, the remaining arguments can not be read
+            out += "?";
+            return out;
+        }
+        out += buf;
+    }
+    return out;
+}
+
+/**
+ * Read a number, converting its byte order if needed.
+ */
+bool BinaryLogDecoder::Read(void* data, unsigned int size) {
+    if (!ReadRaw(data, size)) return false;
+    if (swap) Swap(data, size);
+    return true;
+}
+
+/**
+ * Read raw bytes.
+ */
+bool BinaryLogDecoder::ReadRaw(void* data, unsigned int size) {
+    stream->read((char*)data, size);
+    return (unsigned int)stream->gcount() == size;
+}
+
+} //NS Logging
+} //NS OpenEngine
@@ -0,0 +1,83 @@
+// Binary log decoder.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+#ifndef _BINARY_LOG_DECODER_H_
+#define _BINARY_LOG_DECODER_H_
+
+#include <Logging/LoggerType.h>
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <boost/cstdint.hpp>
+
+namespace OpenEngine {
+namespace Logging {
+
+using std::string;
+using std::vector;
+using std::istream;
+
+// forward declarations
+class ILogger;
+
+/**
+ * Binary log decoder.
+ * Reads a log written by BinaryLogger and renders the records as
+ * text. Logs written on a machine of the other byte order are
+ * converted while reading.
+ *
+ * @code
+ * ifstream in("frame.oebl", ios::binary);
+ * BinaryLogDecoder decoder(&in);
+ * BinaryLogDecoder::Entry e;
+ * while (decoder.Next(e))
+ *     cout << e.time << " " << e.text << endl;
+ * @endcode
+ *
+ * The decoder does not take ownership of the stream.
+ *
+ * @class BinaryLogDecoder BinaryLogDecoder.h Logging/BinaryLogDecoder.h
+ */
+class BinaryLogDecoder {
+public:
+
+    /**
+     * A decoded record.
+     */
+    struct Entry {
+        LoggerType type;        //!< log message type
+        unsigned int format;    //!< format id
+        boost::uint64_t time;   //!< microseconds since the epoch (UTC)
+        string text;            //!< rendered message
+    };
+
+    BinaryLogDecoder(istream* stream);
+    virtual ~BinaryLogDecoder();
+
+    bool IsValid() const;
+    bool Next(Entry& entry);
+    unsigned int Decode(ILogger* logger);
+
+    string Render(unsigned int format, const char* args, unsigned int size) const;
+
+private:
+    istream* stream;
+    bool valid;
+    bool swap;                  //!< log has the other byte order
+    vector<string> formats;
+
+    bool Read(void* data, unsigned int size);
+    bool ReadRaw(void* data, unsigned int size);
+};
+
+} //NS Logging
+} //NS OpenEngine
+
+#endif // _BINARY_LOG_DECODER_H_
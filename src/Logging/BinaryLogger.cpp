@@ -0,0 +1,364 @@
+// Binary logger.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+#include <Logging/BinaryLogger.h>
+
+#include <map>
+#include <cstring>
+
+#if defined(_WIN32)
+    #include <Windows.h>
+#else
+    #include <sys/time.h>
+#endif
+
+namespace OpenEngine {
+namespace Logging {
+
+using std::map;
+using boost::int32_t;
+using boost::int64_t;
+using boost::uint8_t;
+using boost::uint16_t;
+using boost::uint32_t;
+using boost::uint64_t;
+
+const char BinaryLogger::MAGIC[4] = {'O', 'E', 'B', 'L'};
+const uint32_t BinaryLogger::BYTE_ORDER_MARK = 0x01020304;
+const unsigned int BinaryLogger::MAX_RECORD;
+
+// The format registry is shared by all binary loggers. It is created
+// on first use so formats can be registered during static
+// initialization.
+static boost::mutex& FormatMutex() {
+    static boost::mutex mutex;
+    return mutex;
+}
+static vector<string>& Formats() {
+    static vector<string> formats(1, "%s"); // id 0 is text messages
+    return formats;
+}
+static map<string,unsigned int>& FormatIds() {
+    static map<string,unsigned int> ids;
+    return ids;
+}
+
+/**
+ * Register a format string.
+ * Registering the same string twice returns the same id.
+ *
+ * @param format Printf style format string.
+ * @return Format id to log records with.
+ */
+unsigned int BinaryLogger::RegisterFormat(const string format) {
+    boost::mutex::scoped_lock lock(FormatMutex());
+    map<string,unsigned int>::iterator itr = FormatIds().find(format);
+    if (itr != FormatIds().end()) return itr->second;
+    unsigned int id = Formats().size();
+    Formats().push_back(format);
+    FormatIds()[format] = id;
+    return id;
+}
+
+/**
+ * Get a registered format string.
+ *
+ * @param id Format id.
+ * @return The format string or an empty string for unknown ids.
+ */
+string BinaryLogger::GetFormat(unsigned int id) {
+    boost::mutex::scoped_lock lock(FormatMutex());
+    if (id >= Formats().size()) return "";
+    return Formats()[id];
+}
+
+/**
+ * Get the current time as used in binary log records.
+ *
+ * @return Microseconds since the epoch (UTC).
+ */
+uint64_t BinaryLogger::GetTime() {
+    // read the system clock directly, as for Timer::GetSystemTime
+#if defined(_WIN32)
+    FILETIME ft;
+    GetSystemTimeAsFileTime(&ft);
+    uint64_t t = ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+    // 100 ns intervals since 1601 to microseconds since 1970
+    return t / 10 - 11644473600000000ULL;
+#else
+    struct timeval t;
+    gettimeofday(&t, NULL);
+    return (uint64_t)t.tv_sec * 1000000 + t.tv_usec;
+#endif
+}
+
+/**
+ * Create a binary logger.
+ * The file header is written immediately.
+ *
+ * @param stream Binary stream to log to (ownership is transferred).
+ * @param bufferSize Bytes to collect before writing to the stream.
+ */
+BinaryLogger::BinaryLogger(ostream* stream, unsigned int bufferSize)
+    : stream(stream), bufferSize(bufferSize), local(&KeepBuffer) {
+    stream->write(MAGIC, sizeof(MAGIC));
+    stream->write((const char*)&BYTE_ORDER_MARK, sizeof(BYTE_ORDER_MARK));
+}
+
+/**
+ * Destruct the binary logger.
+ * Flushes and deletes the stream. No thread may log during or
+ * after destruction.
+ */
+BinaryLogger::~BinaryLogger() {
+    Flush();
+    local.release();
+    for (unsigned int i=0; i<buffers.size(); i++)
+        delete buffers[i];
+    delete stream;
+}
+
+// the buffers belong to the logger, not the threads
+void BinaryLogger::KeepBuffer(Buffer* b) {}
+
+/**
+ * Get the buffer of the calling thread, creating it on first use.
+ */
+BinaryLogger::Buffer& BinaryLogger::LocalBuffer() {
+    Buffer* b = local.get();
+    if (b == NULL) {
+        b = new Buffer();
+        b->data.reserve(bufferSize + MAX_RECORD * 2);
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            buffers.push_back(b);
+        }
+        local.reset(b);
+    }
+    return *b;
+}
+
+/**
+ * Log a text message as a record of format id 0.
+ *
+ * @param type Log message type.
+ * @param msg Message to log.
+ */
+void BinaryLogger::Write(LoggerType type, string msg) {
+    Record(this, type, 0) << msg;
+}
+
+/**
+ * Log a time stamped text message as a record of format id 0.
+ *
+ * @param type Log message type.
+ * @param msg Message to log.
+ * @param time Time the message was logged.
+ */
+void BinaryLogger::Write(LoggerType type, string msg, time_t time) {
+    char args[MAX_RECORD];
+    uint16_t len = msg.size() < MAX_RECORD - 3 ? msg.size() : MAX_RECORD - 3;
+    args[0] = ARG_STRING;
+    memcpy(args + 1, &len, sizeof(len));
+    memcpy(args + 3, msg.data(), len);
+    WriteRecord(type, 0, (uint64_t)time * 1000000, args, len + 3);
+}
+
+/**
+ * Write all buffered records to the stream.
+ */
+void BinaryLogger::Flush() {
+    boost::mutex::scoped_lock lock(mutex);
+    for (unsigned int i=0; i<buffers.size(); i++)
+        WriteBuffer(*buffers[i]);
+    stream->flush();
+}
+
+/**
+ * Append a record to the buffer of the calling thread.
+ * The format is defined in the buffer first if it has not been used
+ * in it before.
+ */
+void BinaryLogger::WriteRecord(LoggerType type, unsigned int format,
+                               uint64_t time, const char* args,
+                               unsigned int size) {
+    uint8_t kind = ENTRY_RECORD;
+    uint8_t ltype = type;
+    uint32_t id = format;
+    uint16_t bytes = size;
+    Buffer& b = LocalBuffer();
+    unsigned int filled;
+    {
+        // only contended while the buffer is swapped out
+        boost::mutex::scoped_lock lock(b.mutex);
+        if (format >= b.defined.size() || !b.defined[format]) Define(b, format);
+        // grow once and copy in kind, type, id, time and size
+        unsigned int at = b.data.size();
+        b.data.resize(at + 16 + size);
+        char* p = &b.data[at];
+        memcpy(p, &kind, 1);
+        memcpy(p + 1, &ltype, 1);
+        memcpy(p + 2, &id, 4);
+        memcpy(p + 6, &time, 8);
+        memcpy(p + 14, &bytes, 2);
+        memcpy(p + 16, args, size);
+        filled = b.data.size();
+    }
+    if (filled < bufferSize) return;
+    // the stream is shared, so rather than queue up behind another
+    // thread writing, keep logging into the buffer for a while
+    boost::mutex::scoped_lock lock(mutex, boost::try_to_lock);
+    if (!lock.owns_lock()) {
+        if (filled < bufferSize * 4) return;
+        lock.lock();
+    }
+    WriteBuffer(b);
+}
+
+/**
+ * Write the records of a buffer to the stream. Must hold the mutex.
+ * The thread may keep logging into the buffer meanwhile.
+ */
+void BinaryLogger::WriteBuffer(Buffer& b) {
+    {
+        boost::mutex::scoped_lock lock(b.mutex);
+        b.data.swap(b.writing);
+        b.defined.clear();
+    }
+    if (!b.writing.empty())
+        stream->write(&b.writing[0], b.writing.size());
+    b.writing.clear();
+}
+
+/**
+ * Append a format entry to a buffer. Must hold the buffer mutex.
+ */
+void BinaryLogger::Define(Buffer& b, unsigned int format) {
+    string str = GetFormat(format);
+    uint8_t kind = ENTRY_FORMAT;
+    uint32_t id = format;
+    uint16_t len = str.size() < 0xffff ? str.size() : 0xffff;
+    Put(b, &kind, sizeof(kind));
+    Put(b, &id, sizeof(id));
+    Put(b, &len, sizeof(len));
+    Put(b, str.data(), len);
+    if (format >= b.defined.size()) b.defined.resize(format + 1, false);
+    b.defined[format] = true;
+}
+
+/**
+ * Append raw bytes to a buffer.
+ */
+void BinaryLogger::Put(Buffer& b, const void* data, unsigned int size) {
+    const char* bytes = (const char*)data;
+    b.data.insert(b.data.end(), bytes, bytes + size);
+}
+
+/**
+ * Start a record.
+ *
+ * @param logger Binary logger to write the record to.
+ * @param type Log message type.
+ * @param format Id of a registered format.
+ */
+BinaryLogger::Record::Record(BinaryLogger* logger, LoggerType type,
+                             unsigned int format)
+    : logger(logger), type(type), format(format), size(0) {}
+
+/**
+ * Write the record to the logger.
+ */
+BinaryLogger::Record::~Record() {
+    logger->WriteRecord(type, format, GetTime(), data, size);
+}
+
+/**
+ * Append a tagged argument if it fits in the record.
+ */
+void BinaryLogger::Record::Append(ArgumentTag tag, const void* value,
+                                  unsigned int bytes) {
+    if (size + 1 + bytes > MAX_RECORD) return;
+    data[size++] = tag;
+    memcpy(data + size, value, bytes);
+    size += bytes;
+}
+
+BinaryLogger::Record& BinaryLogger::Record::operator<<(int arg) {
+    int32_t v = arg;
+    Append(ARG_INT32, &v, sizeof(v));
+    return *this;
+}
+
+BinaryLogger::Record& BinaryLogger::Record::operator<<(unsigned int arg) {
+    uint32_t v = arg;
+    Append(ARG_UINT32, &v, sizeof(v));
+    return *this;
+}
+
+BinaryLogger::Record& BinaryLogger::Record::operator<<(long arg) {
+    int64_t v = arg;
+    Append(ARG_INT64, &v, sizeof(v));
+    return *this;
+}
+
+BinaryLogger::Record& BinaryLogger::Record::operator<<(unsigned long arg) {
+    uint64_t v = arg;
+    Append(ARG_UINT64, &v, sizeof(v));
+    return *this;
+}
+
+BinaryLogger::Record& BinaryLogger::Record::operator<<(long long arg) {
+    int64_t v = arg;
+    Append(ARG_INT64, &v, sizeof(v));
+    return *this;
+}
+
+BinaryLogger::Record& BinaryLogger::Record::operator<<(unsigned long long arg) {
+    uint64_t v = arg;
+    Append(ARG_UINT64, &v, sizeof(v));
+    return *this;
+}
+
+BinaryLogger::Record& BinaryLogger::Record::operator<<(float arg) {
+    Append(ARG_FLOAT, &arg, sizeof(arg));
+    return *this;
+}
+
+BinaryLogger::Record& BinaryLogger::Record::operator<<(double arg) {
+    Append(ARG_DOUBLE, &arg, sizeof(arg));
+    return *this;
+}
+
+BinaryLogger::Record& BinaryLogger::Record::operator<<(const char* arg) {
+    AppendString(arg, strlen(arg));
+    return *this;
+}
+
+BinaryLogger::Record& BinaryLogger::Record::operator<<(const string& arg) {
+    AppendString(arg.data(), arg.size());
+    return *this;
+}
+
+/**
+ * Append a string argument.
+ * Strings too long for the record are truncated.
+ */
+void BinaryLogger::Record::AppendString(const char* str, unsigned int len) {
+    if (size + 3 > MAX_RECORD) return;
+    if (size + 3 + len > MAX_RECORD) len = MAX_RECORD - size - 3;
+    uint16_t l = len;
+    data[size++] = ARG_STRING;
+    memcpy(data + size, &l, sizeof(l));
+    size += sizeof(l);
+    memcpy(data + size, str, len);
+    size += len;
+}
+
+} //NS Logging
+} //NS OpenEngine
@@ -0,0 +1,172 @@
+// Binary logger.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+#ifndef _BINARY_LOGGER_H_
+#define _BINARY_LOGGER_H_
+
+#include <Logging/ILogger.h>
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+namespace OpenEngine {
+namespace Logging {
+
+using std::string;
+using std::vector;
+using std::ostream;
+
+/**
+ * Binary logger.
+ * Writes log records in a compact binary format instead of text.
+ * Call sites register a printf style format string once and log
+ * records holding only the format id, a time stamp and the raw
+ * arguments. The text is rendered offline by BinaryLogDecoder (or the
+ * BinaryLogDecode tool), so no formatting is done while logging.
+ *
+ * @code
+ * BinaryLogger* blog = new BinaryLogger(new ofstream("frame.oebl", ios::binary));
+ * Logger::AddLogger(blog); // text messages are logged as well
+ *
+ * static const unsigned int culled =
+ *     BinaryLogger::RegisterFormat("culled %u of %u nodes in %.2f ms");
+ * BinaryLogger::Record(blog, Info, culled) << n << total << ms;
+ * @endcode
+ *
+ * The record is written when the Record object goes out of scope.
+ * Each thread collects its records in a buffer of its own, so
+ * logging threads do not wait for each other. A buffer is written to
+ * the stream when full, on Flush and when the logger is deleted. A
+ * thread finding the stream busy with another buffer keeps filling
+ * its own, up to four times the buffer size, instead of waiting. Each
+ * written buffer defines the formats it uses, so the log decodes however the
+ * buffers of different threads end up interleaved. Records of one
+ * thread keep their order; records of different threads are only
+ * ordered by their time stamps. The logger takes ownership of the
+ * stream.
+ *
+ * Buffers of threads that have exited are kept until the logger is
+ * deleted, so loggers should not outlive many short lived threads.
+ *
+ * Text messages written through the ILogger interface are stored as
+ * a record with the single string argument of format id 0 ("%s").
+ *
+ * @class BinaryLogger BinaryLogger.h Logging/BinaryLogger.h
+ */
+class BinaryLogger : public ILogger {
+public:
+
+    /**
+     * Entry kinds in the binary log.
+     * A format entry defines a format id before its first use in the
+     * log, so every log file can be decoded on its own.
+     */
+    enum EntryKind {
+        ENTRY_FORMAT = 1,
+        ENTRY_RECORD = 2
+    };
+
+    /**
+     * Argument tags.
+     * Every argument is stored as a one byte tag and its raw value.
+     * Strings are stored as a 16 bit length and the characters.
+     */
+    enum ArgumentTag {
+        ARG_INT32  = 1,
+        ARG_UINT32 = 2,
+        ARG_INT64  = 3,
+        ARG_UINT64 = 4,
+        ARG_FLOAT  = 5,
+        ARG_DOUBLE = 6,
+        ARG_STRING = 7
+    };
+
+    static const char MAGIC[4];                 //!< file signature
+    static const boost::uint32_t BYTE_ORDER_MARK; //!< byte order mark
+    static const unsigned int MAX_RECORD = 256; //!< maximum argument bytes
+
+    /**
+     * A single binary log record.
+     * Arguments are appended with the << operators and the record is
+     * written to the logger when it is destructed. Arguments that do
+     * not fit in MAX_RECORD bytes are left out.
+     */
+    class Record {
+    public:
+        Record(BinaryLogger* logger, LoggerType type, unsigned int format);
+        ~Record();
+        Record& operator<<(int arg);
+        Record& operator<<(unsigned int arg);
+        Record& operator<<(long arg);
+        Record& operator<<(unsigned long arg);
+        Record& operator<<(long long arg);
+        Record& operator<<(unsigned long long arg);
+        Record& operator<<(float arg);
+        Record& operator<<(double arg);
+        Record& operator<<(const char* arg);
+        Record& operator<<(const string& arg);
+    private:
+        BinaryLogger* logger;
+        LoggerType type;
+        unsigned int format;
+        unsigned int size;
+        char data[MAX_RECORD];
+        Record(const Record&);
+        Record& operator=(const Record&);
+        void Append(ArgumentTag tag, const void* value, unsigned int bytes);
+        void AppendString(const char* str, unsigned int len);
+    };
+
+    BinaryLogger(ostream* stream, unsigned int bufferSize = 1 << 16);
+    virtual ~BinaryLogger();
+
+    void Write(LoggerType type, string msg);
+    void Write(LoggerType type, string msg, time_t time);
+    void Flush();
+
+    static unsigned int RegisterFormat(const string format);
+    static string GetFormat(unsigned int id);
+    static boost::uint64_t GetTime();
+
+private:
+    // records of one thread, padded so the buffers of different
+    // threads do not share cache lines
+    struct Buffer {
+        char front[64];
+        boost::mutex mutex;     //!< held by the thread and while swapping
+        vector<char> data;      //!< records not yet written
+        vector<char> writing;   //!< records being written
+        vector<bool> defined;   //!< formats defined in data
+        char back[64];
+    };
+
+    ostream* stream;
+    unsigned int bufferSize;
+    boost::thread_specific_ptr<Buffer> local; //!< not owned
+    vector<Buffer*> buffers;                  //!< all buffers, owned
+    boost::mutex mutex;                       //!< guards stream and buffers
+
+    Buffer& LocalBuffer();
+    void WriteRecord(LoggerType type, unsigned int format,
+                     boost::uint64_t time, const char* args,
+                     unsigned int size);
+    void WriteBuffer(Buffer& b);
+    static void Define(Buffer& b, unsigned int format);
+    static void Put(Buffer& b, const void* data, unsigned int size);
+    static void KeepBuffer(Buffer* b);
+};
+
+} //NS Logging
+} //NS OpenEngine
+
+#endif // _BINARY_LOGGER_H_
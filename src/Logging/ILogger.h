@@ -11,6 +11,7 @@
 #define _INTERFACE_LOGGER_H_
 
 #include <string>
+#include <ctime>
 #include <Logging/LoggerType.h>
 
 namespace OpenEngine {
@@ -37,6 +38,20 @@ public:
      */
     virtual void Write(LoggerType type, string msg) = 0;
 
+    /**
+     * Write a time stamped string to a logger.
+     * Used when the message is written after it was logged, such as
+     * by the \a AsyncLogger. Loggers that print time stamps should
+     * override this, the default ignores the time stamp.
+     *
+     * @param type Logger type to log.
+     * @param msg Message to log.
+     * @param time Time the message was logged.
+     */
+    virtual void Write(LoggerType type, string msg, time_t time) {
+        Write(type, msg);
+    }
+
 };
 
 } //NS Logging
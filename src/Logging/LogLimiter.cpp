@@ -0,0 +1,185 @@
+// Log statement rate limiter.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+#include <Logging/LogLimiter.h>
+#include <Logging/Logger.h>
+#include <Utils/Convert.h>
+
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace OpenEngine {
+namespace Logging {
+
+using OpenEngine::Utils::Convert;
+using boost::uint64_t;
+
+// All live limiters, for FlushAll. Created on first use as limiters
+// are static objects of other translation units.
+static boost::mutex& LimiterMutex() {
+    static boost::mutex mutex;
+    return mutex;
+}
+static list<LogLimiter*>& Limiters() {
+    static list<LogLimiter*> limiters;
+    return limiters;
+}
+
+// Current time in microseconds.
+static uint64_t GetTime() {
+    static const boost::posix_time::ptime epoch(boost::gregorian::date(1970, 1, 1));
+    return (boost::posix_time::microsec_clock::universal_time() - epoch)
+        .total_microseconds();
+}
+
+/**
+ * Create a limiter for a log statement.
+ *
+ * @param type Logger type of the statement.
+ * @param file Source file of the statement.
+ * @param line Source line of the statement.
+ * @param burst Number of messages allowed per window.
+ * @param window Window length in seconds.
+ */
+LogLimiter::LogLimiter(LoggerType type, const char* file, int line,
+                       unsigned int burst, unsigned int window)
+    : type(type)
+    , burst(burst)
+    , window((uint64_t)window * 1000000)
+    , count(0)
+    , start(GetTime())
+{
+    // the file name is enough to find the statement
+    string path(file);
+    string::size_type slash = path.find_last_of("/\\");
+    if (slash != string::npos) path = path.substr(slash + 1);
+    site = path + ":" + Convert::ToString(line);
+    boost::mutex::scoped_lock lock(LimiterMutex());
+    Limiters().push_back(this);
+}
+
+/**
+ * Destructor.
+ */
+LogLimiter::~LogLimiter() {
+    boost::mutex::scoped_lock lock(LimiterMutex());
+    Limiters().remove(this);
+}
+
+/**
+ * Check a formatted message before it is written.
+ * A message identical to one already written in the current window
+ * is counted instead of written. Ends the window if it has passed.
+ *
+ * @param msg The formatted message.
+ * @return True if the message should be written.
+ */
+bool LogLimiter::Filter(const string& msg) {
+    list<string> summaries;
+    bool write;
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        uint64_t now = GetTime();
+        if (now - start >= window) {
+            // this call is the first of the new window
+            Summarize(count.exchange(1) - 1, now, summaries);
+        }
+        // at most burst messages get here per window, so the map
+        // stays small
+        map<string, unsigned int>::iterator itr = seen.find(msg);
+        write = itr == seen.end();
+        if (write) seen[msg] = 0;
+        else itr->second++;
+    }
+    Write(summaries);
+    return write;
+}
+
+/**
+ * Write the summary of the current window and start a new one.
+ */
+void LogLimiter::Flush() {
+    list<string> summaries;
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        Summarize(count.exchange(0), GetTime(), summaries);
+    }
+    Write(summaries);
+}
+
+/**
+ * Write the summaries of all limiters.
+ */
+void LogLimiter::FlushAll() {
+    boost::mutex::scoped_lock lock(LimiterMutex());
+    list<LogLimiter*>::iterator itr;
+    for (itr = Limiters().begin(); itr != Limiters().end(); itr++)
+        (*itr)->Flush();
+}
+
+/**
+ * Start a new window if the current one has passed.
+ * Called by Allow when the burst is used up.
+ *
+ * @return True if a new window was started and the call may log.
+ */
+bool LogLimiter::Restart() {
+    list<string> summaries;
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        uint64_t now = GetTime();
+        if (now - start < window) return false;
+        Summarize(count.exchange(1) - 1, now, summaries);
+    }
+    Write(summaries);
+    return true;
+}
+
+/**
+ * Build the summaries of the current window and reset it.
+ * Must hold the mutex.
+ *
+ * @param calls Number of times the statement was reached.
+ * @param now Start of the next window.
+ * @param summaries List to append one line per repeated message to,
+ * left empty if nothing was held back.
+ */
+void LogLimiter::Summarize(unsigned int calls, uint64_t now,
+                           list<string>& summaries) {
+    unsigned int suppressed = (calls > burst) ? calls - burst : 0;
+    map<string, unsigned int>::iterator itr;
+    for (itr = seen.begin(); itr != seen.end(); itr++)
+        if (itr->second > 0)
+            summaries.push_back(site + ": \"" + itr->first + "\" repeated "
+                                + Convert::ToString(itr->second) + " times");
+    if (suppressed > 0) {
+        if (summaries.empty())
+            summaries.push_back(site + ": " + Convert::ToString(suppressed)
+                                + " messages suppressed");
+        else
+            summaries.back() += ", " + Convert::ToString(suppressed)
+                + " more suppressed";
+    }
+    start = now;
+    seen.clear();
+}
+
+/**
+ * Write summaries to the log.
+ * Must not hold the mutex, as the loggers may log again.
+ *
+ * @param summaries Summaries to write.
+ */
+void LogLimiter::Write(const list<string>& summaries) {
+    list<string>::const_iterator itr;
+    for (itr = summaries.begin(); itr != summaries.end(); itr++)
+        Logger::WriteToLog(type, *itr);
+}
+
+} //NS Logging
+} //NS OpenEngine
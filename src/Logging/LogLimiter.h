@@ -0,0 +1,93 @@
+// Log statement rate limiter.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+#ifndef _LOG_LIMITER_H_
+#define _LOG_LIMITER_H_
+
+#include <Logging/LoggerType.h>
+
+#include <string>
+#include <list>
+#include <map>
+#include <boost/atomic.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/thread/mutex.hpp>
+
+namespace OpenEngine {
+namespace Logging {
+
+using std::string;
+using std::list;
+using std::map;
+
+/**
+ * Log statement rate limiter.
+ * Limits a single log statement (a call site) to a burst of messages
+ * per time window and drops messages already written in the window.
+ * What was held back is summarized when the window ends, one line per
+ * repeated message, fx.
+ * @code
+ * FaceSet.cpp:259: "f1 in case -1 is invalid after split" repeated 9 times
+ * FaceSet.cpp:259: "f2 in case 1 is invalid after split" repeated 3 times, 4211 more suppressed
+ * @endcode
+ *
+ * Limiters are not used directly but through the OE_LOG_*_LIMITED
+ * macros in Logger.h, which keep one static limiter per call site.
+ * Once the burst is used up a statement costs one atomic increment
+ * and its arguments are not evaluated. The end of a window is only
+ * noticed when the statement is reached again, so summaries of
+ * statements that stopped firing are written by FlushAll (called by
+ * Logger::Deinitialize).
+ *
+ * @class LogLimiter LogLimiter.h Logging/LogLimiter.h
+ */
+class LogLimiter {
+public:
+    LogLimiter(LoggerType type, const char* file, int line,
+               unsigned int burst = 10, unsigned int window = 5);
+    virtual ~LogLimiter();
+
+    /**
+     * Check if the statement may log.
+     * Only the increment is done while the burst lasts. After that
+     * the clock is checked every 64th call to start a new window.
+     *
+     * @return True if the statement should be formatted.
+     */
+    bool Allow() {
+        unsigned int c = count.fetch_add(1, boost::memory_order_relaxed);
+        return c < burst || ((c & 63) == 0 && Restart());
+    }
+
+    bool Filter(const string& msg);
+    void Flush();
+
+    static void FlushAll();
+
+private:
+    LoggerType type;
+    string site;                        //!< file:line
+    unsigned int burst;                 //!< messages per window
+    boost::uint64_t window;             //!< window length in microseconds
+    boost::atomic<unsigned int> count;  //!< calls in the current window
+
+    boost::mutex mutex;                 //!< guards the members below
+    boost::uint64_t start;              //!< start of the current window
+    map<string, unsigned int> seen;     //!< messages written and copies not written
+
+    bool Restart();
+    void Summarize(unsigned int calls, boost::uint64_t now,
+                   list<string>& summaries);
+    void Write(const list<string>& summaries);
+};
+
+} //NS Logging
+} //NS OpenEngine
+
+#endif // _LOG_LIMITER_H_
@@ -10,11 +10,25 @@
 #include <Logging/Logger.h>
 #include <Logging/ILogger.h>
 
+#include <ctime>
+#include <boost/thread/thread.hpp>
+
 namespace OpenEngine {
 namespace Logging {
 
+struct Logger::Message {
+    LoggerType type;
+    string msg;
+    time_t time;
+    Message* next;
+};
+
 // initialization of static members
-list<ILogger*> Logger::loggerList;
+list<Logger::Sink> Logger::loggerList;
+int Logger::threshold = Info;
+boost::atomic<int> Logger::minimum(INT_MAX);
+boost::atomic<Logger::Message*> Logger::pending(NULL);
+boost::atomic<bool> Logger::writing(false);
 
 Logger::Logger() : info(Info), warning(Warning), error(Error), end() {}
  
@@ -22,9 +36,13 @@ Logger::Logger() : info(Info), warning(Warning), error(Error), end() {}
  * Add a new logger instance to list of active loggers.
  *
  * @param logger Logger to add.
+ * @param level Lowest logger type the logger should receive.
  */
-void Logger::AddLogger(ILogger* logger){
-    loggerList.push_back(logger);
+void Logger::AddLogger(ILogger* logger, LoggerType level){
+    Lock();
+    loggerList.push_back(Sink(logger, level));
+    UpdateMinimum();
+    Unlock();
 }
 
 /**
@@ -33,20 +51,128 @@ void Logger::AddLogger(ILogger* logger){
  * @param logger Logger to remove.
  */
 void Logger::RemoveLogger(ILogger* logger){
-    loggerList.remove(logger);
+    Lock();
+    // messages logged before the removal still reach the logger
+    WritePending();
+    list<Sink>::iterator itr = loggerList.begin();
+    while (itr != loggerList.end()) {
+        if (itr->logger == logger) itr = loggerList.erase(itr);
+        else itr++;
+    }
+    UpdateMinimum();
+    Unlock();
+}
+
+/**
+ * Set the runtime log level.
+ * Messages below the level are neither formatted nor written.
+ *
+ * @param level Lowest logger type to write.
+ */
+void Logger::SetLevel(LoggerType level){
+    Lock();
+    threshold = level;
+    UpdateMinimum();
+    Unlock();
+}
+
+/**
+ * Get the runtime log level.
+ *
+ * @return Lowest logger type to write.
+ */
+LoggerType Logger::GetLevel(){
+    return (LoggerType)threshold;
+}
+
+/**
+ * Recompute the lowest level any logger will write.
+ * With no loggers nothing is enabled. Must hold the lock.
+ */
+void Logger::UpdateMinimum(){
+    int lowest = INT_MAX;
+    list<Sink>::const_iterator itr;
+    for (itr = loggerList.begin(); itr != loggerList.end(); itr++)
+        if (itr->level < lowest) lowest = itr->level;
+    minimum = (lowest > threshold) ? lowest : threshold;
+}
+
+/**
+ * Take exclusive ownership of the loggers.
+ * Only used when changing the logger list, so spinning is fine.
+ */
+void Logger::Lock(){
+    while (writing.exchange(true, boost::memory_order_acquire))
+        boost::this_thread::yield();
+}
+
+/**
+ * Release the loggers and write any messages handed off while they
+ * were owned.
+ */
+void Logger::Unlock(){
+    writing.store(false);
+    Drain();
+}
+
+/**
+ * Write all pending messages to the loggers accepting them.
+ * Must hold the lock.
+ */
+void Logger::WritePending(){
+    Message* msg = pending.exchange(NULL, boost::memory_order_acquire);
+    // the list is pushed in reverse, restore the logging order
+    Message* ordered = NULL;
+    while (msg != NULL) {
+        Message* next = msg->next;
+        msg->next = ordered;
+        ordered = msg;
+        msg = next;
+    }
+    while (ordered != NULL) {
+        list<Sink>::const_iterator itr = loggerList.begin();
+        while( itr != loggerList.end() ){
+            if (ordered->type >= itr->level)
+                itr->logger->Write(ordered->type, ordered->msg, ordered->time);
+            itr++;
+        }
+        Message* next = ordered->next;
+        delete ordered;
+        ordered = next;
+    }
 }
 
 /**
  * Write a message to the log.
+ * Only loggers accepting the type receive the message. The message
+ * is handed off without blocking; if another thread is writing to
+ * the loggers that thread writes the message.
  *
  * @param type Logging type.
  * @param str Message to log.
  */
 void Logger::WriteToLog(LoggerType type, string msg){
-    list<ILogger*>::const_iterator itr = loggerList.begin();
-    while( itr != loggerList.end() ){
-        (*itr)->Write(type, msg);
-        itr++;
+    Message* m = new Message();
+    m->type = type;
+    m->msg.swap(msg);
+    time(&m->time);
+    m->next = pending.load(boost::memory_order_relaxed);
+    while (!pending.compare_exchange_weak(m->next, m));
+    Drain();
+}
+
+/**
+ * Write pending messages unless another thread is already writing.
+ */
+void Logger::Drain(){
+    // The pending list is rechecked after giving up ownership, so a
+    // message pushed while another thread was writing is never left
+    // behind: either this thread sees the writer gone or the writer
+    // sees the message. Both sides use sequentially consistent order.
+    while (pending.load() != NULL) {
+        if (writing.exchange(true)) return;
+        WritePending();
+        writing.store(false);
     }
 }
 
@@ -57,25 +183,36 @@ void Logger::WriteToLog(LoggerType type, string msg){
  */
 Logger::LoggerTypeObj& Logger::LoggerTypeObj::operator<<(LogEnd e){
     if(logger.end==e){
-        Logger::WriteToLog(type, buffer.str());
-        buffer.flush();
-        buffer.str("");
-        buffer.clear();
+        // rate limited statements pass their limiter before the text
+        LogLimiter* limiter = site.release();
+        if (buffer.get() == NULL) return *this;
+        string msg = buffer->str();
+        buffer->str("");
+        buffer->clear();
+        if (IsEnabled(type) && (limiter == NULL || limiter->Filter(msg)))
+            Logger::WriteToLog(type, msg);
     }
     return *this;
 }
 
 /**
  * Deinitialize the logger.
+ * Pending messages and the summaries of rate limited statements are
+ * written before the loggers are deleted.
  */
 void Logger::Deinitialize() {
-    list<ILogger*>::const_iterator itr = loggerList.begin();
+    LogLimiter::FlushAll();
+    Lock();
+    WritePending();
+    list<Sink>::const_iterator itr = loggerList.begin();
     while (itr != loggerList.end()) {
-        ILogger* logger = (*itr);
+        ILogger* logger = itr->logger;
         delete logger;
         itr++;
     }
     loggerList.clear();
+    UpdateMinimum();
+    Unlock();
 }
 
 } //NS Logging
@@ -14,8 +14,22 @@
 #include <sstream>
 #include <iostream>
 #include <list>
+#include <climits>
 #include <Logging/LoggerType.h>
 
+#include <boost/atomic.hpp>
+#include <boost/thread/tss.hpp>
+
+/**
+ * Compile-time log level.
+ * Log statements written with the OE_LOG_* macros below this level
+ * are removed by the compiler. Set it with -DOE_LOG_LEVEL=10 to
+ * compile out info messages, 20 to keep only errors.
+ */
+#ifndef OE_LOG_LEVEL
+#define OE_LOG_LEVEL 0
+#endif
+
 namespace OpenEngine {
 namespace Logging {
 
@@ -23,15 +37,43 @@ using namespace std;
 
 //forward declarations
 class ILogger;
+class LogLimiter;
 
 /**
  * Log facility.
  *
+ * The log is safe to use from any thread. Each thread formats its
+ * messages in its own buffer, so messages from different threads are
+ * never interleaved. A completed message is handed to the loggers by
+ * pushing it on a lock-free list. The thread that pushes it writes
+ * all pending messages if no other thread is writing, otherwise it
+ * returns immediately and the writing thread picks up the message.
+ * Loggers are therefore never written to concurrently and messages
+ * keep the time they were logged.
+ *
  * @class Logger Logger.h Logging/Logger.h
  */
 class Logger {
 private:
-    static list<ILogger*> loggerList;
+    //! A logger and the lowest level it accepts.
+    struct Sink {
+        ILogger* logger;
+        LoggerType level;
+        Sink(ILogger* logger, LoggerType level)
+            : logger(logger), level(level) {}
+    };
+    //! A completed message waiting to be written.
+    struct Message;
+    static list<Sink> loggerList;       //!< guarded by writing
+    static int threshold;               //!< runtime level
+    static boost::atomic<int> minimum;  //!< lowest level any logger will write
+    static boost::atomic<Message*> pending; //!< messages in reverse order
+    static boost::atomic<bool> writing;     //!< a thread owns the loggers
+    static void UpdateMinimum();
+    static void Lock();
+    static void Unlock();
+    static void WritePending();
+    static void Drain();
 
     class LogEnd {
     public:
@@ -41,36 +83,47 @@ private:
     };
     class LoggerTypeObj {
     private:
-        ostringstream buffer;
+        boost::thread_specific_ptr<ostringstream> buffer; //!< per thread
+        boost::thread_specific_ptr<LogLimiter> site;      //!< per thread, not owned
         LoggerType type;
         LoggerTypeObj(){}
+        static void KeepSite(LogLimiter*) {}
+        ostringstream& Buffer() {
+            if (buffer.get() == NULL) buffer.reset(new ostringstream());
+            return *buffer;
+        }
     public:
-        LoggerTypeObj(LoggerType t) : type(t) {}
+        LoggerTypeObj(LoggerType t) : site(&KeepSite), type(t) {}
         LoggerTypeObj& operator<<(LogEnd);
+        LoggerTypeObj& operator<<(LogLimiter& limiter) {
+            site.reset(&limiter);
+            return *this;
+        }
         template <class T>
         LoggerTypeObj& operator<<(T input) {
-            buffer << input;
+            if (IsEnabled(type)) Buffer() << input;
             return *this;
         }
         LoggerTypeObj& operator<<(int input) {
-            buffer << input;
+            if (IsEnabled(type)) Buffer() << input;
             return *this;
         }
         LoggerTypeObj& operator<<(float input) {
-            buffer << input;
+            if (IsEnabled(type)) Buffer() << input;
             return *this;
         }
         LoggerTypeObj& operator<<(char input) {
-            buffer << input;
+            if (IsEnabled(type)) Buffer() << input;
             return *this;
         }
         LoggerTypeObj& operator<<(char* input) {
-            buffer << input;
+            if (IsEnabled(type)) Buffer() << input;
             return *this;
         }
         ~LoggerTypeObj(){}
     };
     static void WriteToLog(LoggerType type, string str);
+    friend class LogLimiter;
 public:
 
     LoggerTypeObj info;         //!< Info log.
@@ -78,15 +131,75 @@ public:
     LoggerTypeObj error;        //!< Error log.
     LogEnd end;                 //!< Log-message-end type
 
-    static void AddLogger(ILogger* logger);
+    static void AddLogger(ILogger* logger, LoggerType level = Info);
     static void RemoveLogger(ILogger* logger);
     static void Deinitialize();
+    static void SetLevel(LoggerType level);
+    static LoggerType GetLevel();
+
+    /**
+     * Check if messages of a given type will be written.
+     * A type is enabled if it is at or above both the compile-time
+     * level (OE_LOG_LEVEL) and the runtime level (SetLevel) and at
+     * least one logger accepts it.
+     *
+     * @param type Logger type to check.
+     * @return True if a message of the type would be written.
+     */
+    static bool IsEnabled(LoggerType type) {
+        return type >= OE_LOG_LEVEL
+            && type >= minimum.load(boost::memory_order_relaxed);
+    }
+
     Logger();
 };
 
 } //NS Logging
 } //NS OpenEngine
 
+#include <Logging/LogLimiter.h>
+
 static OpenEngine::Logging::Logger logger;
 
+/**
+ * Conditional log statements.
+ * Used in place of logger.info, logger.warning and logger.error. If
+ * the level is disabled the rest of the statement, including its
+ * arguments, is not evaluated:
+ * @code
+ * OE_LOG_INFO << "Expensive: " << Describe(node) << logger.end;
+ * @endcode
+ * The macros expand to a single if-else statement so they are safe
+ * to use as the body of an unbraced if.
+ */
+#define OE_LOG_IF(obj, type)                                    \
+    if (!OpenEngine::Logging::Logger::IsEnabled(type)) ; else logger.obj
+#define OE_LOG_INFO    OE_LOG_IF(info,    OpenEngine::Logging::Info)
+#define OE_LOG_WARNING OE_LOG_IF(warning, OpenEngine::Logging::Warning)
+#define OE_LOG_ERROR   OE_LOG_IF(error,   OpenEngine::Logging::Error)
+
+/**
+ * Rate limited log statements.
+ * Like the OE_LOG_* macros, but each statement logs at most \a burst
+ * messages per \a window seconds and drops messages already logged in
+ * the window. A summary of what was held back is logged when the
+ * window ends (see LogLimiter):
+ * @code
+ * OE_LOG_WARNING_LIMITED << "Plugin for ." << ext << " not found." << logger.end;
+ * @endcode
+ * The _LIMITED macros allow 10 messages per 5 seconds. The macros
+ * expand to a single statement holding a static limiter per call
+ * site, so they are safe to use as the body of an unbraced if.
+ */
+#define OE_LOG_LIMITED(obj, type, burst, window)                        \
+    for (bool oe_log_once = true; oe_log_once; oe_log_once = false)      \
+    for (static OpenEngine::Logging::LogLimiter oe_log_site              \
+             (type, __FILE__, __LINE__, burst, window);                 \
+         oe_log_once; oe_log_once = false)                              \
+    if (!OpenEngine::Logging::Logger::IsEnabled(type) ||                \
+        !oe_log_site.Allow()) ; else logger.obj << oe_log_site
+#define OE_LOG_INFO_LIMITED    OE_LOG_LIMITED(info,    OpenEngine::Logging::Info,    10, 5)
+#define OE_LOG_WARNING_LIMITED OE_LOG_LIMITED(warning, OpenEngine::Logging::Warning, 10, 5)
+#define OE_LOG_ERROR_LIMITED   OE_LOG_LIMITED(error,   OpenEngine::Logging::Error,   10, 5)
+
 #endif // _LOG_H_
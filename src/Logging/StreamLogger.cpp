@@ -43,6 +43,17 @@ StreamLogger::~StreamLogger(){
  */
 void StreamLogger::Write(LoggerType type, string msg) {
     time_t t; time(&t); // get the current time
+    Write(type, msg, t);
+}
+
+/**
+ * Write a log message stamped with the time it was logged.
+ *
+ * @param type Log message type.
+ * @param msg Message to log.
+ * @param t Time the message was logged.
+ */
+void StreamLogger::Write(LoggerType type, string msg, time_t t) {
     char buf[20]; memset (buf, '0', 20); // this terminates the string
 	strftime (buf, sizeof(buf), "%Y/%m/%d %H:%M:%S", localtime(&t));
     *stream << TypeToString(type) << " ";
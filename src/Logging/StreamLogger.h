@@ -34,6 +34,7 @@ public:
     StreamLogger(ostream* stream);
     virtual ~StreamLogger();
     void Write(LoggerType, string);
+    void Write(LoggerType, string, time_t);
     std::string TypeToString(LoggerType);
 };
 
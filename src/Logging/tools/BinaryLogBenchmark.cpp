@@ -0,0 +1,69 @@
+// Binary log benchmark.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+// Measures the records per second the BinaryLogger takes from one
+// and more threads logging at once. The log is written to a stream
+// that only counts the bytes, so the disk is not measured.
+//
+// Usage: BinaryLogBenchmark [records per thread]
+
+#include <Logging/BinaryLogger.h>
+
+#include <iostream>
+#include <streambuf>
+#include <cstdio>
+#include <cstdlib>
+#include <boost/thread/thread.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+using namespace std;
+using namespace OpenEngine::Logging;
+
+// stream buffer throwing away what is written
+class NullBuffer : public streambuf {
+public:
+    unsigned long bytes;
+    NullBuffer() : bytes(0) {}
+protected:
+    streamsize xsputn(const char* s, streamsize n) { bytes += n; return n; }
+    int overflow(int c) { bytes++; return c; }
+};
+
+struct Writer {
+    BinaryLogger* logger;
+    unsigned int format;
+    unsigned int records;
+    void operator()() {
+        for (unsigned int i=0; i<records; i++)
+            BinaryLogger::Record(logger, Info, format) << i << 0.5f * i;
+    }
+};
+
+int main(int argc, char** argv) {
+    unsigned int records = argc > 1 ? atoi(argv[1]) : 2000000;
+    unsigned int format = BinaryLogger::RegisterFormat("record %u at %f");
+    for (unsigned int threads=1; threads<=8; threads*=2) {
+        NullBuffer null;
+        BinaryLogger* logger = new BinaryLogger(new ostream(&null));
+        Writer w = { logger, format, records };
+        boost::posix_time::ptime start =
+            boost::posix_time::microsec_clock::universal_time();
+        boost::thread_group group;
+        for (unsigned int i=0; i<threads; i++)
+            group.create_thread(w);
+        group.join_all();
+        logger->Flush();
+        double s = (boost::posix_time::microsec_clock::universal_time() - start)
+            .total_microseconds() / 1e6;
+        printf("%u threads: %.1f M records/s, %.1f MB\n", threads,
+               threads * records / s / 1e6, null.bytes / 1e6);
+        delete logger;
+    }
+    return 0;
+}
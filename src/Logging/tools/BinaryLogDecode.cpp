@@ -0,0 +1,63 @@
+// Binary log decode tool.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+// --------------------------------------------------------------------
+
+// Renders a log written by BinaryLogger as text in the format of the
+// StreamLogger, with the time stamps in microseconds.
+//
+// Usage: BinaryLogDecode <log file> [output file]
+
+#include <Logging/BinaryLogDecoder.h>
+#include <Logging/StreamLogger.h>
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <ctime>
+
+using namespace std;
+using namespace OpenEngine::Logging;
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        cerr << "Usage: " << argv[0] << " <log file> [output file]" << endl;
+        return 1;
+    }
+    ifstream in(argv[1], ios::in | ios::binary);
+    if (!in.is_open()) {
+        cerr << "Could not open " << argv[1] << endl;
+        return 1;
+    }
+    ofstream file;
+    if (argc == 3) {
+        file.open(argv[2], ios::out);
+        if (!file.is_open()) {
+            cerr << "Could not open " << argv[2] << endl;
+            return 1;
+        }
+    }
+    ostream& out = (argc == 3) ? file : cout;
+
+    BinaryLogDecoder decoder(&in);
+    if (!decoder.IsValid()) {
+        cerr << argv[1] << " is not a binary log" << endl;
+        return 1;
+    }
+    StreamLogger types(NULL); // only used for the type names
+    BinaryLogDecoder::Entry e;
+    while (decoder.Next(e)) {
+        time_t t = e.time / 1000000;
+        char buf[20];
+        strftime(buf, sizeof(buf), "%Y/%m/%d %H:%M:%S", localtime(&t));
+        out << types.TypeToString(e.type) << " " << buf << "."
+            << setw(6) << setfill('0') << (e.time % 1000000) << ": "
+            << e.text << "\n";
+    }
+    out.flush();
+    return 0;
+}
@@ -74,8 +74,8 @@ public:
         }
     }
     void VisitVertexArrayNode(VertexArrayNode* node) {
-        list<VertexArray*> vaList = node->GetVertexArrays();
-        list<VertexArray*>::iterator itr;
+        const list<VertexArray*>& vaList = node->GetVertexArrays();
+        list<VertexArray*>::const_iterator itr;
         for (itr = vaList.begin(); itr!=vaList.end(); itr++) {
             // Load vertex array texture if not already loaded or in the cache
             ITextureResourcePtr t = (*itr)->mat->texr;
@@ -77,9 +77,9 @@ string DirectoryManager::FindFileInPath(string file) {
 		return *possibles.begin();
 	} else if (possibles.size() > 1) {
 		string s = *possibles.begin();
-		logger.warning << "Found more then one file matching the name given: " << file << logger.end;
+		OE_LOG_WARNING << "Found more then one file matching the name given: " << file << logger.end;
 		for (list<string>::iterator itr = possibles.begin(); itr != possibles.end(); itr++) {
-			logger.warning << (*itr) << logger.end;
+			OE_LOG_WARNING << (*itr) << logger.end;
 		}
 		pathcache[file] = s;
 		return s;
@@ -75,7 +75,7 @@ static void AddPlugin(IResourcePlugin<T>* plugin) {
     boost::shared_ptr<T> resource = (*plugin)->CreateResource(fullname);
     return resource;
   } else
-    logger.warning << "Plugin for ." << ext << " not found." << logger.end;
+    OE_LOG_WARNING_LIMITED << "Plugin for ." << ext << " not found." << logger.end;
 
   throw ResourceException("Unsupported file format: " + filename);
 }
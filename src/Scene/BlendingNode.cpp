@@ -8,11 +8,13 @@
 //--------------------------------------------------------------------
 
 #include <Scene/BlendingNode.h>
+#include <Utils/Serialization.h>
+#include <Scene/SceneChangeLog.h>
 
 namespace OpenEngine {
 namespace Scene {
 
-BlendingNode::BlendingNode() {    
+BlendingNode::BlendingNode() : ISceneNode(TAG) {    
     source = SRC_ALPHA;
     destination = ONE_MINUS_SRC_ALPHA;
     equation = ADD;
@@ -24,6 +26,7 @@ BlendingNode::BlendingFactor BlendingNode::GetSource() {
 
 void BlendingNode::SetSource(BlendingFactor source) {
     this->source = source;
+    RecordChange(SceneChange(SceneChange::RENDER_STATE_CHANGED, this));
 }
 
 BlendingNode::BlendingFactor BlendingNode::GetDestination() {
@@ -32,6 +35,7 @@ BlendingNode::BlendingFactor BlendingNode::GetDestination() {
 
 void BlendingNode::SetDestination(BlendingFactor destination) {
     this->destination = destination;
+    RecordChange(SceneChange(SceneChange::RENDER_STATE_CHANGED, this));
 }
 
 BlendingNode::BlendingEquation BlendingNode::GetEquation() {
@@ -40,7 +44,10 @@ BlendingNode::BlendingEquation BlendingNode::GetEquation() {
 
 void BlendingNode::SetEquation(BlendingEquation equation) {
     this->equation = equation;
+    RecordChange(SceneChange(SceneChange::RENDER_STATE_CHANGED, this));
 }
 
 } // NS Scene
 } // NS OpenEngine
+
+BOOST_CLASS_EXPORT_IMPLEMENT(OpenEngine::Scene::BlendingNode)
@@ -64,6 +64,6 @@ private:
 } // NS Scene
 } // NS OpenEngine
 
-BOOST_CLASS_EXPORT(OpenEngine::Scene::BlendingNode)
+BOOST_CLASS_EXPORT_KEY(OpenEngine::Scene::BlendingNode)
 
 #endif // _OE_BLENDING_NODE_H_
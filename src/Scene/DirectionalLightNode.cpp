@@ -8,6 +8,7 @@
 //--------------------------------------------------------------------
 
 #include <Scene/DirectionalLightNode.h>
+#include <Utils/Serialization.h>
 
 namespace OpenEngine {
 namespace Scene {
@@ -20,7 +21,7 @@ namespace Scene {
  */
 
 DirectionalLightNode::DirectionalLightNode()
-    : LightNode()
+    : LightNode(TAG)
 {
 
 }
@@ -31,3 +32,5 @@ DirectionalLightNode::~DirectionalLightNode() {
 
 } // NS Scene
 } // NS OpenEngine
+
+BOOST_CLASS_EXPORT_IMPLEMENT(OpenEngine::Scene::DirectionalLightNode)
@@ -41,6 +41,6 @@ private:
 } // NS Scene
 } // NS OpenEngine
 
-BOOST_CLASS_EXPORT(OpenEngine::Scene::DirectionalLightNode)
+BOOST_CLASS_EXPORT_KEY(OpenEngine::Scene::DirectionalLightNode)
 
 #endif // _DIRECTIONAL_LIGHT_NODE_H_
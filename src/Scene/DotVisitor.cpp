@@ -100,7 +100,7 @@ void DotVisitor::VisitNode(ISceneNode* node, map<string,string>& options) {
     dotdata << "]}";
     if (node->subNodes.size() > 0) {
         dotdata << " -> { ";
-        for (std::list<ISceneNode*>::iterator n = node->subNodes.begin(); 
+        for (std::vector<ISceneNode*>::iterator n = node->subNodes.begin(); 
              n != node->subNodes.end(); n++) {
             dotdata << GetId(*n) << "; ";
         }
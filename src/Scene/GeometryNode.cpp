@@ -8,6 +8,8 @@
 //--------------------------------------------------------------------
 
 #include <Scene/GeometryNode.h>
+#include <Utils/Serialization.h>
+#include <Scene/SceneChangeLog.h>
 #include <Math/Vector.h>
 #include <Math/Quaternion.h>
 #include <Utils/Convert.h>
@@ -23,7 +25,7 @@ using OpenEngine::Math::Quaternion;
  * Default constructor.
  * Creates an initial empty face set.
  */
-GeometryNode::GeometryNode() {
+GeometryNode::GeometryNode() : ISceneNode(TAG) {
     faces = new FaceSet();
 }
 
@@ -47,7 +49,7 @@ GeometryNode::GeometryNode(const GeometryNode& node)
  * @param faces Content of this Geometry Node.
  */
 GeometryNode::GeometryNode(FaceSet* faces)
-    : faces(faces) {
+    : ISceneNode(TAG), faces(faces) {
     
 }
 
@@ -79,6 +81,7 @@ FaceSet* GeometryNode::GetFaceSet() {
 void GeometryNode::SetFaceSet(FaceSet* faces){
     delete this->faces;
     this->faces = faces;
+    RecordChange(SceneChange(SceneChange::GEOMETRY_CHANGED, this));
 }
 
 const std::string GeometryNode::ToString() const {
@@ -89,3 +92,5 @@ const std::string GeometryNode::ToString() const {
 
 } //NS Scene
 } //NS OpenEngine
+
+BOOST_CLASS_EXPORT_IMPLEMENT(OpenEngine::Scene::GeometryNode)
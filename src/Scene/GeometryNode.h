@@ -55,6 +55,6 @@ private:
 } // NS Scene
 } // NS OpenEngine
 
-BOOST_CLASS_EXPORT(OpenEngine::Scene::GeometryNode)
+BOOST_CLASS_EXPORT_KEY(OpenEngine::Scene::GeometryNode)
 
 #endif // _OE_GEOMETRY_NODE_H_
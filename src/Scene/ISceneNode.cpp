@@ -8,28 +8,54 @@
 //--------------------------------------------------------------------
 
 #include <Scene/ISceneNode.h>
+#include <Utils/Serialization.h>
 #include <Scene/Exceptions.h>
+#include <Scene/SceneChangeLog.h>
 
 namespace OpenEngine {
 namespace Scene {
 
 using std::list;
+using std::vector;
 
 ISceneNode::ISceneNode()
     : parent(NULL)
+    , index(0)
+    , tag(NUM_NODE_TAGS)
+    , changeLog(NULL)
+    , activeLog(NULL)
+    , acceptStack(0) {
+    
+}
+
+/**
+ * Constructor for the node types in SceneNodes.def.
+ *
+ * @param tag Type tag of the node, its \a TAG.
+ */
+ISceneNode::ISceneNode(NodeTag tag)
+    : parent(NULL)
+    , index(0)
+    , tag(tag)
+    , changeLog(NULL)
+    , activeLog(NULL)
     , acceptStack(0) {
     
 }
 
 ISceneNode::ISceneNode(const ISceneNode& node)
     : parent(NULL)
+    , index(0)
+    , tag(node.tag)
+    , changeLog(NULL)
+    , activeLog(NULL)
     , acceptStack(0)
 {
 
 }
 
 ISceneNode::~ISceneNode() {
-    list<ISceneNode*>::iterator itr;
+    vector<ISceneNode*>::iterator itr;
     for (itr = subNodes.begin(); itr != subNodes.end(); itr++)
         delete *itr;
     subNodes.clear();
@@ -39,6 +65,35 @@ ISceneNode* ISceneNode::GetParent() {
     return parent;
 }
 
+void ISceneNode::SetChangeLog(SceneChangeLog* log) {
+    changeLog = log;
+    InheritChangeLog(parent ? parent->activeLog : NULL);
+}
+
+SceneChangeLog* ISceneNode::GetChangeLog() {
+    return changeLog;
+}
+
+/**
+ * Record a change in the log of this node or the nearest node above.
+ * Nothing is recorded if no such node has a log.
+ *
+ * @param change Change of this node or one of its sub nodes.
+ */
+void ISceneNode::RecordChange(const SceneChange& change) {
+    if (activeLog != NULL) activeLog->Record(change);
+}
+
+//! pass the log of the parent down to the nodes without their own
+void ISceneNode::InheritChangeLog(SceneChangeLog* log) {
+    if (changeLog != NULL) log = changeLog;
+    // the nodes below already agree with this one
+    if (log == activeLog) return;
+    activeLog = log;
+    for (unsigned int i=0; i<subNodes.size(); i++)
+        subNodes[i]->InheritChangeLog(log);
+}
+
 int ISceneNode::GetNumberOfNodes() {
     return subNodes.size();
 }
@@ -98,9 +153,9 @@ void ISceneNode::DecAcceptStack() {
  * @param visitor Visitor to traverse with.
  */
 void ISceneNode::VisitSubNodes(ISceneNodeVisitor& visitor) {
-    list<ISceneNode*>::iterator itr;
-    for (itr = subNodes.begin(); itr != subNodes.end(); itr++)
-        (*itr)->Accept(visitor);
+    // by index, as nodes added during traversal may move the array
+    for (unsigned int i=0; i<subNodes.size(); i++)
+        subNodes[i]->Accept(visitor);
 }
 
 void ISceneNode::AddNode(ISceneNode* sub) {
@@ -108,8 +163,11 @@ void ISceneNode::AddNode(ISceneNode* sub) {
         throw InvalidSceneOperation("A scene node may not have a NULL child.");
     if (sub->parent != NULL)
         throw InvalidSceneOperation("A scene node may not have multiple parents.");
+    sub->index = subNodes.size();
     subNodes.push_back(sub);
     sub->parent = this;
+    sub->InheritChangeLog(activeLog);
+    RecordChange(SceneChange(SceneChange::NODE_ADDED, sub, this));
 }
 
 void ISceneNode::RemoveNode(ISceneNode* sub) {
@@ -122,8 +180,10 @@ void ISceneNode::RemoveNode(ISceneNode* sub) {
 
 //! non-delayed removal of a node
 void ISceneNode::_RemoveNode(ISceneNode* sub) {
-    subNodes.remove(sub);
+    if (!Detach(sub)) return;
     sub->parent = NULL;
+    sub->InheritChangeLog(NULL);
+    RecordChange(SceneChange(SceneChange::NODE_REMOVED, sub, this));
 }
 
 void ISceneNode::DeleteNode(ISceneNode* sub) {
@@ -136,50 +196,82 @@ void ISceneNode::DeleteNode(ISceneNode* sub) {
 
 //! non-delayed deletion of a node
 void ISceneNode::_DeleteNode(ISceneNode* sub) {
-    subNodes.remove(sub);
+    if (Detach(sub))
+        RecordChange(SceneChange(SceneChange::NODE_DELETED, sub, this));
     delete sub;
 }
 
+//! take a node out of the sub nodes, moving the last one into its place
+bool ISceneNode::Detach(ISceneNode* sub) {
+    if (sub->parent != this) return false;
+    unsigned int i = sub->index;
+    // the cached index is only stale if the list was changed directly
+    if (i >= subNodes.size() || subNodes[i] != sub) {
+        for (i = 0; i < subNodes.size() && subNodes[i] != sub; i++);
+        if (i == subNodes.size()) return false;
+    }
+    ISceneNode* last = subNodes.back();
+    subNodes[i] = last;
+    last->index = i;
+    subNodes.pop_back();
+    return true;
+}
+
 void ISceneNode::ReplaceNode(ISceneNode* oldNode, ISceneNode* newNode) {
     if (newNode == NULL)
         throw InvalidSceneOperation("Scene nodes may not have NULL children.");
     if (newNode->parent != NULL)
         throw InvalidSceneOperation("Scene nodes may not have multiple parents.");
-    list<ISceneNode*>::iterator itr;
-    for (itr = subNodes.begin(); itr != subNodes.end(); itr++) {
-        if (*itr == oldNode) {
-            newNode->parent = this;
-            *itr = newNode;
-            if (acceptStack)
-                operationQueue.push_back(QueuedNode(DELETE_OP, oldNode));
-            else _DeleteNode(oldNode);
-            return;
-        }
+    unsigned int i = oldNode->index;
+    if (oldNode->parent != this || i >= subNodes.size() || subNodes[i] != oldNode) {
+        for (i = 0; i < subNodes.size() && subNodes[i] != oldNode; i++);
+        if (i == subNodes.size()) return;
     }
+    newNode->parent = this;
+    newNode->index = i;
+    subNodes[i] = newNode;
+    newNode->InheritChangeLog(activeLog);
+    // the old node is no longer a sub node, so it is only deleted
+    oldNode->parent = NULL;
+    oldNode->InheritChangeLog(NULL);
+    RecordChange(SceneChange(SceneChange::NODE_REPLACED, oldNode, this, newNode));
+    if (acceptStack)
+        operationQueue.push_back(QueuedNode(DELETE_OP, oldNode));
+    else delete oldNode;
 }
 
 void ISceneNode::RemoveAllNodes() {
-    // invariant - node is the last seen node in the list but never
-    // the node contained by the current iterator.
-    ISceneNode* node = NULL;
-    list<ISceneNode*>::iterator itr;
-    for (itr = subNodes.begin(); itr != subNodes.end(); itr++) {
-        if (node) RemoveNode(node);
-        node = *itr;
+    // queued removals do not change the sub nodes
+    if (acceptStack) {
+        for (unsigned int i=0; i<subNodes.size(); i++)
+            RemoveNode(subNodes[i]);
+        return;
+    }
+    vector<ISceneNode*> nodes;
+    nodes.swap(subNodes);
+    for (unsigned int i=0; i<nodes.size(); i++) {
+        nodes[i]->parent = NULL;
+        nodes[i]->InheritChangeLog(NULL);
+        RecordChange(SceneChange(SceneChange::NODE_REMOVED, nodes[i], this));
     }
-    if (node) RemoveNode(node);
 }
 
 void ISceneNode::DeleteAllNodes() {
     // same as for RemoveAllNodes
-    ISceneNode* node = NULL;
-    list<ISceneNode*>::iterator itr;
-    for (itr = subNodes.begin(); itr != subNodes.end(); itr++) {
-        if (node) DeleteNode(node);
-        node = *itr;
+    if (acceptStack) {
+        for (unsigned int i=0; i<subNodes.size(); i++)
+            DeleteNode(subNodes[i]);
+        return;
+    }
+    vector<ISceneNode*> nodes;
+    nodes.swap(subNodes);
+    for (unsigned int i=0; i<nodes.size(); i++) {
+        RecordChange(SceneChange(SceneChange::NODE_DELETED, nodes[i], this));
+        delete nodes[i];
     }
-    if (node) DeleteNode(node);
 }
 
 } // NS Scene
 } // NS OpenEngine
+
+BOOST_CLASS_EXPORT_IMPLEMENT(OpenEngine::Scene::ISceneNode)
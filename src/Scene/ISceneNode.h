@@ -11,9 +11,11 @@
 #define _OE_INTERFACE_SCENE_NODE_H_
 
 #include <list>
+#include <vector>
+#include <cstddef>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/utility.hpp>
-#include <boost/serialization/list.hpp>
+#include <boost/serialization/vector.hpp>
 #include <boost/serialization/export.hpp>
 
 #define OE_SCENE_NODE(klass, syper)                     \
@@ -21,6 +23,10 @@ public:                                                 \
 virtual void Accept(ISceneNodeVisitor& v);              \
 virtual ISceneNode* Clone() const;                      \
 virtual const std::string GetClassName() const;         \
+virtual NodeTag GetNodeTag() const;                     \
+static const NodeTag TAG = klass##Tag;                  \
+static void* operator new(std::size_t size);            \
+static void operator delete(void* p, std::size_t size); \
 protected:
 
 
@@ -29,6 +35,23 @@ namespace Scene {
 
 // forward declaration
 class ISceneNodeVisitor;
+class TableVisitor;
+class SceneChangeLog;
+struct SceneChange;
+
+/**
+ * Scene node type tags.
+ * One tag for each node type in SceneNodes.def, named after the type
+ * with a Tag suffix. Every node type also has its tag as \a TAG.
+ *
+ * @see TableVisitor
+ */
+enum NodeTag {
+#define SCENE_NODE(type) type##Tag,
+#include "SceneNodes.def"
+#undef SCENE_NODE
+    NUM_NODE_TAGS
+};
 
 /**
  * Scene node interface.
@@ -45,13 +68,14 @@ class ISceneNodeVisitor;
  */
 class ISceneNode {
 public:
-    //! List of sub nodes @todo Should be private
-    std::list<ISceneNode*> subNodes;
+    //! Sub nodes, modify through the node methods only @todo Should be private
+    std::vector<ISceneNode*> subNodes;
 
     /**
      * Default constructor.
      */      
     ISceneNode();
+    explicit ISceneNode(NodeTag tag);
     ISceneNode(const ISceneNode& node);
 
     /**
@@ -64,6 +88,22 @@ public:
      */
     virtual ISceneNode* GetParent();
 
+    /**
+     * Set the log recording the changes to this node and all nodes
+     * below it, usually on the scene root.
+     *
+     * @param log Change log, NULL to stop recording.
+     * @see SceneChangeLog
+     */
+    void SetChangeLog(SceneChangeLog* log);
+
+    /**
+     * Get the change log set on this node.
+     *
+     * @return Change log or NULL.
+     */
+    SceneChangeLog* GetChangeLog();
+
     /**
      * Add a sub node.
      *
@@ -73,6 +113,9 @@ public:
 
     /**
      * Remove a sub node.
+     * The last sub node takes the place of the removed one, so
+     * removal takes constant time but may change the order of the
+     * remaining sub nodes.
      *
      * @param sub Sub node
      */
@@ -167,6 +210,15 @@ public:
      */
     virtual const std::string GetClassName() const = 0;
 
+    /**
+     * Get the type tag of a node.
+     * Sub classes outside SceneNodes.def have the tag of the node
+     * type they derive from.
+     *
+     * @return Node type tag
+     */
+    virtual NodeTag GetNodeTag() const = 0;
+
     /**
      * Accept a visitor.
      * To perform the visitor operation one must call 
@@ -181,11 +233,26 @@ public:
      */
     virtual void Accept(ISceneNodeVisitor& visitor) = 0;
 
+protected:
+    void RecordChange(const SceneChange& change);
+
 private:
 
     //! The parent node
     ISceneNode* parent;
 
+    //! Position in the sub nodes of the parent.
+    unsigned int index;
+
+    //! Tag given by the node type, NUM_NODE_TAGS if none.
+    const NodeTag tag;
+
+    //! Log set on this node, if any.
+    SceneChangeLog* changeLog;
+
+    //! Log set on this node or the nearest node above, if any.
+    SceneChangeLog* activeLog;
+
     //! Queue operation types.
     enum QueueType { DELETE_OP, REMOVE_OP };
 
@@ -205,12 +272,15 @@ private:
 
     void _RemoveNode(ISceneNode* sub);
     void _DeleteNode(ISceneNode* sub);
+    bool Detach(ISceneNode* sub);
+    void InheritChangeLog(SceneChangeLog* log);
 
     // We currently need to have access to these methods in the definition of
     // accept in all sub type. Clients should however not use them!
 #define SCENE_NODE(klass) friend class klass;
 #include "SceneNodes.def"
 #undef SCENE_NODE
+    friend class TableVisitor;
     void IncAcceptStack();
     void DecAcceptStack();
 
@@ -218,6 +288,11 @@ private:
     template<class Archive>
     void serialize(Archive& ar, const unsigned int version) {
         ar & subNodes;
+        if (Archive::is_loading::value)
+            for (unsigned int i=0; i<subNodes.size(); i++) {
+                subNodes[i]->parent = this;
+                subNodes[i]->index = i;
+            }
     }
 };
 
@@ -225,6 +300,6 @@ private:
 } // NS OpenEngine
 
 // this could be done for all scene nodes with the SceneNodes.def
-BOOST_CLASS_EXPORT(OpenEngine::Scene::ISceneNode)
+BOOST_CLASS_EXPORT_KEY(OpenEngine::Scene::ISceneNode)
 
 #endif // _OE_INTERFACE_SCENE_NODE_H_
@@ -8,6 +8,7 @@
 //--------------------------------------------------------------------
 
 #include <Scene/LightNode.h>
+#include <Utils/Serialization.h>
 
 namespace OpenEngine {
 namespace Scene {
@@ -15,7 +16,22 @@ namespace Scene {
 using Math::Vector;
 
 LightNode::LightNode()
-    : ISceneNode()
+    : ISceneNode(TAG)
+    , active(true)
+    , ambient(Vector<4,float>(0.0,0.0,0.0,1.0))
+    , diffuse(Vector<4,float>(1.0,1.0,1.0,1.0))
+    , specular(Vector<4,float>(1.0,1.0,1.0,1.0))
+{
+
+}
+
+/**
+ * Constructor for the light types.
+ *
+ * @param tag Type tag of the light.
+ */
+LightNode::LightNode(NodeTag tag)
+    : ISceneNode(tag)
     , active(true)
     , ambient(Vector<4,float>(0.0,0.0,0.0,1.0))
     , diffuse(Vector<4,float>(1.0,1.0,1.0,1.0))
@@ -30,3 +46,5 @@ LightNode::~LightNode() {
 
 } // NS Scene
 } // NS OpenEngine
+
+BOOST_CLASS_EXPORT_IMPLEMENT(OpenEngine::Scene::LightNode)
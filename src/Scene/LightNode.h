@@ -30,6 +30,9 @@ public:
 
     LightNode();
     virtual ~LightNode();
+
+protected:
+    explicit LightNode(NodeTag tag);
         
 private:
     friend class boost::serialization::access;
@@ -48,6 +51,6 @@ private:
 } // NS Scene
 } // NS OpenEngine
 
-BOOST_CLASS_EXPORT(OpenEngine::Scene::LightNode)
+BOOST_CLASS_EXPORT_KEY(OpenEngine::Scene::LightNode)
 
 #endif // _OE_LIGHT_NODE_H_
@@ -0,0 +1,105 @@
+// Scene node pool.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/NodePool.h>
+
+#include <new>
+
+namespace OpenEngine {
+namespace Scene {
+
+// blocks are aligned for any member a node may have
+static const std::size_t ALIGNMENT = 16;
+
+// blocks in the first slab and the most in any slab; slabs double
+// in between so large graphs need few of them
+static const unsigned int MIN_SLAB = 64;
+static const unsigned int MAX_SLAB = 1 << 16;
+
+/**
+ * Create an empty pool.
+ *
+ * @param size Size of the blocks in bytes.
+ */
+NodePool::NodePool(std::size_t size)
+    : size(((size < sizeof(void*) ? sizeof(void*) : size) + ALIGNMENT - 1)
+           & ~(ALIGNMENT - 1))
+    , free(NULL)
+    , capacity(0)
+    , allocated(0) {}
+
+/**
+ * Destructor.
+ * Releases all slabs, including blocks still in use.
+ */
+NodePool::~NodePool() {
+    for (unsigned int i=0; i<slabs.size(); i++)
+        ::operator delete(slabs[i]);
+}
+
+/**
+ * Allocate a block.
+ *
+ * @return Uninitialized block of the pool size.
+ * @exception std::bad_alloc if the heap is exhausted.
+ */
+void* NodePool::Allocate() {
+    boost::mutex::scoped_lock lock(mutex);
+    if (free == NULL) Grow();
+    void* block = free;
+    free = *(void**)block;
+    allocated++;
+    return block;
+}
+
+/**
+ * Return a block to the pool.
+ *
+ * @param block Block allocated from this pool.
+ */
+void NodePool::Free(void* block) {
+    boost::mutex::scoped_lock lock(mutex);
+    *(void**)block = free;
+    free = block;
+    allocated--;
+}
+
+/**
+ * Get the number of blocks in use.
+ */
+unsigned int NodePool::GetNumAllocated() const {
+    boost::mutex::scoped_lock lock(mutex);
+    return allocated;
+}
+
+/**
+ * Get the number of blocks in all slabs.
+ */
+unsigned int NodePool::GetCapacity() const {
+    boost::mutex::scoped_lock lock(mutex);
+    return capacity;
+}
+
+// add a slab and thread its blocks onto the free list, in address
+// order so consecutive allocations are adjacent
+void NodePool::Grow() {
+    unsigned int count = capacity < MIN_SLAB ? MIN_SLAB
+        : (capacity > MAX_SLAB ? MAX_SLAB : capacity);
+    char* slab = (char*)::operator new(count * size);
+    slabs.push_back(slab);
+    for (unsigned int i=count; i>0; i--) {
+        void* block = slab + (i - 1) * size;
+        *(void**)block = free;
+        free = block;
+    }
+    capacity += count;
+}
+
+} // NS Scene
+} // NS OpenEngine
@@ -0,0 +1,59 @@
+// Scene node pool.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_NODE_POOL_H_
+#define _OE_NODE_POOL_H_
+
+#include <cstddef>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+namespace OpenEngine {
+namespace Scene {
+
+/**
+ * Scene node pool.
+ * Allocates blocks of one size from slabs holding many blocks, and
+ * keeps freed blocks in a free list for reuse. Every node type in
+ * \a SceneNodes.def allocates from a pool of its own through the
+ * operators declared by \a OE_SCENE_NODE, so nodes of a type lie
+ * close together and creating and deleting nodes rarely reaches the
+ * heap.
+ *
+ * Pools may be used from any thread. Slabs are only returned to the
+ * heap when the pool is destroyed.
+ *
+ * @class NodePool NodePool.h Scene/NodePool.h
+ */
+class NodePool {
+public:
+    NodePool(std::size_t size);
+    virtual ~NodePool();
+
+    void* Allocate();
+    void Free(void* block);
+
+    unsigned int GetNumAllocated() const;
+    unsigned int GetCapacity() const;
+
+private:
+    std::size_t size;           //!< block size, aligned
+    void* free;                 //!< free list, linked through the blocks
+    std::vector<char*> slabs;
+    unsigned int capacity;
+    unsigned int allocated;
+    mutable boost::mutex mutex;
+
+    void Grow();
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_NODE_POOL_H_
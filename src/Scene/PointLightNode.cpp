@@ -8,12 +8,14 @@
 //--------------------------------------------------------------------
 
 #include <Scene/PointLightNode.h>
+#include <Utils/Serialization.h>
 
 namespace OpenEngine {
 namespace Scene {
 
 PointLightNode::PointLightNode()
-  : constAtt(1.0)
+  : LightNode(TAG)
+  , constAtt(1.0)
   , linearAtt(0.0)
   , quadAtt(0.0)
 {
@@ -26,3 +28,5 @@ PointLightNode::~PointLightNode() {
 
 } // NS Scene
 } // NS OpenEngine
+
+BOOST_CLASS_EXPORT_IMPLEMENT(OpenEngine::Scene::PointLightNode)
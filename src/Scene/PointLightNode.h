@@ -46,6 +46,6 @@ private:
 } // NS Scene
 } // NS OpenEngine
 
-BOOST_CLASS_EXPORT(OpenEngine::Scene::PointLightNode)
+BOOST_CLASS_EXPORT_KEY(OpenEngine::Scene::PointLightNode)
 
 #endif // _OE_LIGHT_NODE_H_
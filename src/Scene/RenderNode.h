@@ -30,6 +30,8 @@ class RenderNode : public ISceneNode {
     OE_SCENE_NODE(RenderNode, ISceneNode)
 
 public:
+    RenderNode() : ISceneNode(TAG) {}
+
     /**
      * Apply the node, called by the renderer
      */
@@ -8,6 +8,8 @@
 //--------------------------------------------------------------------
 
 #include <Scene/RenderStateNode.h>
+#include <Utils/Serialization.h>
+#include <Scene/SceneChangeLog.h>
 
 namespace OpenEngine {
 namespace Scene {
@@ -18,7 +20,7 @@ namespace Scene {
  * RenderStateNodes.
  */
 RenderStateNode::RenderStateNode()
-    : ISceneNode()
+    : ISceneNode(TAG)
     , enabled(NONE)
     , disabled(NONE)
 {
@@ -93,6 +95,8 @@ void RenderStateNode::EnableOption(RenderStateOption options) {
     // add to enabled
     unsigned int optEn = enabled | (unsigned int)options;
     enabled = (RenderStateOption)optEn;
+
+    RecordChange(SceneChange(SceneChange::RENDER_STATE_CHANGED, this));
 }
 
 /**
@@ -110,6 +114,8 @@ void RenderStateNode::DisableOption(RenderStateOption options) {
     // add to disabled
     unsigned int optDis = disabled | (unsigned int)options;
     disabled = (RenderStateOption)optDis;
+
+    RecordChange(SceneChange(SceneChange::RENDER_STATE_CHANGED, this));
 }
 
 /**
@@ -187,3 +193,5 @@ const std::string RenderStateNode::ToString() const {
 
 } //NS Scene
 } //NS OpenEngine
+
+BOOST_CLASS_EXPORT_IMPLEMENT(OpenEngine::Scene::RenderStateNode)
@@ -83,6 +83,6 @@ private:
 } //NS Scene
 } //NS OpenEngine
 
-BOOST_CLASS_EXPORT(OpenEngine::Scene::RenderStateNode)
+BOOST_CLASS_EXPORT_KEY(OpenEngine::Scene::RenderStateNode)
 
 #endif // _OE_RENDER_STATE_NODE_H_
@@ -0,0 +1,78 @@
+// Scene change log.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/SceneChangeLog.h>
+
+namespace OpenEngine {
+namespace Scene {
+
+SceneChangeLog::SceneChangeLog() {}
+
+SceneChangeLog::~SceneChangeLog() {}
+
+/**
+ * Record a change for the current frame.
+ * Called by the scene nodes.
+ *
+ * @param change Scene change.
+ */
+void SceneChangeLog::Record(const SceneChange& change) {
+    // a node moved many times in a frame is only reported once
+    if (!pending.empty() && pending.back() == change) return;
+    pending.push_back(change);
+}
+
+/**
+ * Publish the changes recorded since the last flush.
+ * Changes made by the listeners are published on the next flush.
+ * Nothing is published if there are no changes.
+ *
+ * @return Number of changes published.
+ */
+unsigned int SceneChangeLog::Flush() {
+    publishing.swap(pending);
+    unsigned int count = publishing.size();
+    if (count > 0)
+        changesEvent.Notify(SceneChangesEventArg(publishing));
+    // keep the capacity for the next frame
+    publishing.clear();
+    return count;
+}
+
+/**
+ * Get the number of changes recorded and not yet published.
+ */
+unsigned int SceneChangeLog::GetNumPending() const {
+    return pending.size();
+}
+
+/**
+ * Event with the changes of each frame.
+ */
+IEvent<SceneChangesEventArg>& SceneChangeLog::ChangesEvent() {
+    return changesEvent;
+}
+
+void SceneChangeLog::Handle(InitializeEventArg arg) {
+    Flush();
+}
+
+/**
+ * Publish the changes of the frame.
+ */
+void SceneChangeLog::Handle(ProcessEventArg arg) {
+    Flush();
+}
+
+void SceneChangeLog::Handle(DeinitializeEventArg arg) {
+    Flush();
+}
+
+} // NS Scene
+} // NS OpenEngine
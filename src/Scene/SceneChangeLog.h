@@ -0,0 +1,127 @@
+// Scene change log.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_SCENE_CHANGE_LOG_H_
+#define _OE_SCENE_CHANGE_LOG_H_
+
+#include <Core/IModule.h>
+#include <Core/Event.h>
+
+#include <vector>
+
+namespace OpenEngine {
+namespace Scene {
+
+using OpenEngine::Core::InitializeEventArg;
+using OpenEngine::Core::ProcessEventArg;
+using OpenEngine::Core::DeinitializeEventArg;
+using OpenEngine::Core::IEvent;
+using OpenEngine::Core::Event;
+using std::vector;
+
+class ISceneNode;
+
+/**
+ * Scene change.
+ * One structural or content change of a scene node.
+ *
+ * Removed and deleted nodes take their sub nodes with them without
+ * further changes. Deleted and replaced nodes no longer exist when
+ * the change is published, so their pointers may only be used as
+ * keys.
+ *
+ * @struct SceneChange SceneChangeLog.h Scene/SceneChangeLog.h
+ */
+struct SceneChange {
+    enum Type {
+        NODE_ADDED,             //!< node added to parent
+        NODE_REMOVED,           //!< node removed from parent
+        NODE_DELETED,           //!< node removed from parent and deleted
+        NODE_REPLACED,          //!< node replaced by other and deleted
+        TRANSFORMATION_CHANGED, //!< transformation node moved, rotated or scaled
+        GEOMETRY_CHANGED,       //!< face set or vertex arrays changed
+        RENDER_STATE_CHANGED    //!< render state or blending changed
+    };
+    Type type;
+    ISceneNode* node;           //!< changed node
+    ISceneNode* parent;         //!< parent of a structural change, else NULL
+    ISceneNode* other;          //!< replacing node of NODE_REPLACED, else NULL
+    SceneChange(Type type, ISceneNode* node,
+                ISceneNode* parent = NULL, ISceneNode* other = NULL)
+        : type(type), node(node), parent(parent), other(other) {}
+    bool operator==(const SceneChange& c) const {
+        return type == c.type && node == c.node
+            && parent == c.parent && other == c.other;
+    }
+};
+
+/**
+ * Scene changes event argument.
+ * The changes of one frame in the order they happened.
+ *
+ * @struct SceneChangesEventArg SceneChangeLog.h Scene/SceneChangeLog.h
+ */
+struct SceneChangesEventArg {
+    const vector<SceneChange>& changes;
+    SceneChangesEventArg(const vector<SceneChange>& changes)
+        : changes(changes) {}
+};
+
+/**
+ * Scene change log.
+ * Collects the changes to a scene during a frame and publishes them
+ * in one batch at the frame boundary, so transformers, bounds caches
+ * and spatial indexes can update in the number of changes instead of
+ * traversing the scene again:
+ * @code
+ * SceneChangeLog* changes = new SceneChangeLog();
+ * root->SetChangeLog(changes);
+ * changes->ChangesEvent().Attach(spatialIndex);
+ * engine.ProcessEvent().Attach(*changes);  // after the command queue
+ * @endcode
+ *
+ * Nodes take the log over from their parent when attached and drop
+ * it when removed, so only changes to nodes attached to the root are
+ * recorded, and recording costs the same at any depth. Attaching or
+ * removing a subtree of a logged scene visits the nodes in it.
+ * Subtrees built apart from the scene, for instance by a loader
+ * thread, are recorded as one \a NODE_ADDED when attached. Changes
+ * repeating the previous change are recorded once.
+ *
+ * The log is not locked and must be changed from the thread
+ * traversing the scene, as with the scene itself.
+ *
+ * @class SceneChangeLog SceneChangeLog.h Scene/SceneChangeLog.h
+ * @see SceneCommandQueue
+ */
+class SceneChangeLog : public virtual Core::IModule {
+public:
+    SceneChangeLog();
+    virtual ~SceneChangeLog();
+
+    void Record(const SceneChange& change);
+    unsigned int Flush();
+
+    unsigned int GetNumPending() const;
+    IEvent<SceneChangesEventArg>& ChangesEvent();
+
+    void Handle(InitializeEventArg arg);
+    void Handle(ProcessEventArg arg);
+    void Handle(DeinitializeEventArg arg);
+
+private:
+    vector<SceneChange> pending;    //!< changes of the current frame
+    vector<SceneChange> publishing; //!< changes being published
+    Event<SceneChangesEventArg> changesEvent;
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_SCENE_CHANGE_LOG_H_
@@ -0,0 +1,343 @@
+// Scene command queue.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/SceneCommandQueue.h>
+#include <Scene/ISceneNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/GeometryNode.h>
+#include <Scene/Exceptions.h>
+#include <Logging/Logger.h>
+
+namespace OpenEngine {
+namespace Scene {
+
+SceneCommandQueue::Command::Command(CommandType type, ISceneNode* parent,
+                                    ISceneNode* node, ISceneNode* other)
+    : type(type), parent(parent), node(node), other(other), faces(NULL) {}
+
+/**
+ * Create an empty batch.
+ *
+ * @param queue Queue to submit to.
+ */
+SceneCommandQueue::Batch::Batch(SceneCommandQueue& queue)
+    : queue(queue) {}
+
+/**
+ * Destructor, submitting the remaining commands.
+ */
+SceneCommandQueue::Batch::~Batch() {
+    Submit();
+}
+
+/**
+ * Add a sub node.
+ *
+ * @param parent Node to add to.
+ * @param node Node to add.
+ * @exception InvalidSceneOperation if a node is NULL.
+ */
+void SceneCommandQueue::Batch::AddNode(ISceneNode* parent, ISceneNode* node) {
+    if (parent == NULL || node == NULL)
+        throw InvalidSceneOperation("Can not add NULL nodes.");
+    commands.push_back(Command(ADD_OP, parent, node));
+}
+
+/**
+ * Remove a sub node.
+ *
+ * @param parent Node to remove from.
+ * @param node Node to remove.
+ * @exception InvalidSceneOperation if a node is NULL.
+ */
+void SceneCommandQueue::Batch::RemoveNode(ISceneNode* parent, ISceneNode* node) {
+    if (parent == NULL || node == NULL)
+        throw InvalidSceneOperation("Can not remove NULL nodes.");
+    commands.push_back(Command(REMOVE_OP, parent, node));
+}
+
+/**
+ * Delete a sub node.
+ *
+ * @param parent Node to delete from.
+ * @param node Node to delete.
+ * @exception InvalidSceneOperation if a node is NULL.
+ */
+void SceneCommandQueue::Batch::DeleteNode(ISceneNode* parent, ISceneNode* node) {
+    if (parent == NULL || node == NULL)
+        throw InvalidSceneOperation("Can not delete NULL nodes.");
+    commands.push_back(Command(DELETE_OP, parent, node));
+}
+
+/**
+ * Replace a sub node, deleting the replaced node.
+ *
+ * @param parent Node holding the old node.
+ * @param oldNode Node to replace.
+ * @param newNode Node to replace it with.
+ * @exception InvalidSceneOperation if a node is NULL.
+ */
+void SceneCommandQueue::Batch::ReplaceNode(ISceneNode* parent, ISceneNode* oldNode,
+                                           ISceneNode* newNode) {
+    if (parent == NULL || oldNode == NULL || newNode == NULL)
+        throw InvalidSceneOperation("Can not replace NULL nodes.");
+    commands.push_back(Command(REPLACE_OP, parent, oldNode, newNode));
+}
+
+/**
+ * Set the position of a transformation node.
+ *
+ * @param node Transformation node.
+ * @param position New position.
+ * @exception InvalidSceneOperation if the node is NULL.
+ */
+void SceneCommandQueue::Batch::SetPosition(TransformationNode* node,
+                                           Vector<3,float> position) {
+    if (node == NULL)
+        throw InvalidSceneOperation("Can not transform NULL nodes.");
+    commands.push_back(Command(POSITION_OP, NULL, node));
+    commands.back().position = position;
+}
+
+/**
+ * Set the rotation of a transformation node.
+ *
+ * @param node Transformation node.
+ * @param rotation New rotation.
+ * @exception InvalidSceneOperation if the node is NULL.
+ */
+void SceneCommandQueue::Batch::SetRotation(TransformationNode* node,
+                                           Quaternion<float> rotation) {
+    if (node == NULL)
+        throw InvalidSceneOperation("Can not transform NULL nodes.");
+    commands.push_back(Command(ROTATION_OP, NULL, node));
+    commands.back().rotation = rotation;
+}
+
+/**
+ * Set the scale of a transformation node.
+ *
+ * @param node Transformation node.
+ * @param scale New scaling matrix.
+ * @exception InvalidSceneOperation if the node is NULL.
+ */
+void SceneCommandQueue::Batch::SetScale(TransformationNode* node,
+                                        Matrix<4,4,float> scale) {
+    if (node == NULL)
+        throw InvalidSceneOperation("Can not transform NULL nodes.");
+    commands.push_back(Command(SCALE_OP, NULL, node));
+    commands.back().scale = scale;
+}
+
+/**
+ * Swap the face set of a geometry node.
+ * As with \a GeometryNode::SetFaceSet the old face set is deleted.
+ *
+ * @param node Geometry node.
+ * @param faces New face set.
+ * @exception InvalidSceneOperation if the node is NULL.
+ */
+void SceneCommandQueue::Batch::SetFaceSet(GeometryNode* node,
+                                          Geometry::FaceSet* faces) {
+    if (node == NULL)
+        throw InvalidSceneOperation("Can not change NULL nodes.");
+    commands.push_back(Command(FACES_OP, NULL, node));
+    commands.back().faces = faces;
+}
+
+/**
+ * Get the number of commands not yet submitted.
+ */
+unsigned int SceneCommandQueue::Batch::GetSize() const {
+    return commands.size();
+}
+
+/**
+ * Submit the commands to the queue.
+ * The batch is empty afterwards and can be reused.
+ */
+void SceneCommandQueue::Batch::Submit() {
+    if (!commands.empty()) queue.Submit(commands);
+}
+
+/**
+ * Create an empty queue.
+ */
+SceneCommandQueue::SceneCommandQueue() {}
+
+/**
+ * Destructor.
+ * Commands not yet applied are dropped.
+ */
+SceneCommandQueue::~SceneCommandQueue() {}
+
+/**
+ * Submit adding a sub node.
+ * @see Batch::AddNode
+ */
+void SceneCommandQueue::AddNode(ISceneNode* parent, ISceneNode* node) {
+    Batch(*this).AddNode(parent, node);
+}
+
+/**
+ * Submit removing a sub node.
+ * @see Batch::RemoveNode
+ */
+void SceneCommandQueue::RemoveNode(ISceneNode* parent, ISceneNode* node) {
+    Batch(*this).RemoveNode(parent, node);
+}
+
+/**
+ * Submit deleting a sub node.
+ * @see Batch::DeleteNode
+ */
+void SceneCommandQueue::DeleteNode(ISceneNode* parent, ISceneNode* node) {
+    Batch(*this).DeleteNode(parent, node);
+}
+
+/**
+ * Submit replacing a sub node.
+ * @see Batch::ReplaceNode
+ */
+void SceneCommandQueue::ReplaceNode(ISceneNode* parent, ISceneNode* oldNode,
+                                    ISceneNode* newNode) {
+    Batch(*this).ReplaceNode(parent, oldNode, newNode);
+}
+
+/**
+ * Submit setting the position of a transformation node.
+ * @see Batch::SetPosition
+ */
+void SceneCommandQueue::SetPosition(TransformationNode* node,
+                                    Vector<3,float> position) {
+    Batch(*this).SetPosition(node, position);
+}
+
+/**
+ * Submit setting the rotation of a transformation node.
+ * @see Batch::SetRotation
+ */
+void SceneCommandQueue::SetRotation(TransformationNode* node,
+                                    Quaternion<float> rotation) {
+    Batch(*this).SetRotation(node, rotation);
+}
+
+/**
+ * Submit setting the scale of a transformation node.
+ * @see Batch::SetScale
+ */
+void SceneCommandQueue::SetScale(TransformationNode* node,
+                                 Matrix<4,4,float> scale) {
+    Batch(*this).SetScale(node, scale);
+}
+
+/**
+ * Submit swapping the face set of a geometry node.
+ * @see Batch::SetFaceSet
+ */
+void SceneCommandQueue::SetFaceSet(GeometryNode* node, Geometry::FaceSet* faces) {
+    Batch(*this).SetFaceSet(node, faces);
+}
+
+// move the commands to the pending list, leaving them empty
+void SceneCommandQueue::Submit(vector<Command>& commands) {
+    boost::mutex::scoped_lock lock(mutex);
+    if (pending.empty()) pending.swap(commands);
+    else pending.insert(pending.end(), commands.begin(), commands.end());
+    commands.clear();
+}
+
+/**
+ * Apply the submitted commands in order.
+ * Must be called from the thread that traverses the scene, as the
+ * \a ProcessEventArg handler does. Commands submitted while applying
+ * are applied on the next call.
+ *
+ * A command the scene rejects, such as adding a node that already
+ * has a parent, is logged as an error and skipped, and the rest are
+ * applied. Any other exception is passed on after the commands not
+ * yet applied are put back in front of the pending ones, so no
+ * command is applied twice.
+ *
+ * @return Number of commands applied, the rejected ones included.
+ */
+unsigned int SceneCommandQueue::Apply() {
+    {
+        boost::mutex::scoped_lock lock(mutex);
+        applying.swap(pending);
+    }
+    unsigned int count = applying.size();
+    unsigned int i = 0;
+    try {
+        for (; i<count; i++) {
+            Command& c = applying[i];
+            try {
+                switch (c.type) {
+                case ADD_OP:     c.parent->AddNode(c.node); break;
+                case REMOVE_OP:  c.parent->RemoveNode(c.node); break;
+                case DELETE_OP:  c.parent->DeleteNode(c.node); break;
+                case REPLACE_OP: c.parent->ReplaceNode(c.node, c.other); break;
+                case POSITION_OP:
+                    static_cast<TransformationNode*>(c.node)->SetPosition(c.position);
+                    break;
+                case ROTATION_OP:
+                    static_cast<TransformationNode*>(c.node)->SetRotation(c.rotation);
+                    break;
+                case SCALE_OP:
+                    static_cast<TransformationNode*>(c.node)->SetScale(c.scale);
+                    break;
+                case FACES_OP:
+                    static_cast<GeometryNode*>(c.node)->SetFaceSet(c.faces);
+                    break;
+                }
+            } catch (InvalidSceneOperation& e) {
+                OE_LOG_ERROR << "Scene command rejected: " << e.what()
+                             << logger.end;
+            }
+        }
+    } catch (...) {
+        // the failed command is dropped, the rest are kept in order
+        {
+            boost::mutex::scoped_lock lock(mutex);
+            pending.insert(pending.begin(), applying.begin() + i + 1,
+                           applying.end());
+        }
+        applying.clear();
+        throw;
+    }
+    // keep the capacity for the next frame
+    applying.clear();
+    return count;
+}
+
+/**
+ * Get the number of commands submitted and not yet applied.
+ */
+unsigned int SceneCommandQueue::GetNumPending() const {
+    boost::mutex::scoped_lock lock(mutex);
+    return pending.size();
+}
+
+void SceneCommandQueue::Handle(InitializeEventArg arg) {
+    Apply();
+}
+
+/**
+ * Apply the commands submitted since the last frame.
+ */
+void SceneCommandQueue::Handle(ProcessEventArg arg) {
+    Apply();
+}
+
+void SceneCommandQueue::Handle(DeinitializeEventArg arg) {
+    Apply();
+}
+
+} // NS Scene
+} // NS OpenEngine
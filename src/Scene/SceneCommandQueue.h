@@ -0,0 +1,147 @@
+// Scene command queue.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_SCENE_COMMAND_QUEUE_H_
+#define _OE_SCENE_COMMAND_QUEUE_H_
+
+#include <Core/IModule.h>
+#include <Math/Vector.h>
+#include <Math/Matrix.h>
+#include <Math/Quaternion.h>
+
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+namespace OpenEngine {
+
+namespace Geometry {
+class FaceSet;
+}
+
+namespace Scene {
+
+using OpenEngine::Core::InitializeEventArg;
+using OpenEngine::Core::ProcessEventArg;
+using OpenEngine::Core::DeinitializeEventArg;
+using OpenEngine::Math::Vector;
+using OpenEngine::Math::Matrix;
+using OpenEngine::Math::Quaternion;
+using std::vector;
+
+class ISceneNode;
+class TransformationNode;
+class GeometryNode;
+
+/**
+ * Scene command queue.
+ * Lets any thread change the scene graph. Loaders, AI and other
+ * worker threads submit commands instead of touching the nodes, and
+ * the commands are applied in the order they were submitted when the
+ * queue processes, at a defined point of the frame:
+ * @code
+ * SceneCommandQueue* commands = new SceneCommandQueue();
+ * engine.ProcessEvent().Attach(*commands);   // before the renderer
+ * ...
+ * // on a loader thread
+ * commands->AddNode(root, LoadModel(file));
+ * @endcode
+ *
+ * A thread submitting many commands can collect them in a \a Batch,
+ * which is submitted with a single lock and applied without other
+ * commands in between.
+ *
+ * Submitting takes a short lock; processing takes it once to swap
+ * out the pending commands. The scene traversal itself is never
+ * locked, so the graph must only be changed through the queue (or by
+ * the thread processing it). Nodes referred to by a command must stay
+ * alive until it has been applied.
+ *
+ * @class SceneCommandQueue SceneCommandQueue.h Scene/SceneCommandQueue.h
+ */
+class SceneCommandQueue : public virtual Core::IModule {
+private:
+    enum CommandType {
+        ADD_OP, REMOVE_OP, DELETE_OP, REPLACE_OP,
+        POSITION_OP, ROTATION_OP, SCALE_OP, FACES_OP
+    };
+
+    // one scene change; only the fields of its type are used
+    struct Command {
+        CommandType type;
+        ISceneNode* parent;
+        ISceneNode* node;
+        ISceneNode* other;
+        Vector<3,float> position;
+        Quaternion<float> rotation;
+        Matrix<4,4,float> scale;
+        Geometry::FaceSet* faces;
+        Command(CommandType type, ISceneNode* parent, ISceneNode* node,
+                ISceneNode* other = NULL);
+    };
+
+public:
+
+    /**
+     * Command batch.
+     * Collects commands without locking and submits them at once.
+     * A batch not yet submitted is submitted on destruction.
+     */
+    class Batch {
+    public:
+        Batch(SceneCommandQueue& queue);
+        ~Batch();
+
+        void AddNode(ISceneNode* parent, ISceneNode* node);
+        void RemoveNode(ISceneNode* parent, ISceneNode* node);
+        void DeleteNode(ISceneNode* parent, ISceneNode* node);
+        void ReplaceNode(ISceneNode* parent, ISceneNode* oldNode, ISceneNode* newNode);
+        void SetPosition(TransformationNode* node, Vector<3,float> position);
+        void SetRotation(TransformationNode* node, Quaternion<float> rotation);
+        void SetScale(TransformationNode* node, Matrix<4,4,float> scale);
+        void SetFaceSet(GeometryNode* node, Geometry::FaceSet* faces);
+
+        unsigned int GetSize() const;
+        void Submit();
+
+    private:
+        SceneCommandQueue& queue;
+        vector<Command> commands;
+    };
+
+    SceneCommandQueue();
+    virtual ~SceneCommandQueue();
+
+    void AddNode(ISceneNode* parent, ISceneNode* node);
+    void RemoveNode(ISceneNode* parent, ISceneNode* node);
+    void DeleteNode(ISceneNode* parent, ISceneNode* node);
+    void ReplaceNode(ISceneNode* parent, ISceneNode* oldNode, ISceneNode* newNode);
+    void SetPosition(TransformationNode* node, Vector<3,float> position);
+    void SetRotation(TransformationNode* node, Quaternion<float> rotation);
+    void SetScale(TransformationNode* node, Matrix<4,4,float> scale);
+    void SetFaceSet(GeometryNode* node, Geometry::FaceSet* faces);
+
+    unsigned int Apply();
+    unsigned int GetNumPending() const;
+
+    void Handle(InitializeEventArg arg);
+    void Handle(ProcessEventArg arg);
+    void Handle(DeinitializeEventArg arg);
+
+private:
+    mutable boost::mutex mutex;
+    vector<Command> pending;    //!< submitted, guarded by the mutex
+    vector<Command> applying;   //!< being applied by the processing thread
+
+    void Submit(vector<Command>& commands);
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_SCENE_COMMAND_QUEUE_H_
@@ -8,6 +8,7 @@
 //--------------------------------------------------------------------
 
 #include <Scene/SceneNode.h>
+#include <Utils/Serialization.h>
 
 namespace OpenEngine {
 namespace Scene {
@@ -16,7 +17,7 @@ namespace Scene {
  * Default constructor.
  */
 SceneNode::SceneNode()
-    : ISceneNode() {
+    : ISceneNode(TAG) {
     
 }
 
@@ -41,3 +42,5 @@ SceneNode::~SceneNode() {
 
 } // NS Scene
 } // NS OpenEngine
+
+BOOST_CLASS_EXPORT_IMPLEMENT(OpenEngine::Scene::SceneNode)
@@ -41,7 +41,7 @@ private:
 } // NS Scene
 } // NS OpenEngine
 
-BOOST_CLASS_EXPORT(OpenEngine::Scene::SceneNode);
+BOOST_CLASS_EXPORT_KEY(OpenEngine::Scene::SceneNode)
 
 
 #endif // _SCENE_NODE_H_
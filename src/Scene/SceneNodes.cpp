@@ -1,6 +1,7 @@
 
 #include <Scene/SceneNodes.h>
 #include <Scene/ISceneNodeVisitor.h>
+#include <Scene/NodePool.h>
 
 namespace OpenEngine {
 namespace Scene {
@@ -19,7 +20,7 @@ void type::Accept(ISceneNodeVisitor& v) {                       \
 #define SCENE_NODE(type)                                        \
 ISceneNode* type::Clone() const {                               \
     type* clone = new type(*this);                              \
-    std::list<ISceneNode*>::const_iterator itr;                 \
+    std::vector<ISceneNode*>::const_iterator itr;               \
     for (itr = subNodes.begin(); itr != subNodes.end(); itr++)  \
         clone->AddNode((*itr)->Clone());                        \
     return clone;                                               \
@@ -35,5 +36,34 @@ const std::string type::GetClassName() const {                  \
 #include "SceneNodes.def"
 #undef SCENE_NODE
 
+// Type tag
+#define SCENE_NODE(type)                                        \
+NodeTag type::GetNodeTag() const {                              \
+    return type##Tag;                                           \
+}
+#include "SceneNodes.def"
+#undef SCENE_NODE
+
+// Allocation
+// The pools are never destroyed, as static scenes may be deleted
+// after them. Sub classes outside SceneNodes.def inherit the
+// operators with a different size and fall back to the heap.
+#define SCENE_NODE(type)                                        \
+static NodePool& type##Pool() {                                 \
+    static NodePool* pool = new NodePool(sizeof(type));         \
+    return *pool;                                               \
+}                                                               \
+void* type::operator new(std::size_t size) {                    \
+    if (size != sizeof(type)) return ::operator new(size);      \
+    return type##Pool().Allocate();                             \
+}                                                               \
+void type::operator delete(void* p, std::size_t size) {         \
+    if (p == NULL) return;                                      \
+    if (size != sizeof(type)) ::operator delete(p);             \
+    else type##Pool().Free(p);                                  \
+}
+#include "SceneNodes.def"
+#undef SCENE_NODE
+
 } // NS Scene
 } // NS OpenEngine
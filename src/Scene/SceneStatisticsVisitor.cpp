@@ -0,0 +1,329 @@
+// Scene statistics visitor.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/SceneStatisticsVisitor.h>
+#include <Scene/GeometryNode.h>
+#include <Scene/VertexArrayNode.h>
+#include <Geometry/FaceSet.h>
+#include <Geometry/Face.h>
+#include <Geometry/VertexArray.h>
+#include <Geometry/Material.h>
+#include <Resources/ITextureResource.h>
+
+#include <algorithm>
+#include <iomanip>
+
+namespace OpenEngine {
+namespace Scene {
+
+using Geometry::Face;
+using Geometry::FacePtr;
+using Geometry::FaceSet;
+using Geometry::FaceList;
+using Geometry::Material;
+using Geometry::VertexArray;
+using Resources::ITextureResource;
+
+// Estimated size of a face in a face set. Besides the face itself
+// each entry holds a shared pointer, its reference count block and a
+// list node.
+static const unsigned long FACE_BYTES =
+    sizeof(Face) + sizeof(FacePtr) + 4 * sizeof(void*);
+
+// Orderings used by GetStatistics.
+static bool CompareBytes(const SceneStatisticsVisitor::SubtreeStatistics& a,
+                         const SceneStatisticsVisitor::SubtreeStatistics& b) {
+    if (a.GetTotalBytes() != b.GetTotalBytes())
+        return a.GetTotalBytes() > b.GetTotalBytes();
+    return a.order < b.order;
+}
+static bool CompareFaces(const SceneStatisticsVisitor::SubtreeStatistics& a,
+                         const SceneStatisticsVisitor::SubtreeStatistics& b) {
+    if (a.faces != b.faces) return a.faces > b.faces;
+    return a.order < b.order;
+}
+static bool CompareNodes(const SceneStatisticsVisitor::SubtreeStatistics& a,
+                         const SceneStatisticsVisitor::SubtreeStatistics& b) {
+    if (a.nodes != b.nodes) return a.nodes > b.nodes;
+    return a.order < b.order;
+}
+static bool CompareOrder(const SceneStatisticsVisitor::SubtreeStatistics& a,
+                         const SceneStatisticsVisitor::SubtreeStatistics& b) {
+    return a.order < b.order;
+}
+
+// Escape a string for use as a JSON string literal.
+static string EscapeJSON(const string str) {
+    string nstr = "";
+    for (unsigned int i=0; i<str.length(); i++) {
+        char c = str[i];
+        if      (c == '"')  nstr += "\\\"";
+        else if (c == '\\') nstr += "\\\\";
+        else if (c == '\n') nstr += "\\n";
+        else if (c == '\t') nstr += "\\t";
+        else nstr.push_back(c);
+    }
+    return nstr;
+}
+
+/**
+ * Empty subtree statistics.
+ */
+SceneStatisticsVisitor::SubtreeStatistics::SubtreeStatistics()
+    : node(NULL), depth(0), order(0), nodes(0), faces(0), vertices(0)
+    , vertexArrays(0), materials(0), textures(0)
+    , faceSetBytes(0), vertexArrayBytes(0), textureBytes(0) {}
+
+/**
+ * Get the total estimated memory of the subtree.
+ *
+ * @return Bytes held by face sets, vertex arrays and textures.
+ */
+unsigned long SceneStatisticsVisitor::SubtreeStatistics::GetTotalBytes() const {
+    return faceSetBytes + vertexArrayBytes + textureBytes;
+}
+
+/**
+ * Construct a statistics visitor.
+ */
+SceneStatisticsVisitor::SceneStatisticsVisitor() : order(0) {}
+
+/**
+ * Destructor.
+ */
+SceneStatisticsVisitor::~SceneStatisticsVisitor() {}
+
+/**
+ * Collect statistics for the scene starting at \a node.
+ * Any previously collected statistics are discarded.
+ *
+ * @param node Root of the scene to collect from.
+ */
+void SceneStatisticsVisitor::Collect(ISceneNode& node) {
+    results.clear();
+    stack.clear();
+    order = 0;
+    node.Accept(*this);
+}
+
+/**
+ * Get the statistics of all collected subtrees.
+ *
+ * @param key Ordering of the result.
+ * @return Statistics of each subtree, one per node in the scene.
+ */
+vector<SceneStatisticsVisitor::SubtreeStatistics>
+SceneStatisticsVisitor::GetStatistics(SortKey key) const {
+    vector<SubtreeStatistics> sorted(results);
+    switch (key) {
+    case SORT_BY_BYTES:
+        std::sort(sorted.begin(), sorted.end(), CompareBytes); break;
+    case SORT_BY_FACES:
+        std::sort(sorted.begin(), sorted.end(), CompareFaces); break;
+    case SORT_BY_NODES:
+        std::sort(sorted.begin(), sorted.end(), CompareNodes); break;
+    case SORT_BY_TRAVERSAL:
+        std::sort(sorted.begin(), sorted.end(), CompareOrder); break;
+    }
+    return sorted;
+}
+
+/**
+ * Get the statistics of the entire collected scene.
+ *
+ * @return Statistics of the root node or empty statistics if nothing
+ * has been collected.
+ */
+SceneStatisticsVisitor::SubtreeStatistics
+SceneStatisticsVisitor::GetRootStatistics() const {
+    // the root is the last subtree to finish
+    if (results.empty()) return SubtreeStatistics();
+    return results.back();
+}
+
+/**
+ * Write a human readable report of the collected subtrees.
+ *
+ * @param out Output stream to write to.
+ * @param key Ordering of the subtrees.
+ * @param max Maximum number of subtrees to report (0 for all).
+ */
+void SceneStatisticsVisitor::WriteReport(ostream* out, SortKey key,
+                                         unsigned int max) const {
+    vector<SubtreeStatistics> sorted = GetStatistics(key);
+    if (max == 0 || max > sorted.size()) max = sorted.size();
+    *out << "    Bytes   Faces   Nodes  Mats  Texs  Depth  Subtree\n";
+    for (unsigned int i=0; i<max; i++) {
+        const SubtreeStatistics& s = sorted[i];
+        string name = s.name.substr(0, s.name.find('\n'));
+        *out << std::setw(9) << s.GetTotalBytes()
+             << std::setw(8) << s.faces
+             << std::setw(8) << s.nodes
+             << std::setw(6) << s.materials
+             << std::setw(6) << s.textures
+             << std::setw(7) << s.depth
+             << "  " << name << "\n";
+        map<string,unsigned int>::const_iterator t;
+        for (t = s.nodeTypes.begin(); t != s.nodeTypes.end(); t++)
+            *out << std::setw(55) << t->second << " x " << t->first << "\n";
+    }
+}
+
+/**
+ * Write the collected subtrees as a JSON array.
+ *
+ * @param out Output stream to write to.
+ * @param key Ordering of the subtrees.
+ */
+void SceneStatisticsVisitor::WriteJSON(ostream* out, SortKey key) const {
+    vector<SubtreeStatistics> sorted = GetStatistics(key);
+    *out << "[";
+    for (unsigned int i=0; i<sorted.size(); i++) {
+        const SubtreeStatistics& s = sorted[i];
+        *out << (i ? ",\n " : "\n ")
+             << "{\"name\": \"" << EscapeJSON(s.name) << "\""
+             << ", \"order\": " << s.order
+             << ", \"depth\": " << s.depth
+             << ", \"nodes\": " << s.nodes
+             << ", \"types\": {";
+        map<string,unsigned int>::const_iterator t;
+        for (t = s.nodeTypes.begin(); t != s.nodeTypes.end(); t++)
+            *out << (t == s.nodeTypes.begin() ? "" : ", ")
+                 << "\"" << EscapeJSON(t->first) << "\": " << t->second;
+        *out << "}"
+             << ", \"faces\": " << s.faces
+             << ", \"vertices\": " << s.vertices
+             << ", \"vertexArrays\": " << s.vertexArrays
+             << ", \"materials\": " << s.materials
+             << ", \"textures\": " << s.textures
+             << ", \"faceSetBytes\": " << s.faceSetBytes
+             << ", \"vertexArrayBytes\": " << s.vertexArrayBytes
+             << ", \"textureBytes\": " << s.textureBytes
+             << ", \"totalBytes\": " << s.GetTotalBytes()
+             << "}";
+    }
+    *out << "\n]\n";
+}
+
+/**
+ * Start a new subtree frame.
+ *
+ * @param node Root of the subtree.
+ */
+void SceneStatisticsVisitor::Push(ISceneNode* node) {
+    Frame f;
+    f.stats.node  = node;
+    f.stats.name  = node->ToString();
+    f.stats.depth = stack.size();
+    f.stats.order = order++;
+    f.stats.nodes = 1;
+    f.stats.nodeTypes[node->GetClassName()] = 1;
+    stack.push_back(f);
+}
+
+/**
+ * Finish the current subtree frame and merge it into its parent.
+ */
+void SceneStatisticsVisitor::Pop() {
+    Frame& f = stack.back();
+    // unique materials and textures are only known when the subtree
+    // is complete
+    f.stats.materials = f.materials.size();
+    f.stats.textures  = f.textures.size();
+    set<ITextureResource*>::iterator t;
+    for (t = f.textures.begin(); t != f.textures.end(); t++)
+        f.stats.textureBytes += (unsigned long)(*t)->GetWidth()
+            * (*t)->GetHeight() * ((*t)->GetDepth() / 8);
+    results.push_back(f.stats);
+
+    if (stack.size() > 1) {
+        Frame& p = *(++stack.rbegin());
+        p.stats.nodes            += f.stats.nodes;
+        p.stats.faces            += f.stats.faces;
+        p.stats.vertices         += f.stats.vertices;
+        p.stats.vertexArrays     += f.stats.vertexArrays;
+        p.stats.faceSetBytes     += f.stats.faceSetBytes;
+        p.stats.vertexArrayBytes += f.stats.vertexArrayBytes;
+        map<string,unsigned int>::iterator n;
+        for (n = f.stats.nodeTypes.begin(); n != f.stats.nodeTypes.end(); n++)
+            p.stats.nodeTypes[n->first] += n->second;
+        p.materials.insert(f.materials.begin(), f.materials.end());
+        p.textures.insert(f.textures.begin(), f.textures.end());
+    }
+    stack.pop_back();
+}
+
+/**
+ * Register a material (and its texture) in the current subtree.
+ *
+ * @param mat Material to register, may be NULL.
+ */
+void SceneStatisticsVisitor::AddMaterial(Material* mat) {
+    if (mat == NULL) return;
+    Frame& f = stack.back();
+    f.materials.insert(mat);
+    if (mat->texr != NULL) f.textures.insert(mat->texr.get());
+}
+
+/**
+ * Count a node and traverse its sub nodes.
+ *
+ * @param node Node to count.
+ */
+void SceneStatisticsVisitor::DefaultVisitNode(ISceneNode* node) {
+    Push(node);
+    node->VisitSubNodes(*this);
+    Pop();
+}
+
+/**
+ * Count the faces and materials of a geometry node.
+ *
+ * @param node Geometry node.
+ */
+void SceneStatisticsVisitor::VisitGeometryNode(GeometryNode* node) {
+    Push(node);
+    FaceSet* faces = node->GetFaceSet();
+    if (faces != NULL) {
+        Frame& f = stack.back();
+        f.stats.faces        += faces->Size();
+        f.stats.vertices     += faces->Size() * 3;
+        f.stats.faceSetBytes += sizeof(FaceSet) + faces->Size() * FACE_BYTES;
+        for (FaceList::iterator itr = faces->begin(); itr != faces->end(); itr++)
+            AddMaterial((*itr)->mat.get());
+    }
+    node->VisitSubNodes(*this);
+    Pop();
+}
+
+/**
+ * Count the vertex arrays and materials of a vertex array node.
+ *
+ * @param node Vertex array node.
+ */
+void SceneStatisticsVisitor::VisitVertexArrayNode(VertexArrayNode* node) {
+    Push(node);
+    const list<VertexArray*>& vaList = node->GetVertexArrays();
+    list<VertexArray*>::const_iterator itr;
+    for (itr = vaList.begin(); itr != vaList.end(); itr++) {
+        Frame& f = stack.back();
+        unsigned long faces = (*itr)->GetNumFaces();
+        f.stats.faces        += faces;
+        f.stats.vertices     += faces * 3;
+        f.stats.vertexArrays += 1;
+        f.stats.vertexArrayBytes += sizeof(VertexArray)
+            + (*itr)->GetDataSize();
+        AddMaterial((*itr)->mat.get());
+    }
+    node->VisitSubNodes(*this);
+    Pop();
+}
+
+} // NS Scene
+} // NS OpenEngine
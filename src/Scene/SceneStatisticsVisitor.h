@@ -0,0 +1,137 @@
+// Scene statistics visitor.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_SCENE_STATISTICS_VISITOR_H_
+#define _OE_SCENE_STATISTICS_VISITOR_H_
+
+#include <Scene/ISceneNodeVisitor.h>
+
+#include <string>
+#include <ostream>
+#include <vector>
+#include <list>
+#include <map>
+#include <set>
+
+// forward declarations
+namespace OpenEngine {
+namespace Geometry { class Material; }
+namespace Resources { class ITextureResource; }
+}
+
+namespace OpenEngine {
+namespace Scene {
+
+using std::string;
+using std::ostream;
+using std::vector;
+using std::list;
+using std::map;
+using std::set;
+
+/**
+ * Scene statistics visitor.
+ *
+ * Collects the cost of every subtree in a scene: the number of nodes
+ * of each type, the number of faces and vertices, the unique
+ * materials and textures in use and an estimate of the memory held
+ * by face sets, vertex arrays and texture data.
+ *
+ * Usage:
+ * @code
+ * SceneStatisticsVisitor stats;
+ * stats.Collect(*scene);
+ * // the ten most memory expensive subtrees as a text report
+ * stats.WriteReport(&std::cout, SceneStatisticsVisitor::SORT_BY_BYTES, 10);
+ * // or everything as JSON for further processing
+ * ofstream out("scene.json", ios::out);
+ * stats.WriteJSON(&out);
+ * @endcode
+ *
+ * Shared materials and textures are counted once per subtree, so the
+ * texture bytes of a subtree are the bytes of its unique textures.
+ *
+ * @class SceneStatisticsVisitor SceneStatisticsVisitor.h Scene/SceneStatisticsVisitor.h
+ */
+class SceneStatisticsVisitor : public ISceneNodeVisitor {
+public:
+
+    /**
+     * Ordering of the collected subtree statistics.
+     *
+     * @enum SortKey
+     */
+    enum SortKey {
+        SORT_BY_BYTES,          //!< total estimated bytes
+        SORT_BY_FACES,          //!< number of faces
+        SORT_BY_NODES,          //!< number of nodes
+        SORT_BY_TRAVERSAL       //!< depth-first traversal order
+    };
+
+    /**
+     * Statistics of a single subtree.
+     * All counts include the root of the subtree.
+     */
+    struct SubtreeStatistics {
+        ISceneNode* node;                   //!< subtree root
+        string name;                        //!< string representation of the root
+        unsigned int depth;                 //!< depth of the root in the scene
+        unsigned int order;                 //!< depth-first traversal index
+        unsigned int nodes;                 //!< total number of nodes
+        map<string,unsigned int> nodeTypes; //!< number of nodes by class name
+        unsigned int faces;                 //!< number of faces
+        unsigned int vertices;              //!< number of (unindexed) vertices
+        unsigned int vertexArrays;          //!< number of vertex arrays
+        unsigned int materials;             //!< number of unique materials
+        unsigned int textures;              //!< number of unique textures
+        unsigned long faceSetBytes;         //!< estimated face set memory
+        unsigned long vertexArrayBytes;     //!< estimated vertex array memory
+        unsigned long textureBytes;         //!< estimated texture memory
+        SubtreeStatistics();
+        unsigned long GetTotalBytes() const;
+    };
+
+    SceneStatisticsVisitor();
+    virtual ~SceneStatisticsVisitor();
+
+    void Collect(ISceneNode& node);
+    vector<SubtreeStatistics> GetStatistics(SortKey key = SORT_BY_BYTES) const;
+    SubtreeStatistics GetRootStatistics() const;
+
+    void WriteReport(ostream* out, SortKey key = SORT_BY_BYTES,
+                     unsigned int max = 0) const;
+    void WriteJSON(ostream* out, SortKey key = SORT_BY_BYTES) const;
+
+    void VisitGeometryNode(GeometryNode* node);
+    void VisitVertexArrayNode(VertexArrayNode* node);
+
+protected:
+    void DefaultVisitNode(ISceneNode* node);
+
+private:
+    // working frame for a subtree under traversal
+    struct Frame {
+        SubtreeStatistics stats;
+        set<Geometry::Material*> materials;
+        set<Resources::ITextureResource*> textures;
+    };
+
+    list<Frame> stack;                  //!< frames of the current path
+    vector<SubtreeStatistics> results;  //!< finished subtrees
+    unsigned int order;                 //!< traversal counter
+
+    void Push(ISceneNode* node);
+    void Pop();
+    void AddMaterial(Geometry::Material* mat);
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_SCENE_STATISTICS_VISITOR_H_
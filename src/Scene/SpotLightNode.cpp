@@ -8,12 +8,14 @@
 //--------------------------------------------------------------------
 
 #include <Scene/SpotLightNode.h>
+#include <Utils/Serialization.h>
 
 namespace OpenEngine {
 namespace Scene {
 
 SpotLightNode::SpotLightNode()
-  : constAtt(1.0)
+  : LightNode(TAG)
+  , constAtt(1.0)
   , linearAtt(0.0)
   , quadAtt(0.0)
   , cutoff(180.0)
@@ -28,3 +30,5 @@ SpotLightNode::~SpotLightNode() {
 
 } // NS Scene
 } // NS OpenEngine
+
+BOOST_CLASS_EXPORT_IMPLEMENT(OpenEngine::Scene::SpotLightNode)
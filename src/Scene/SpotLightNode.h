@@ -47,6 +47,6 @@ private:
 } // NS Scene
 } // NS OpenEngine
 
-BOOST_CLASS_EXPORT(OpenEngine::Scene::SpotLightNode)
+BOOST_CLASS_EXPORT_KEY(OpenEngine::Scene::SpotLightNode)
 
 #endif // _SPOT_LIGHT_NODE_H_
@@ -0,0 +1,118 @@
+// Table driven scene node visitor.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#include <Scene/TableVisitor.h>
+#include <Scene/SceneNodes.h>
+#include <Scene/ISceneNodeVisitor.h>
+
+#include <typeinfo>
+
+namespace OpenEngine {
+namespace Scene {
+
+// the exact type of each tag
+static const std::type_info* types[NUM_NODE_TAGS] = {
+#define SCENE_NODE(type) &typeid(type),
+#include "SceneNodes.def"
+#undef SCENE_NODE
+};
+
+/**
+ * Visitor passing the nodes of types outside SceneNodes.def through
+ * their own Accept and VisitSubNodes, and on to the handlers.
+ */
+class TableVisitor::Adapter : public ISceneNodeVisitor {
+public:
+    TableVisitor& visitor;
+    Adapter(TableVisitor& visitor) : visitor(visitor) {}
+#define SCENE_NODE(type)                                \
+    void Visit##type(type* node) {                      \
+        if (typeid(*node) == typeid(type))              \
+            visitor.handlers[type##Tag](visitor, node); \
+        else visitor.HandleForeign(type##Tag, node);    \
+    }
+#include "SceneNodes.def"
+#undef SCENE_NODE
+};
+
+/**
+ * Create a visitor without handlers.
+ * All node types are passed on to their sub nodes.
+ */
+TableVisitor::TableVisitor() : foreign(NULL) {
+    for (unsigned int i=0; i<NUM_NODE_TAGS; i++)
+        handlers[i] = &Default;
+}
+
+TableVisitor::~TableVisitor() {}
+
+/**
+ * Visit a node with the handler of its type.
+ *
+ * @param node Node to visit.
+ */
+void TableVisitor::Visit(ISceneNode* node) {
+    unsigned int tag = node->tag;
+    if (tag == NUM_NODE_TAGS || typeid(*node) != *types[tag]) {
+        // may overwrite Accept
+        Adapter adapter(*this);
+        node->Accept(adapter);
+        return;
+    }
+    node->acceptStack++;
+    handlers[tag](*this, node);
+    // only call out when there are delayed operations to perform
+    if (node->acceptStack == 1 && !node->operationQueue.empty())
+        node->DecAcceptStack();
+    else node->acceptStack--;
+}
+
+/**
+ * Visit all sub nodes of a node.
+ * This is what happens to nodes without a handler.
+ *
+ * @param node Node to visit the sub nodes of.
+ */
+void TableVisitor::VisitSubNodes(ISceneNode* node) {
+    if (node == foreign) {
+        // may overwrite VisitSubNodes
+        Adapter adapter(*this);
+        node->VisitSubNodes(adapter);
+        return;
+    }
+    // by index, as nodes added during traversal may move the array
+    std::vector<ISceneNode*>& subNodes = node->subNodes;
+    for (unsigned int i=0; i<subNodes.size(); i++)
+        Visit(subNodes[i]);
+}
+
+/**
+ * Set the handler of a node type.
+ *
+ * @param tag Node type tag.
+ * @param handler Handler for the type, NULL restores the default.
+ */
+void TableVisitor::SetHandler(NodeTag tag, Handler handler) {
+    handlers[tag] = handler ? handler : &Default;
+}
+
+// handle a node of a type outside SceneNodes.def
+void TableVisitor::HandleForeign(NodeTag tag, ISceneNode* node) {
+    ISceneNode* outer = foreign;
+    foreign = node;
+    handlers[tag](*this, node);
+    foreign = outer;
+}
+
+void TableVisitor::Default(TableVisitor& visitor, ISceneNode* node) {
+    visitor.VisitSubNodes(node);
+}
+
+} // NS Scene
+} // NS OpenEngine
@@ -0,0 +1,101 @@
+// Table driven scene node visitor.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS)
+//
+// This program is free software; It is covered by the GNU General
+// Public License version 2 or any later version.
+// See the GNU General Public License for more details (see LICENSE).
+//--------------------------------------------------------------------
+
+#ifndef _OE_TABLE_VISITOR_H_
+#define _OE_TABLE_VISITOR_H_
+
+#include <Scene/ISceneNode.h>
+
+namespace OpenEngine {
+namespace Scene {
+
+/**
+ * Table driven scene node visitor.
+ * An alternative to \a ISceneNodeVisitor that dispatches on the node
+ * type tag through a table of handlers, one for each node type in
+ * SceneNodes.def, instead of the virtual \a Accept and Visit calls.
+ * Types without a handler go straight to the sub nodes, so a
+ * traversal only pays for the node types it handles.
+ *
+ * Handlers are bound in the constructor of the visitor:
+ * @code
+ * class GeometryCounter : public TableVisitor {
+ * public:
+ *   unsigned int count;
+ *   GeometryCounter() : count(0) {
+ *     Bind<GeometryCounter, GeometryNode,
+ *          &GeometryCounter::VisitGeometryNode>();
+ *   }
+ *   void VisitGeometryNode(GeometryNode* node) {
+ *     count++;
+ *     VisitSubNodes(node);
+ *   }
+ * };
+ * @endcode
+ *
+ * As with the visitor methods, a handler only applies to its exact
+ * node type and not to the types derived from it. The tag is given
+ * to each node by the constructor of its type, and the traversal
+ * walks \a ISceneNode::subNodes directly for the types in
+ * SceneNodes.def. Nodes of other types, which may overwrite \a
+ * ISceneNode::Accept or \a ISceneNode::VisitSubNodes, go through
+ * those methods instead and are as slow to visit as with \a
+ * ISceneNodeVisitor. For those overrides to apply, handlers pass
+ * only the node they handle to \a VisitSubNodes. Operations on the
+ * sub nodes are delayed during traversal just as under \a Accept.
+ *
+ * @class TableVisitor TableVisitor.h Scene/TableVisitor.h
+ *
+ * @see ISceneNodeVisitor
+ * @see NodeTag
+ */
+class TableVisitor {
+public:
+    //! Node handler, called with the visitor and the visited node.
+    typedef void (*Handler)(TableVisitor& visitor, ISceneNode* node);
+
+    TableVisitor();
+    virtual ~TableVisitor();
+
+    void Visit(ISceneNode* node);
+    void VisitSubNodes(ISceneNode* node);
+
+protected:
+    void SetHandler(NodeTag tag, Handler handler);
+
+    /**
+     * Bind a visitor method to a node type.
+     *
+     * @tparam V Visitor type, a sub class of TableVisitor.
+     * @tparam N Node type from SceneNodes.def.
+     * @tparam M Method of V called with nodes of type N.
+     */
+    template <class V, class N, void (V::*M)(N*)>
+    void Bind() {
+        SetHandler(N::TAG, &Call<V, N, M>);
+    }
+
+private:
+    class Adapter;
+    Handler handlers[NUM_NODE_TAGS];
+    ISceneNode* foreign;        //!< node of another type being handled
+
+    template <class V, class N, void (V::*M)(N*)>
+    static void Call(TableVisitor& visitor, ISceneNode* node) {
+        (static_cast<V&>(visitor).*M)(static_cast<N*>(node));
+    }
+
+    void HandleForeign(NodeTag tag, ISceneNode* node);
+    static void Default(TableVisitor& visitor, ISceneNode* node);
+};
+
+} // NS Scene
+} // NS OpenEngine
+
+#endif // _OE_TABLE_VISITOR_H_
@@ -8,12 +8,14 @@
 //--------------------------------------------------------------------
 
 #include <Scene/TransformationNode.h>
+#include <Utils/Serialization.h>
+#include <Scene/SceneChangeLog.h>
 
 namespace OpenEngine {
 namespace Scene {
 
     //! Empty constructor.
-    TransformationNode::TransformationNode() {}
+    TransformationNode::TransformationNode() : ISceneNode(TAG) {}
 
     /**
      * Copy constructor.
@@ -45,6 +47,7 @@ namespace Scene {
     void TransformationNode::Move(float x, float y, float z) {
         // add the rotation of v around the current quaternion to the position
         position += rotation.RotateVector(Vector<3,float>(x,y,z)); 
+        RecordChange(SceneChange(SceneChange::TRANSFORMATION_CHANGED, this));
     }
 
     /**
@@ -62,6 +65,7 @@ namespace Scene {
         q.Normalize();
         // apply the accumulated rotation
         rotation = rotation * q;
+        RecordChange(SceneChange(SceneChange::TRANSFORMATION_CHANGED, this));
     }
 
     /**
@@ -79,6 +83,7 @@ namespace Scene {
                             0.0f, 0.0f, z,    0.0f,
                             0.0f, 0.0f, 0.0f, 1.0f);
         scale = scale * s;
+        RecordChange(SceneChange(SceneChange::TRANSFORMATION_CHANGED, this));
     }
 
 
@@ -114,6 +119,7 @@ namespace Scene {
      */
     void TransformationNode::SetPosition(Vector<3,float> position) {
         this->position = position;
+        RecordChange(SceneChange(SceneChange::TRANSFORMATION_CHANGED, this));
     }
 
     /**
@@ -141,6 +147,7 @@ namespace Scene {
      */
     void TransformationNode::SetRotation(Quaternion<float> rotation) {
         this->rotation = rotation;
+        RecordChange(SceneChange(SceneChange::TRANSFORMATION_CHANGED, this));
     }
 
     /**
@@ -150,6 +157,7 @@ namespace Scene {
      */
     void TransformationNode::SetScale(Matrix<4,4,float> scale) {
         this->scale = scale;
+        RecordChange(SceneChange(SceneChange::TRANSFORMATION_CHANGED, this));
     }
 
     /**
@@ -202,3 +210,5 @@ namespace Scene {
 
 } // NS Modules
 } // NS OpenEngine
+
+BOOST_CLASS_EXPORT_IMPLEMENT(OpenEngine::Scene::TransformationNode)
@@ -102,6 +102,6 @@ protected:
 } // NS Scene
 } // NS OpenEngine
 
-BOOST_CLASS_EXPORT(OpenEngine::Scene::TransformationNode)
+BOOST_CLASS_EXPORT_KEY(OpenEngine::Scene::TransformationNode)
 
 #endif // _OE_TRANSFORMATION_NODE_H_
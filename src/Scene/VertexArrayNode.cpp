@@ -8,6 +8,8 @@
 //--------------------------------------------------------------------
 
 #include <Scene/VertexArrayNode.h>
+#include <Utils/Serialization.h>
+#include <Scene/SceneChangeLog.h>
 #include <Geometry/VertexArray.h>
 #include <Utils/Convert.h>
 
@@ -16,7 +18,7 @@ namespace Scene {
 
 using Geometry::VertexArray;
 
-VertexArrayNode::VertexArrayNode()  {
+VertexArrayNode::VertexArrayNode() : ISceneNode(TAG) {
 
 }
     
@@ -27,12 +29,13 @@ VertexArrayNode::~VertexArrayNode() {
     vaList.clear();
 }
 
-std::list<VertexArray*> VertexArrayNode::GetVertexArrays() {
+const std::list<VertexArray*>& VertexArrayNode::GetVertexArrays() {
     return vaList;
 }
 
 void VertexArrayNode::AddVertexArray(VertexArray& vertexArray) {
     vaList.push_back(&vertexArray);
+    RecordChange(SceneChange(SceneChange::GEOMETRY_CHANGED, this));
 }
 
 const std::string VertexArrayNode::ToString() const {
@@ -43,3 +46,5 @@ const std::string VertexArrayNode::ToString() const {
     
 } //NS Scene
 } //NS OpenEngine
+
+BOOST_CLASS_EXPORT_IMPLEMENT(OpenEngine::Scene::VertexArrayNode)
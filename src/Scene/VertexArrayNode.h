@@ -14,6 +14,7 @@
 
 // We must include VertexArray for serialization to work proper.
 #include <Geometry/VertexArray.h>
+#include <boost/serialization/list.hpp>
 
 namespace OpenEngine {
 namespace Scene {
@@ -42,11 +43,13 @@ public:
     virtual ~VertexArrayNode();
 
     /**
-     * Get faces this Vertex Array Node contains.
+     * Get the vertex arrays this Vertex Array Node contains.
+     * The list is returned by reference, so renderers walking the
+     * scene every frame do not copy it.
      *
-     * @return FaceSet pointer.
+     * @return List of vertex arrays.
      */
-    virtual std::list<Geometry::VertexArray*> GetVertexArrays();
+    virtual const std::list<Geometry::VertexArray*>& GetVertexArrays();
 
     /**
      * Set FaceSet for this Vertex Array Node.
@@ -73,6 +76,6 @@ private:
 } // NS Scene
 } // NS OpenEngine
 
-BOOST_CLASS_EXPORT(OpenEngine::Scene::VertexArrayNode)
+BOOST_CLASS_EXPORT_KEY(OpenEngine::Scene::VertexArrayNode)
 
 #endif // _VERTEX_ARRAY_NODE_H_
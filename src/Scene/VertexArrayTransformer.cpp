@@ -25,7 +25,9 @@ using Geometry::FacePtr;
 using Geometry::MaterialPtr;
 using Geometry::VertexArray;
 
-VertexArrayTransformer::VertexArrayTransformer() {
+VertexArrayTransformer::VertexArrayTransformer(int attributes,
+                                               VertexArray::Layout layout)
+    : attributes(attributes), layout(layout) {
 }
 
 VertexArrayTransformer::~VertexArrayTransformer() {
@@ -41,9 +43,9 @@ void VertexArrayTransformer::VisitGeometryNode(GeometryNode* node) {
     VertexArrayNode* vaNode = new VertexArrayNode();
 
     // Move sub nodes to the new VA node
-    std::list<ISceneNode*> sn = node->subNodes;
+    std::vector<ISceneNode*> sn = node->subNodes;
     node->RemoveAllNodes();
-    std::list<ISceneNode*>::iterator itr;
+    std::vector<ISceneNode*>::iterator itr;
     for (itr = sn.begin(); itr != sn.end(); itr++)
         vaNode->AddNode(*itr);
 
@@ -86,7 +88,7 @@ void VertexArrayTransformer::VisitGeometryNode(GeometryNode* node) {
 	std::list<FaceSet*>::iterator ilist = flist.begin();
         for (ilist = flist.begin(); ilist != flist.end(); ilist++) {
 	    FaceSet* fs = *ilist;
-            VertexArray* va = new VertexArray(*fs);
+            VertexArray* va = new VertexArray(*fs, attributes, layout);
             vaNode->AddVertexArray(*va);
             delete fs;
         }
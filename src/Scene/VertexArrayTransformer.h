@@ -11,6 +11,7 @@
 #define _OE_VERTEX_ARRAY_TRANSFORMER_H_
 
 #include <Scene/ISceneNodeVisitor.h>
+#include <Geometry/VertexArray.h>
 
 namespace OpenEngine {
 namespace Scene {
@@ -19,17 +20,25 @@ namespace Scene {
  * Vertex Array Transformer.
  * Destructively transforms all nodes of type \a GeometryNode in a scene
  * to nodes of type \a VertexArrayNode.
+ * The created vertex arrays store the given attributes in the given
+ * layout (see \a VertexArray).
  *
  * @class VertexArrayTransformer VertexArrayTransformer.h Scene/VertexArrayTransformer.h
  */
 class VertexArrayTransformer : public ISceneNodeVisitor{
 public:
-    VertexArrayTransformer();
+    VertexArrayTransformer(int attributes = Geometry::VertexArray::ALL_ATTRIBUTES,
+                           Geometry::VertexArray::Layout layout
+                           = Geometry::VertexArray::PLANAR);
     ~VertexArrayTransformer();
 
     void Transform(ISceneNode& node);
     void VisitGeometryNode(GeometryNode* node);
 
+private:
+    int attributes;
+    Geometry::VertexArray::Layout layout;
+
 };
 
 } // NS Scene
@@ -0,0 +1,74 @@
+#include <Testing/Testing.h>
+
+#include <Scene/NodePool.h>
+#include <Scene/SceneNode.h>
+#include <Scene/TransformationNode.h>
+
+#include <cstring>
+#include <set>
+
+using namespace OpenEngine::Scene;
+
+// sub class outside SceneNodes.def, larger than a scene node
+class Large : public SceneNode {
+public:
+    char data[256];
+    Large() { memset(data, 0xff, sizeof(data)); }
+};
+
+int test_main(int argc, char* argv[]) {
+
+    // blocks are distinct, aligned and reused
+    {
+        NodePool pool(24);
+        std::set<void*> blocks;
+        for (unsigned int i=0; i<200; i++) {
+            void* block = pool.Allocate();
+            OE_CHECK(((std::size_t)block & 15) == 0);
+            memset(block, 0, 24);
+            blocks.insert(block);
+        }
+        OE_CHECK(blocks.size() == 200);
+        OE_CHECK(pool.GetNumAllocated() == 200);
+        OE_CHECK(pool.GetCapacity() >= 200);
+        unsigned int capacity = pool.GetCapacity();
+        void* block = *blocks.begin();
+        pool.Free(block);
+        OE_CHECK(pool.GetNumAllocated() == 199);
+        OE_CHECK(pool.Allocate() == block);
+        OE_CHECK(pool.GetCapacity() == capacity);
+        std::set<void*>::iterator itr;
+        for (itr = blocks.begin(); itr != blocks.end(); itr++)
+            pool.Free(*itr);
+        OE_CHECK(pool.GetNumAllocated() == 0);
+    }
+
+    // node types allocate from their pool
+    {
+        SceneNode* a = new SceneNode();
+        delete a;
+        SceneNode* b = new SceneNode();
+        OE_CHECK(a == b);
+        // another type has a pool of its own
+        TransformationNode* t = new TransformationNode();
+        OE_CHECK((void*)t != (void*)b);
+        delete t;
+        delete b;
+    }
+
+    // larger sub classes fall back to the heap
+    {
+        SceneNode* a = new SceneNode();
+        delete a;
+        // the pool would hand out the block just freed
+        Large* l = new Large();
+        OE_CHECK((void*)l != (void*)a);
+        SceneNode* b = new SceneNode();
+        OE_CHECK(a == b);
+        OE_CHECK(l->data[sizeof(l->data) - 1] == (char)0xff);
+        delete b;
+        delete l;
+    }
+
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <Testing/Testing.h>
+
+#include <Scene/SceneChangeLog.h>
+#include <Scene/SceneNode.h>
+#include <Scene/TransformationNode.h>
+#include <Core/IListener.h>
+
+using namespace OpenEngine::Scene;
+using OpenEngine::Core::IListener;
+
+// keeps the changes of the last flush
+class Changes : public IListener<SceneChangesEventArg> {
+public:
+    vector<SceneChange> changes;
+    void Handle(SceneChangesEventArg arg) {
+        changes = arg.changes;
+    }
+};
+
+// flush the log and check it published exactly the given change
+static bool Published(SceneChangeLog& log, Changes& listener,
+                      const SceneChange& change) {
+    listener.changes.clear();
+    return log.Flush() == 1 && listener.changes.size() == 1
+        && listener.changes[0] == change;
+}
+
+int test_main(int argc, char* argv[]) {
+    SceneChangeLog log;
+    Changes listener;
+    log.ChangesEvent().Attach(listener);
+
+    SceneNode* root = new SceneNode();
+    root->SetChangeLog(&log);
+    OE_CHECK(root->GetChangeLog() == &log);
+
+    // a subtree built apart is recorded as one addition
+    TransformationNode* branch = new TransformationNode();
+    TransformationNode* leaf = new TransformationNode();
+    branch->AddNode(leaf);
+    leaf->Move(1, 0, 0);
+    OE_CHECK(log.GetNumPending() == 0);
+    root->AddNode(branch);
+    OE_CHECK(Published(log, listener,
+                       SceneChange(SceneChange::NODE_ADDED, branch, root)));
+
+    // once attached the nodes below record into the log, repeats once
+    leaf->Move(1, 0, 0);
+    leaf->Move(1, 0, 0);
+    OE_CHECK(Published(log, listener,
+                       SceneChange(SceneChange::TRANSFORMATION_CHANGED, leaf)));
+
+    // removed nodes drop the log with their sub nodes
+    root->RemoveNode(branch);
+    OE_CHECK(Published(log, listener,
+                       SceneChange(SceneChange::NODE_REMOVED, branch, root)));
+    leaf->Move(1, 0, 0);
+    branch->Move(1, 0, 0);
+    OE_CHECK(log.Flush() == 0);
+
+    // a node with its own log keeps it below the root and after removal
+    SceneChangeLog own;
+    Changes ownListener;
+    own.ChangesEvent().Attach(ownListener);
+    branch->SetChangeLog(&own);
+    root->AddNode(branch);
+    OE_CHECK(Published(log, listener,
+                       SceneChange(SceneChange::NODE_ADDED, branch, root)));
+    leaf->Move(1, 0, 0);
+    OE_CHECK(log.GetNumPending() == 0);
+    OE_CHECK(Published(own, ownListener,
+                       SceneChange(SceneChange::TRANSFORMATION_CHANGED, leaf)));
+    root->RemoveNode(branch);
+    leaf->Move(1, 0, 0);
+    OE_CHECK(own.GetNumPending() == 1);
+    own.Flush();
+
+    // clearing its own log makes it inherit the parent's again
+    root->AddNode(branch);
+    log.Flush();
+    branch->SetChangeLog(NULL);
+    leaf->Move(1, 0, 0);
+    OE_CHECK(own.GetNumPending() == 0);
+    OE_CHECK(Published(log, listener,
+                       SceneChange(SceneChange::TRANSFORMATION_CHANGED, leaf)));
+
+    // a replacing node takes the log over
+    TransformationNode* other = new TransformationNode();
+    root->ReplaceNode(branch, other);
+    OE_CHECK(Published(log, listener,
+                       SceneChange(SceneChange::NODE_REPLACED, branch, root, other)));
+    other->Move(1, 0, 0);
+    OE_CHECK(Published(log, listener,
+                       SceneChange(SceneChange::TRANSFORMATION_CHANGED, other)));
+
+    // clearing the root log stops recording below it
+    root->SetChangeLog(NULL);
+    other->Move(1, 0, 0);
+    OE_CHECK(log.GetNumPending() == 0);
+    delete root;
+    return 0;
+}
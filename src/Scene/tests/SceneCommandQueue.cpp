@@ -0,0 +1,95 @@
+#include <Testing/Testing.h>
+
+#include <Scene/SceneCommandQueue.h>
+#include <Scene/SceneNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/GeometryNode.h>
+#include <Scene/Exceptions.h>
+#include <Geometry/FaceSet.h>
+
+using namespace OpenEngine::Scene;
+using OpenEngine::Geometry::FaceSet;
+using OpenEngine::Math::Vector;
+
+// true if submitting a NULL node is refused right away
+static bool Refused(SceneCommandQueue& queue, int op) {
+    try {
+        switch (op) {
+        case 0: queue.AddNode(NULL, NULL); break;
+        case 1: queue.RemoveNode(NULL, NULL); break;
+        case 2: queue.DeleteNode(NULL, NULL); break;
+        case 3: queue.ReplaceNode(NULL, NULL, NULL); break;
+        case 4: queue.SetPosition(NULL, Vector<3,float>()); break;
+        case 5: queue.SetFaceSet(NULL, NULL); break;
+        }
+    } catch (InvalidSceneOperation&) {
+        return true;
+    }
+    return false;
+}
+
+int test_main(int argc, char* argv[]) {
+    SceneCommandQueue queue;
+    SceneNode root, other;
+
+    // nothing changes before the queue is applied, then all in order
+    TransformationNode* trans = new TransformationNode();
+    queue.AddNode(&root, trans);
+    queue.SetPosition(trans, Vector<3,float>(1, 2, 3));
+    queue.RemoveNode(&root, trans);
+    queue.AddNode(&other, trans);
+    queue.SetPosition(trans, Vector<3,float>(4, 5, 6));
+    OE_CHECK(queue.GetNumPending() == 5);
+    OE_CHECK(trans->GetParent() == NULL);
+    OE_CHECK(queue.Apply() == 5);
+    OE_CHECK(queue.GetNumPending() == 0);
+    OE_CHECK(trans->GetParent() == &other);
+    OE_CHECK(root.GetNumberOfNodes() == 0);
+    OE_CHECK((trans->GetPosition() == Vector<3,float>(4, 5, 6)));
+    OE_CHECK(queue.Apply() == 0);
+
+    // a batch is held back until submitted, then applied as a whole
+    GeometryNode* geom = new GeometryNode(new FaceSet());
+    FaceSet* faces = new FaceSet();
+    {
+        SceneCommandQueue::Batch batch(queue);
+        batch.AddNode(trans, geom);
+        batch.SetFaceSet(geom, faces);
+        OE_CHECK(batch.GetSize() == 2);
+        OE_CHECK(queue.GetNumPending() == 0);
+        batch.Submit();
+        OE_CHECK(batch.GetSize() == 0);
+        OE_CHECK(queue.GetNumPending() == 2);
+        batch.RemoveNode(trans, geom);
+    }
+    // the destructor submitted the rest
+    OE_CHECK(queue.GetNumPending() == 3);
+    queue.Apply();
+    OE_CHECK(geom->GetParent() == NULL);
+    OE_CHECK(geom->GetFaceSet() == faces);
+
+    // NULL nodes are refused when submitted and never queued
+    for (int op=0; op<6; op++)
+        OE_CHECK(Refused(queue, op));
+    OE_CHECK(queue.GetNumPending() == 0);
+
+    // a command the scene rejects is skipped, the rest still apply
+    TransformationNode* second = new TransformationNode();
+    queue.AddNode(&root, geom);
+    queue.AddNode(&root, geom);            // already has a parent
+    queue.RemoveNode(&root, second);       // not a sub node
+    queue.AddNode(&root, second);
+    OE_CHECK(queue.Apply() == 4);
+    OE_CHECK(root.GetNumberOfNodes() == 2);
+    OE_CHECK(geom->GetParent() == &root);
+    OE_CHECK(second->GetParent() == &root);
+
+    // replacing deletes the replaced node
+    TransformationNode* third = new TransformationNode();
+    queue.ReplaceNode(&root, second, third);
+    queue.DeleteNode(&root, geom);
+    queue.Apply();
+    OE_CHECK(root.GetNumberOfNodes() == 1);
+    OE_CHECK(third->GetParent() == &root);
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include <Testing/Testing.h>
+
+#include <Scene/SceneStatisticsVisitor.h>
+#include <Scene/SceneNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/GeometryNode.h>
+#include <Geometry/FaceSet.h>
+#include <Geometry/Face.h>
+#include <Geometry/Material.h>
+
+#include <sstream>
+
+using namespace OpenEngine::Scene;
+using namespace OpenEngine::Geometry;
+using OpenEngine::Math::Vector;
+
+// a face set of n faces sharing one material
+static FaceSet* Faces(unsigned int n, MaterialPtr mat) {
+    FaceSet* faces = new FaceSet();
+    for (unsigned int i=0; i<n; i++) {
+        FacePtr face(new Face(Vector<3,float>(0,0,i),
+                              Vector<3,float>(1,0,i),
+                              Vector<3,float>(0,1,i)));
+        face->mat = mat;
+        faces->Add(face);
+    }
+    return faces;
+}
+
+// number of times a string occurs
+static unsigned int Count(const std::string& str, const std::string& sub) {
+    unsigned int n = 0;
+    for (std::string::size_type i = str.find(sub);
+         i != std::string::npos; i = str.find(sub, i + 1))
+        n++;
+    return n;
+}
+
+int test_main(int argc, char* argv[]) {
+    MaterialPtr shared(new Material());
+    MaterialPtr other(new Material());
+
+    // root
+    //  +- transformation
+    //  |   +- geometry (2 faces, shared)
+    //  +- geometry (3 faces, shared and other)
+    ISceneNode* root = new SceneNode();
+    ISceneNode* trans = new TransformationNode();
+    GeometryNode* small = new GeometryNode(Faces(2, shared));
+    FaceSet* mixed = Faces(2, shared);
+    FacePtr face(new Face(Vector<3,float>(0,0,0),
+                          Vector<3,float>(0,0,1),
+                          Vector<3,float>(0,1,0)));
+    face->mat = other;
+    mixed->Add(face);
+    GeometryNode* large = new GeometryNode(mixed);
+    root->AddNode(trans);
+    trans->AddNode(small);
+    root->AddNode(large);
+
+    SceneStatisticsVisitor stats;
+    stats.Collect(*root);
+
+    // one subtree per node, the root counting everything once
+    SceneStatisticsVisitor::SubtreeStatistics all = stats.GetRootStatistics();
+    OE_CHECK(all.node == root);
+    OE_CHECK(all.depth == 0);
+    OE_CHECK(all.nodes == 4);
+    OE_CHECK(all.faces == 5);
+    OE_CHECK(all.vertices == 15);
+    OE_CHECK(all.materials == 2);
+    OE_CHECK(all.nodeTypes["GeometryNode"] == 2);
+    OE_CHECK(all.nodeTypes["TransformationNode"] == 1);
+    OE_CHECK(all.faceSetBytes > 0);
+
+    // sorted by faces, ties in traversal order
+    vector<SceneStatisticsVisitor::SubtreeStatistics> byFaces =
+        stats.GetStatistics(SceneStatisticsVisitor::SORT_BY_FACES);
+    OE_REQUIRE(byFaces.size() == 4);
+    OE_CHECK(byFaces[0].node == root);
+    OE_CHECK(byFaces[1].node == large);
+    OE_CHECK(byFaces[1].materials == 2);
+    OE_CHECK(byFaces[2].node == trans);
+    OE_CHECK(byFaces[3].node == small);
+
+    // the transformation subtree holds the small geometry node
+    vector<SceneStatisticsVisitor::SubtreeStatistics> byOrder =
+        stats.GetStatistics(SceneStatisticsVisitor::SORT_BY_TRAVERSAL);
+    OE_CHECK(byOrder[1].node == trans);
+    OE_CHECK(byOrder[1].depth == 1);
+    OE_CHECK(byOrder[1].nodes == 2);
+    OE_CHECK(byOrder[1].faces == 2);
+    OE_CHECK(byOrder[1].materials == 1);
+    OE_CHECK(byOrder[2].node == small);
+    OE_CHECK(byOrder[2].depth == 2);
+
+    // JSON holds one object per subtree with escaped names
+    std::ostringstream json;
+    stats.WriteJSON(&json, SceneStatisticsVisitor::SORT_BY_TRAVERSAL);
+    std::string s = json.str();
+    OE_CHECK(s[0] == '[');
+    OE_CHECK(s.substr(s.size() - 2) == "]\n");
+    OE_CHECK(Count(s, "{\"name\": ") == 4);
+    OE_CHECK(Count(s, "\"nodes\": 4,") == 1);
+    OE_CHECK(Count(s, "\"faces\": 5,") == 1);
+    OE_CHECK(Count(s, "\"types\": {\"GeometryNode\": 2, \"SceneNode\": 1, "
+                   "\"TransformationNode\": 1}") == 1);
+    // names are escaped, so only the objects are on lines of their own
+    OE_CHECK(Count(s, "\n") == 6);
+    OE_CHECK(Count(s, "{") == Count(s, "}"));
+
+    // collecting again starts over
+    stats.Collect(*trans);
+    OE_CHECK(stats.GetStatistics().size() == 2);
+    OE_CHECK(stats.GetRootStatistics().nodes == 2);
+
+    delete root;
+    return 0;
+}
@@ -0,0 +1,154 @@
+#include <Testing/Testing.h>
+
+#include <Scene/ISceneNodeVisitor.h>
+#include <Scene/SceneNode.h>
+#include <Scene/TransformationNode.h>
+#include <Utils/Serialization.h>
+
+#include <sstream>
+#include <algorithm>
+
+using namespace OpenEngine::Scene;
+using OpenEngine::Utils::Serialization;
+
+// removes the given node when visiting its parent's sub nodes
+class Remover : public ISceneNodeVisitor {
+public:
+    ISceneNode* target;
+    unsigned int visited;
+    Remover(ISceneNode* target) : target(target), visited(0) {}
+    void VisitTransformationNode(TransformationNode* node) {
+        visited++;
+        if (node != target)
+            node->GetParent()->RemoveNode(target);
+    }
+};
+
+// a parent with n transformation node children
+static ISceneNode* Build(unsigned int n, std::vector<ISceneNode*>& nodes) {
+    ISceneNode* root = new SceneNode();
+    nodes.clear();
+    for (unsigned int i=0; i<n; i++) {
+        nodes.push_back(new TransformationNode());
+        root->AddNode(nodes.back());
+    }
+    return root;
+}
+
+// true if the parent holds exactly the given nodes, in any order
+static bool Holds(ISceneNode* root, std::vector<ISceneNode*> nodes) {
+    if (root->subNodes.size() != nodes.size()) return false;
+    for (unsigned int i=0; i<root->subNodes.size(); i++) {
+        ISceneNode* sub = root->subNodes[i];
+        if (sub->GetParent() != root) return false;
+        std::vector<ISceneNode*>::iterator itr =
+            std::find(nodes.begin(), nodes.end(), sub);
+        if (itr == nodes.end()) return false;
+        nodes.erase(itr);
+    }
+    return true;
+}
+
+// removes the nodes one by one, which follows the cached indices
+static bool RemoveEach(ISceneNode* root, std::vector<ISceneNode*> nodes) {
+    while (!nodes.empty()) {
+        ISceneNode* sub = nodes.back();
+        nodes.pop_back();
+        root->RemoveNode(sub);
+        if (sub->GetParent() != NULL || !Holds(root, nodes)) return false;
+        delete sub;
+    }
+    return true;
+}
+
+int test_main(int argc, char* argv[]) {
+    std::vector<ISceneNode*> nodes;
+
+    // removing the first, a middle and the last node
+    for (unsigned int i=0; i<5; i++) {
+        ISceneNode* root = Build(5, nodes);
+        ISceneNode* sub = nodes[i];
+        root->RemoveNode(sub);
+        nodes.erase(nodes.begin() + i);
+        OE_CHECK(sub->GetParent() == NULL);
+        OE_CHECK(Holds(root, nodes));
+        // the last node moved into the freed slot
+        if (i < 4) OE_CHECK(root->subNodes[i] == nodes.back());
+        OE_CHECK(RemoveEach(root, nodes));
+        delete sub;
+        delete root;
+    }
+
+    // deleting a node
+    {
+        ISceneNode* root = Build(3, nodes);
+        root->DeleteNode(nodes[0]);
+        nodes.erase(nodes.begin());
+        OE_CHECK(Holds(root, nodes));
+        OE_CHECK(RemoveEach(root, nodes));
+        delete root;
+    }
+
+    // removal during traversal waits until the parent is done
+    {
+        ISceneNode* root = Build(4, nodes);
+        ISceneNode* target = nodes[1];
+        Remover r(target);
+        root->Accept(r);
+        OE_CHECK(r.visited == 4);
+        OE_CHECK(target->GetParent() == NULL);
+        nodes.erase(nodes.begin() + 1);
+        OE_CHECK(Holds(root, nodes));
+        OE_CHECK(RemoveEach(root, nodes));
+        delete target;
+        delete root;
+    }
+
+    // replacing keeps the position
+    {
+        ISceneNode* root = Build(3, nodes);
+        ISceneNode* node = new SceneNode();
+        root->ReplaceNode(nodes[1], node);
+        OE_CHECK(root->subNodes[1] == node);
+        nodes[1] = node;
+        OE_CHECK(Holds(root, nodes));
+        OE_CHECK(RemoveEach(root, nodes));
+        delete root;
+    }
+
+    // removing all nodes leaves them free to be added again
+    {
+        ISceneNode* root = Build(3, nodes);
+        root->RemoveAllNodes();
+        OE_CHECK(root->GetNumberOfNodes() == 0);
+        for (unsigned int i=0; i<nodes.size(); i++) {
+            OE_CHECK(nodes[i]->GetParent() == NULL);
+            root->AddNode(nodes[i]);
+        }
+        OE_CHECK(Holds(root, nodes));
+        OE_CHECK(RemoveEach(root, nodes));
+        delete root;
+    }
+
+    // loaded nodes know their parent and position
+    {
+        ISceneNode* root = Build(4, nodes);
+        std::stringstream stream;
+        Serialization::Serialize(root, &stream);
+        delete root;
+        ISceneNode* loaded = NULL;
+        Serialization::Deserialize(loaded, &stream);
+        OE_REQUIRE(loaded != NULL);
+        nodes = loaded->subNodes;
+        OE_CHECK(nodes.size() == 4);
+        OE_CHECK(Holds(loaded, nodes));
+        loaded->RemoveNode(nodes[0]);
+        OE_CHECK(loaded->subNodes[0] == nodes[3]);
+        delete nodes[0];
+        nodes.erase(nodes.begin());
+        OE_CHECK(RemoveEach(loaded, nodes));
+        delete loaded;
+    }
+
+    return 0;
+}
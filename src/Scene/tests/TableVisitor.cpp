@@ -0,0 +1,138 @@
+#include <Testing/Testing.h>
+
+#include <Scene/TableVisitor.h>
+#include <Scene/ISceneNodeVisitor.h>
+#include <Scene/SceneNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/RenderStateNode.h>
+
+using namespace OpenEngine::Scene;
+
+// counts transformation nodes through the visitor methods
+class VirtualCounter : public ISceneNodeVisitor {
+public:
+    unsigned int count;
+    VirtualCounter() : count(0) {}
+    void VisitTransformationNode(TransformationNode* node) {
+        count++;
+        node->VisitSubNodes(*this);
+    }
+};
+
+// counts transformation nodes through the table
+class TableCounter : public TableVisitor {
+public:
+    unsigned int count;
+    TableCounter() : count(0) {
+        Bind<TableCounter, TransformationNode,
+             &TableCounter::VisitTransformationNode>();
+    }
+    void VisitTransformationNode(TransformationNode* node) {
+        count++;
+        VisitSubNodes(node);
+    }
+};
+
+// deletes the render state nodes it meets
+class Pruner : public TableVisitor {
+public:
+    unsigned int visited;
+    Pruner() : visited(0) {
+        Bind<Pruner, SceneNode, &Pruner::VisitSceneNode>();
+        Bind<Pruner, RenderStateNode, &Pruner::VisitRenderStateNode>();
+    }
+    void VisitSceneNode(SceneNode* node) {
+        visited++;
+        VisitSubNodes(node);
+    }
+    void VisitRenderStateNode(RenderStateNode* node) {
+        visited++;
+        node->GetParent()->DeleteNode(node);
+    }
+};
+
+// sub class outside SceneNodes.def
+class Derived : public SceneNode {};
+
+// sub class only visiting its first sub node
+class FirstOnly : public SceneNode {
+public:
+    void VisitSubNodes(ISceneNodeVisitor& visitor) {
+        if (!subNodes.empty()) subNodes[0]->Accept(visitor);
+    }
+};
+
+// a tree of the given depth and fan out, cycling through node types
+static ISceneNode* Build(unsigned int depth, unsigned int fan, unsigned int& n) {
+    ISceneNode* node;
+    switch (n++ % 3) {
+    case 0:  node = new SceneNode(); break;
+    case 1:  node = new TransformationNode(); break;
+    default: node = new RenderStateNode(); break;
+    }
+    if (depth > 0)
+        for (unsigned int i=0; i<fan; i++)
+            node->AddNode(Build(depth - 1, fan, n));
+    return node;
+}
+
+int test_main(int argc, char* argv[]) {
+
+    // both mechanisms find the same nodes
+    {
+        unsigned int n = 0;
+        ISceneNode* root = Build(4, 5, n);
+        VirtualCounter v;
+        root->Accept(v);
+        TableCounter t;
+        t.Visit(root);
+        OE_CHECK(v.count > 0);
+        OE_CHECK(t.count == v.count);
+        delete root;
+    }
+
+    // tags follow the node types
+    {
+        SceneNode sn;
+        Derived d;
+        TransformationNode tn;
+        OE_CHECK(sn.GetNodeTag() == SceneNodeTag);
+        OE_CHECK(d.GetNodeTag() == SceneNodeTag);
+        OE_CHECK(tn.GetNodeTag() == TransformationNodeTag);
+        OE_CHECK((int)TransformationNode::TAG == TransformationNodeTag);
+    }
+
+    // overwritten sub node traversal is kept
+    {
+        ISceneNode* root = new SceneNode();
+        ISceneNode* first = new FirstOnly();
+        root->AddNode(first);
+        ISceneNode* visited = new TransformationNode();
+        first->AddNode(visited);
+        first->AddNode(new TransformationNode());
+        visited->AddNode(new TransformationNode());
+        VirtualCounter v;
+        root->Accept(v);
+        TableCounter t;
+        t.Visit(root);
+        OE_CHECK(v.count == 2);
+        OE_CHECK(t.count == v.count);
+        delete root;
+    }
+
+    // deletion during traversal is delayed until the parent is done
+    {
+        ISceneNode* root = new SceneNode();
+        root->AddNode(new RenderStateNode());
+        root->AddNode(new Derived());
+        root->AddNode(new RenderStateNode());
+        root->AddNode(new SceneNode());
+        Pruner p;
+        p.Visit(root);
+        OE_CHECK(p.visited == 5);
+        OE_CHECK(root->GetNumberOfNodes() == 2);
+        delete root;
+    }
+
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <Scene/TableVisitor.h>
+#include <Scene/ISceneNodeVisitor.h>
+#include <Scene/SceneNode.h>
+#include <Scene/TransformationNode.h>
+#include <Scene/RenderStateNode.h>
+
+#include <cstdio>
+#include <ctime>
+
+using namespace OpenEngine::Scene;
+
+// counts transformation nodes through the visitor methods
+class VirtualCounter : public ISceneNodeVisitor {
+public:
+    unsigned int count;
+    VirtualCounter() : count(0) {}
+    void VisitTransformationNode(TransformationNode* node) {
+        count++;
+        node->VisitSubNodes(*this);
+    }
+};
+
+// counts transformation nodes through the table
+class TableCounter : public TableVisitor {
+public:
+    unsigned int count;
+    TableCounter() : count(0) {
+        Bind<TableCounter, TransformationNode,
+             &TableCounter::VisitTransformationNode>();
+    }
+    void VisitTransformationNode(TransformationNode* node) {
+        count++;
+        VisitSubNodes(node);
+    }
+};
+
+// a tree of the given depth and fan out, cycling through node types
+static ISceneNode* Build(unsigned int depth, unsigned int fan, unsigned int& n) {
+    ISceneNode* node;
+    switch (n++ % 3) {
+    case 0:  node = new SceneNode(); break;
+    case 1:  node = new TransformationNode(); break;
+    default: node = new RenderStateNode(); break;
+    }
+    if (depth > 0)
+        for (unsigned int i=0; i<fan; i++)
+            node->AddNode(Build(depth - 1, fan, n));
+    return node;
+}
+
+// time both mechanisms on a tree of the given depth with fan out 10
+static void Run(unsigned int depth, int runs) {
+    unsigned int n = 0;
+    ISceneNode* root = Build(depth, 10, n);
+    VirtualCounter v;
+    TableCounter t;
+    // warm up
+    root->Accept(v);
+    t.Visit(root);
+    clock_t start = clock();
+    for (int i=0; i<runs; i++) root->Accept(v);
+    clock_t middle = clock();
+    for (int i=0; i<runs; i++) t.Visit(root);
+    clock_t end = clock();
+    printf("visitor dispatch, %u nodes: virtual %.1f ns, table %.1f ns per node\n",
+           n,
+           (middle - start) * 1e9 / CLOCKS_PER_SEC / runs / n,
+           (end - middle) * 1e9 / CLOCKS_PER_SEC / runs / n);
+    delete root;
+}
+
+// Benchmark of visiting a graph that fits in the cache and one of
+// about a million nodes through the visitor methods and through the
+// handler table.
+int main(int argc, char* argv[]) {
+    Run(3, 10000);
+    Run(6, 10);
+    return 0;
+}
@@ -0,0 +1,47 @@
+// Clock interface.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS) 
+// 
+// This program is free software; It is covered by the GNU General 
+// Public License version 2 or any later version. 
+// See the GNU General Public License for more details (see LICENSE). 
+//--------------------------------------------------------------------
+
+#ifndef _OE_CLOCK_INTERFACE_H_
+#define _OE_CLOCK_INTERFACE_H_
+
+#include <Utils/Timer.h>
+
+namespace OpenEngine {
+namespace Utils {
+
+/**
+ * Clock interface.
+ * A source of the current time. The clock used by \a Timer::GetTime,
+ * and thereby by every timer in the engine, can be replaced with
+ * \a Timer::SetClock, fx. with a \a VirtualClock to run the engine
+ * on simulated time.
+ *
+ * @class IClock IClock.h Utils/IClock.h
+ */
+class IClock {
+public:
+
+    /**
+     * Clock destructor.
+     */
+    virtual ~IClock() {}
+
+    /**
+     * Get the current time of the clock.
+     *
+     * @return Current time.
+     */
+    virtual Time GetTime() = 0;
+
+};
+
+} // NS Utils
+} // NS OpenEngine
+
+#endif // _OE_CLOCK_INTERFACE_H_
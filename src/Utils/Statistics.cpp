@@ -25,7 +25,7 @@ void Statistics::Handle(ProcessEventArg arg) {
     frames += 1;
     unsigned int elapsed = timer.GetElapsedTime().AsInt();
     if (elapsed > interval) {
-        logger.info << "FPS: " << (double)frames * 1000000 / (double)elapsed << logger.end;
+        OE_LOG_INFO << "FPS: " << (double)frames * 1000000 / (double)elapsed << logger.end;
         frames = 0;
         timer.Reset();
     }
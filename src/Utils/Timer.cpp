@@ -8,6 +8,7 @@
 //--------------------------------------------------------------------
 
 #include <Utils/Timer.h>
+#include <Utils/IClock.h>
 
 #include <Meta/Time.h>
 #include <Core/Exceptions.h>
@@ -29,6 +30,8 @@ using OpenEngine::Utils::Convert;
 
 static const unsigned int second = 1000000;
 
+IClock* Timer::clock = NULL;
+
 Time::Time() : sec(0), usec(0) {}
 Time::Time(const uint32_t usec) : sec(usec / second), usec(usec % second) {}
 Time::Time(const uint64_t sec, const uint32_t usec) : sec(sec), usec(usec) {}
@@ -282,6 +285,39 @@ bool Timer::IsRunning() const {
     return stop.IsZero();
 }
 
+/**
+ * Get the current time.
+ * This is the time of the clock set with \a SetClock, or the system
+ * time if no clock is set. All timers use this time.
+ *
+ * @return Current time.
+ */
+Time Timer::GetTime() {
+    if (clock != NULL) return clock->GetTime();
+    return GetSystemTime();
+}
+
+/**
+ * Set the clock used by \a GetTime.
+ * Should be set while no timers are running, as a running timer
+ * measures from a time of the previous clock.
+ *
+ * @param clock Clock to use, or NULL for the system clock. The clock
+ * is not owned by the timer.
+ */
+void Timer::SetClock(IClock* clock) {
+    Timer::clock = clock;
+}
+
+/**
+ * Get the clock used by \a GetTime.
+ *
+ * @return The clock or NULL if the system clock is used.
+ */
+IClock* Timer::GetClock() {
+    return clock;
+}
+
 /**
  * Get the system time.
  * The definition of what the "current time" is depends on the running
@@ -298,7 +334,7 @@ bool Timer::IsRunning() const {
  *
  * @return Current time.
  */
-Time Timer::GetTime() {
+Time Timer::GetSystemTime() {
 #if defined(_WIN32)
     #if defined(_MSC_VER) || defined(_MSC_EXTENSIONS)
         #define DELTA_EPOCH_IN_MICROSECS  11644473600000000Ui64
@@ -16,6 +16,9 @@
 namespace OpenEngine {
 namespace Utils {
 
+// forward declarations
+class IClock;
+
 /**
  * Time data type.
  * Provides an interface to a time structure similar to that obtained
@@ -67,6 +70,8 @@ class Timer {
 private:
     //! start and stop time stamps.
     Time start, stop;
+    //! clock used by GetTime, NULL for the system clock.
+    static IClock* clock;
 
 public:
 
@@ -85,6 +90,9 @@ public:
     bool IsRunning() const;
 
     static Time GetTime();
+    static Time GetSystemTime();
+    static void SetClock(IClock* clock);
+    static IClock* GetClock();
 
 };
 
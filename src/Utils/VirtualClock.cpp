@@ -0,0 +1,70 @@
+// Virtual clock.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS) 
+// 
+// This program is free software; It is covered by the GNU General 
+// Public License version 2 or any later version. 
+// See the GNU General Public License for more details (see LICENSE). 
+//--------------------------------------------------------------------
+
+#include <Utils/VirtualClock.h>
+
+namespace OpenEngine {
+namespace Utils {
+
+/**
+ * Create a virtual clock.
+ *
+ * @param start Initial time of the clock.
+ * @param step Time added by each call to \a Advance().
+ */
+VirtualClock::VirtualClock(Time start, Time step)
+    : now(start), step(step) {}
+
+VirtualClock::~VirtualClock() {}
+
+/**
+ * Get the current virtual time.
+ *
+ * @return Current time.
+ */
+Time VirtualClock::GetTime() {
+    return now;
+}
+
+/**
+ * Advance the clock by one step.
+ */
+void VirtualClock::Advance() {
+    now += step;
+}
+
+/**
+ * Advance the clock by a given time.
+ *
+ * @param time Time to add.
+ */
+void VirtualClock::Advance(Time time) {
+    now += time;
+}
+
+/**
+ * Set the step used by \a Advance().
+ *
+ * @param step Time added by each step.
+ */
+void VirtualClock::SetStep(Time step) {
+    this->step = step;
+}
+
+/**
+ * Get the step used by \a Advance().
+ *
+ * @return Time added by each step.
+ */
+Time VirtualClock::GetStep() const {
+    return step;
+}
+
+} // NS Utils
+} // NS OpenEngine
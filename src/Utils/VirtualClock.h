@@ -0,0 +1,55 @@
+// Virtual clock.
+// -------------------------------------------------------------------
+// Copyright (C) 2007 OpenEngine.dk (See AUTHORS) 
+// 
+// This program is free software; It is covered by the GNU General 
+// Public License version 2 or any later version. 
+// See the GNU General Public License for more details (see LICENSE). 
+//--------------------------------------------------------------------
+
+#ifndef _OE_VIRTUAL_CLOCK_H_
+#define _OE_VIRTUAL_CLOCK_H_
+
+#include <Utils/IClock.h>
+
+namespace OpenEngine {
+namespace Utils {
+
+/**
+ * Virtual clock.
+ * A clock that only moves when it is advanced, by a fixed step per
+ * call to \a Advance(). Used as the engine clock it gives every frame
+ * the same length no matter how long the frame really took, so
+ * simulations and benchmark runs get deterministic timing and run as
+ * fast as the machine allows.
+ *
+ * @code
+ * VirtualClock clock(Timer::GetSystemTime(), Time(16666)); // 60 Hz
+ * Timer::SetClock(&clock);
+ * ...
+ * clock.Advance(); // once per frame
+ * @endcode
+ *
+ * @see Engine::SetFixedFrameTime
+ * @class VirtualClock VirtualClock.h Utils/VirtualClock.h
+ */
+class VirtualClock : public IClock {
+private:
+    Time now;
+    Time step;
+
+public:
+    VirtualClock(Time start, Time step);
+    virtual ~VirtualClock();
+
+    Time GetTime();
+    void Advance();
+    void Advance(Time time);
+    void SetStep(Time step);
+    Time GetStep() const;
+};
+
+} // NS Utils
+} // NS OpenEngine
+
+#endif // _OE_VIRTUAL_CLOCK_H_